@@ -310,6 +310,23 @@ index_opts_decode_distance(const char *str)
 	return RTREE_INDEX_DISTANCE_TYPE_EUCLID; /* unreachabe */
 }
 
+/**
+ * Decode vinyl compaction policy from message pached string to enum
+ * Throws an error if the the value does not correspond to any enum value
+ */
+static enum index_compaction_policy
+index_opts_decode_compaction(const char *str)
+{
+	for (int i = 0; i < index_compaction_policy_MAX; i++) {
+		if (strcasecmp(str, index_compaction_policy_strs[i]) == 0)
+			return (enum index_compaction_policy) i;
+	}
+	tnt_raise(ClientError, ER_WRONG_INDEX_OPTIONS,
+		  BOX_INDEX_FIELD_OPTS,
+		  "compaction must be either 'tiered' or 'leveled'");
+	return INDEX_COMPACTION_TIERED; /* unreachable */
+}
+
 /**
  * Support function for index_def_new_from_tuple(..)
  * 1.6.6+
@@ -327,6 +344,9 @@ index_opts_create(struct index_opts *opts, const char *map)
 				     BOX_INDEX_FIELD_OPTS);
 	if (opts->distancebuf[0] != '\0')
 		opts->distance = index_opts_decode_distance(opts->distancebuf);
+	if (opts->compactionbuf[0] != '\0')
+		opts->compaction =
+			index_opts_decode_compaction(opts->compactionbuf);
 	if (opts->run_count_per_level <= 0)
 		tnt_raise(ClientError, ER_WRONG_INDEX_OPTIONS,
 			  BOX_INDEX_FIELD_OPTS,
@@ -642,6 +662,8 @@ alter_space_rollback(struct trigger *trigger, void * /* event */)
 		   &alter->old_space->on_replace);
 	rlist_swap(&alter->new_space->on_stmt_begin,
 		   &alter->old_space->on_stmt_begin);
+	latency_stat_swap(&alter->new_space->latency_stat,
+			  &alter->old_space->latency_stat);
 	struct space *new_space = space_cache_replace(alter->old_space);
 	assert(new_space == alter->new_space);
 	(void) new_space;
@@ -741,6 +763,8 @@ alter_space_do(struct txn *txn, struct alter_space *alter)
 		   &alter->old_space->on_replace);
 	rlist_swap(&alter->new_space->on_stmt_begin,
 		   &alter->old_space->on_stmt_begin);
+	latency_stat_swap(&alter->new_space->latency_stat,
+			  &alter->old_space->latency_stat);
 	/*
 	 * Init space bsize.
 	 */
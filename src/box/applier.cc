@@ -46,10 +46,29 @@
 #include "trigger.h"
 #include "xrow_io.h"
 #include "error.h"
+#include "txn.h"
+#include "space.h"
+#include "schema.h"
+#include "index.h"
+#include "tuple.h"
+#include "tuple_hash.h"
+#include "clock.h"
 
 /* TODO: add configuration options */
 static const int RECONNECT_DELAY = 1;
 
+/**
+ * Max number of rows received from the master, but not
+ * applied yet. The reader stops reading when it is reached.
+ */
+static const int APPLIER_QUEUE_MAX = 1024;
+
+int applier_fiber_count = 1;
+
+bool applier_compression = false;
+
+int applier_join_connections = 1;
+
 STRS(applier_state, applier_STATE);
 
 static inline void
@@ -96,6 +115,85 @@ applier_log_error(struct applier *applier, struct error *e)
 	applier->last_logged_errcode = errcode;
 }
 
+static void
+applier_close_tx_cursor(struct applier *applier)
+{
+	if (applier->tx_cursor_is_open) {
+		xlog_tx_cursor_destroy(&applier->tx_cursor);
+		applier->tx_cursor_is_open = false;
+	}
+}
+
+/**
+ * Read an xlog tx block sent by the master and open
+ * applier::tx_cursor to iterate over its rows.
+ */
+static void
+applier_read_tx(struct applier *applier)
+{
+	struct ev_io *coio = &applier->io;
+	struct ibuf *in = &applier->iobuf->in;
+	assert(!applier->tx_cursor_is_open);
+	if (applier->zdctx == NULL) {
+		applier->zdctx = ZSTD_createDStream();
+		if (applier->zdctx == NULL) {
+			tnt_raise(ClientError, ER_DECOMPRESSION,
+				  "failed to create context");
+		}
+	}
+	const char *data = in->rpos;
+	double start = clock_thread();
+	ssize_t to_read;
+	while ((to_read = xlog_tx_cursor_create(&applier->tx_cursor, &data,
+						in->wpos, applier->zdctx)) > 0) {
+		coio_breadn(coio, in, to_read);
+		/* The buffer may have been reallocated. */
+		data = in->rpos;
+		start = clock_thread();
+	}
+	if (to_read < 0)
+		diag_raise();
+	applier->tx_cursor_is_open = true;
+	applier->decompress_time += clock_thread() - start;
+	applier->tx_bytes += data - in->rpos;
+	applier->tx_raw_bytes += ibuf_used(&applier->tx_cursor.rows);
+	in->rpos = (char *) data;
+}
+
+/**
+ * Read the next row sent by the master. If the replica has
+ * asked to compress the stream, the master may send rows
+ * packed in xlog tx blocks rather than in iproto packets.
+ * A block is told apart by the fixheader magic and unpacked
+ * as a whole, then its rows are returned one by one. Row
+ * bodies point either to the input buffer or to the block,
+ * so they are valid until the next row is read.
+ */
+static void
+applier_read_xrow(struct applier *applier, struct xrow_header *row)
+{
+	struct ev_io *coio = &applier->io;
+	struct ibuf *in = &applier->iobuf->in;
+	while (true) {
+		if (applier->tx_cursor_is_open) {
+			int rc = xlog_tx_cursor_next_row(&applier->tx_cursor,
+							 row);
+			if (rc < 0)
+				diag_raise();
+			if (rc == 0)
+				return;
+			applier_close_tx_cursor(applier);
+		}
+		if (ibuf_used(in) < 1)
+			coio_breadn(coio, in, 1);
+		if (!xlog_tx_is_fixheader(*in->rpos)) {
+			coio_read_xrow(coio, in, row);
+			return;
+		}
+		applier_read_tx(applier);
+	}
+}
+
 /**
  * Connect to a remote host and authenticate the client.
  */
@@ -189,17 +287,54 @@ done:
 	applier_set_state(applier, APPLIER_READY);
 }
 
+static void
+applier_start_join_helpers(struct applier *applier);
+
 /**
- * Execute and process JOIN request (bootstrap the instance).
+ * Apply a row of the initial data. Once the applier receiving
+ * part 0 has got past system spaces, i.e. the replica has the
+ * schema, start helpers to receive the other parts.
  */
 static void
-applier_join(struct applier *applier)
+applier_apply_initial_row(struct applier *applier, struct xrow_header *row)
+{
+	if (applier->join_part.count > 1 && applier->join_part.id == 0 &&
+	    applier->join_helpers == NULL) {
+		struct request request;
+		xrow_decode_dml_xc(row, &request, 0);
+		if (!space_id_is_system(request.space_id))
+			applier_start_join_helpers(applier);
+	}
+	xstream_write_xc(applier->join_stream, row);
+	applier->join_rows++;
+}
+
+/**
+ * Send JOIN for applier::join_part and receive the initial
+ * data, until the end of initial stage marker.
+ */
+static void
+applier_join_initial(struct applier *applier)
 {
 	/* Send JOIN request */
 	struct ev_io *coio = &applier->io;
 	struct iobuf *iobuf = applier->iobuf;
+	struct join_part *part = &applier->join_part;
 	struct xrow_header row;
-	xrow_encode_join_xc(&row, &INSTANCE_UUID);
+	if (applier->join_is_resumable) {
+		/* Skip rows received before reconnect. */
+		part->skip = applier->join_rows;
+		xrow_encode_join_xc(&row, &INSTANCE_UUID,
+				    &applier->join_vclock, part,
+				    applier_compression);
+	} else {
+		assert(applier->join_leader == NULL);
+		part->id = 0;
+		part->count = applier_join_connections;
+		part->skip = 0;
+		xrow_encode_join_xc(&row, &INSTANCE_UUID, NULL, part,
+				    applier_compression);
+	}
 	coio_write_xrow(coio, &row);
 
 	/**
@@ -216,13 +351,40 @@ applier_join(struct applier *applier)
 				  (uint32_t) row.type);
 		}
 		/*
-		 * Start vclock. The vclock of the checkpoint
-		 * the master is sending to the replica.
-		 * Used to initialize the replica's initial
-		 * vclock in bootstrap_from_master()
+		 * A master that can split and resume initial
+		 * data echoes the requested part.
 		 */
-		xrow_decode_vclock(&row, &replicaset_vclock);
+		struct join_part echo;
+		memset(&echo, 0, sizeof(echo));
+		if (applier->join_is_resumable) {
+			struct vclock vclock;
+			vclock_create(&vclock);
+			xrow_decode_join_response(&row, &vclock, &echo);
+			if (echo.id != part->id || echo.count != part->count ||
+			    echo.skip != part->skip) {
+				tnt_raise(ClientError, ER_UNSUPPORTED,
+					  "Master", "resuming initial join");
+			}
+		} else {
+			/*
+			 * Start vclock. The vclock of the checkpoint
+			 * the master is sending to the replica.
+			 * Used to initialize the replica's initial
+			 * vclock in bootstrap_from_master()
+			 */
+			xrow_decode_join_response(&row, &replicaset_vclock,
+						  &echo);
+			if (echo.count == part->count) {
+				vclock_copy(&applier->join_vclock,
+					    &replicaset_vclock);
+				applier->join_rows = 0;
+				applier->join_is_resumable = true;
+			}
+		}
 	}
+	/* The master sends all initial data over one connection. */
+	if (!applier->join_is_resumable)
+		part->count = 1;
 
 	applier_set_state(applier, APPLIER_INITIAL_JOIN);
 
@@ -231,10 +393,10 @@ applier_join(struct applier *applier)
 	 */
 	assert(applier->join_stream != NULL);
 	while (true) {
-		coio_read_xrow(coio, &iobuf->in, &row);
+		applier_read_xrow(applier, &row);
 		applier->last_row_time = ev_now(loop());
 		if (iproto_type_is_dml(row.type)) {
-			xstream_write_xc(applier->join_stream, &row);
+			applier_apply_initial_row(applier, &row);
 		} else if (row.type == IPROTO_OK) {
 			if (applier->version_id < version_id(1, 7, 0)) {
 				/*
@@ -254,6 +416,145 @@ applier_join(struct applier *applier)
 				  (uint32_t) row.type);
 		}
 	}
+}
+
+/**
+ * Receive a part of the initial data over a separate
+ * connection, reconnecting on network errors.
+ */
+static int
+applier_join_helper_f(va_list ap)
+{
+	struct applier *applier = va_arg(ap, struct applier *);
+	auto guard = make_scoped_guard([=]{
+		fiber_cond_signal(&applier->join_leader->join_cond);
+	});
+
+	/* Re-connect loop */
+	while (!fiber_is_cancelled()) {
+		try {
+			applier_connect(applier);
+			applier_join_initial(applier);
+			applier_disconnect(applier, APPLIER_OFF);
+			return 0;
+		} catch (FiberIsCancelled *e) {
+			applier_disconnect(applier, APPLIER_OFF);
+			throw;
+		} catch (SocketError *e) {
+			applier_log_error(applier, e);
+			goto reconnect;
+		} catch (Exception *e) {
+			applier_log_error(applier, e);
+			applier_disconnect(applier, APPLIER_STOPPED);
+			throw;
+		}
+		/* See applier_f(). */
+reconnect:
+		applier_disconnect(applier, APPLIER_DISCONNECTED);
+		fiber_sleep(RECONNECT_DELAY);
+	}
+	return 0;
+}
+
+/** Start helpers to receive parts 1 .. count - 1. */
+static void
+applier_start_join_helpers(struct applier *applier)
+{
+	assert(applier->join_helpers == NULL);
+	int count = applier->join_part.count - 1;
+	applier->join_helpers = (struct applier **)
+		calloc(count, sizeof(struct applier *));
+	if (applier->join_helpers == NULL) {
+		tnt_raise(OutOfMemory, count * sizeof(struct applier *),
+			  "malloc", "struct applier");
+	}
+	for (int i = 0; i < count; i++) {
+		struct applier *helper = applier_new(applier->source,
+						     applier->join_stream,
+						     NULL);
+		if (helper == NULL)
+			diag_raise();
+		applier->join_helpers[applier->join_helper_count++] = helper;
+		/* Make sure the helper talks to the same master. */
+		helper->uuid = applier->uuid;
+		helper->join_leader = applier;
+		helper->join_part.id = i + 1;
+		helper->join_part.count = applier->join_part.count;
+		vclock_copy(&helper->join_vclock, &applier->join_vclock);
+		helper->join_is_resumable = true;
+
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "applier/join/%d", i + 1);
+		struct fiber *f = fiber_new_xc(name, applier_join_helper_f);
+		fiber_set_joinable(f, true);
+		helper->reader = f;
+		fiber_start(f, helper);
+	}
+	say_info("receiving initial data over %d connections", count + 1);
+}
+
+/**
+ * Stop and delete helpers. Returns -1 and sets diag if any
+ * of them failed to receive its part.
+ */
+static int
+applier_stop_join_helpers(struct applier *applier)
+{
+	int rc = 0;
+	for (int i = 0; i < applier->join_helper_count; i++) {
+		struct applier *helper = applier->join_helpers[i];
+		if (helper->reader != NULL) {
+			fiber_cancel(helper->reader);
+			if (fiber_join(helper->reader) != 0)
+				rc = -1;
+			helper->reader = NULL;
+		}
+		applier_delete(helper);
+	}
+	free(applier->join_helpers);
+	applier->join_helpers = NULL;
+	applier->join_helper_count = 0;
+	return rc;
+}
+
+/** Wait until all helpers have received their parts. */
+static void
+applier_wait_join_helpers(struct applier *applier)
+{
+	for (int i = 0; i < applier->join_helper_count; i++) {
+		struct applier *helper = applier->join_helpers[i];
+		while (helper->reader != NULL &&
+		       !fiber_is_dead(helper->reader)) {
+			fiber_cond_wait(&applier->join_cond);
+			fiber_testcancel();
+		}
+	}
+	if (applier_stop_join_helpers(applier) != 0)
+		diag_raise();
+}
+
+/**
+ * Execute and process JOIN request (bootstrap the instance).
+ *
+ * If the master supports it, initial data is split into
+ * box.cfg.replication_join_connections parts received over
+ * separate connections and applied concurrently, and it is
+ * resumed from where it stopped if a connection fails. The
+ * final data is always received over this applier.
+ */
+static void
+applier_join(struct applier *applier)
+{
+	struct xrow_header row;
+	applier_join_initial(applier);
+	/*
+	 * The master may have no rows of other spaces than
+	 * system ones for this applier.
+	 */
+	if (applier->join_part.count > 1 && applier->join_helpers == NULL)
+		applier_start_join_helpers(applier);
+	applier_wait_join_helpers(applier);
+	applier->join_is_resumable = false;
 	say_info("initial data received");
 
 	applier_set_state(applier, APPLIER_FINAL_JOIN);
@@ -268,7 +569,7 @@ applier_join(struct applier *applier)
 	 * Receive final data.
 	 */
 	while (true) {
-		coio_read_xrow(coio, &iobuf->in, &row);
+		applier_read_xrow(applier, &row);
 		applier->last_row_time = ev_now(loop());
 		if (iproto_type_is_dml(row.type)) {
 			vclock_follow(&replicaset_vclock, row.replica_id,
@@ -294,6 +595,367 @@ finish:
 	applier_set_state(applier, APPLIER_READY);
 }
 
+/** A row received from the master in SUBSCRIBE mode. */
+struct applier_row {
+	/** Link in applier::apply_queue. */
+	struct stailq_entry in_queue;
+	/** Link in applier::apply_inflight. */
+	struct rlist in_inflight;
+	/** Sequence number of the row in the stream. */
+	int64_t seq;
+	/** Space modified by the row. */
+	uint32_t space_id;
+	/** Hash of the primary key modified by the row. */
+	uint32_t key_hash;
+	/** Set if the key is unknown, conflicts with any key. */
+	bool is_space_wide;
+	/** Set if the row conflicts with any row, e.g. DDL. */
+	bool is_barrier;
+	/** The row, its body is stored in @data. */
+	struct xrow_header row;
+	char data[0];
+};
+
+/**
+ * Copy a row read from the network to a newly allocated
+ * applier_row, so that the input buffer can be reused.
+ */
+static struct applier_row *
+applier_row_new(const struct xrow_header *row)
+{
+	size_t body_size = 0;
+	for (int i = 0; i < row->bodycnt; i++)
+		body_size += row->body[i].iov_len;
+	size_t size = sizeof(struct applier_row) + body_size;
+	struct applier_row *r = (struct applier_row *) malloc(size);
+	if (r == NULL)
+		tnt_raise(OutOfMemory, size, "malloc", "struct applier_row");
+	r->row = *row;
+	char *data = r->data;
+	for (int i = 0; i < row->bodycnt; i++) {
+		memcpy(data, row->body[i].iov_base, row->body[i].iov_len);
+		r->row.body[i].iov_base = data;
+		data += row->body[i].iov_len;
+	}
+	return r;
+}
+
+/**
+ * Find out which key of which space the row modifies.
+ * If it can't be figured out, e.g. because the row is
+ * malformed, make the row conflict with the whole space
+ * or with all other rows: errors will be reported when
+ * the row is applied.
+ */
+static void
+applier_row_set_key(struct applier_row *r)
+{
+	r->space_id = 0;
+	r->key_hash = 0;
+	r->is_space_wide = true;
+	r->is_barrier = true;
+
+	if (!iproto_type_is_dml(r->row.type))
+		return;
+	struct request *request = xrow_decode_dml_gc(&r->row);
+	if (request == NULL)
+		goto fail;
+	struct space *space;
+	space = space_by_id(request->space_id);
+	if (space == NULL || space_is_system(space))
+		return;
+	r->space_id = request->space_id;
+	r->is_barrier = false;
+
+	struct Index *pk;
+	pk = space_index(space, 0);
+	if (pk == NULL)
+		return;
+	struct key_def *key_def;
+	key_def = pk->index_def->key_def;
+	const char *key;
+	uint32_t part_count;
+	switch (request->type) {
+	case IPROTO_INSERT:
+	case IPROTO_REPLACE:
+	case IPROTO_UPSERT:
+		if (request->tuple == NULL)
+			return;
+		if (tuple_validate_raw(space->format, request->tuple) != 0)
+			goto fail;
+		key = tuple_extract_key_raw(request->tuple, request->tuple_end,
+					    key_def, NULL);
+		if (key == NULL)
+			goto fail;
+		part_count = mp_decode_array(&key);
+		break;
+	case IPROTO_UPDATE:
+	case IPROTO_DELETE:
+		/* Rows in WAL are always bound to the primary key. */
+		if (request->index_id != 0)
+			return;
+		key = request->key;
+		if (key == NULL || mp_typeof(*key) != MP_ARRAY)
+			return;
+		part_count = mp_decode_array(&key);
+		if (part_count != key_def->part_count ||
+		    primary_key_validate(key_def, key, part_count) != 0)
+			goto fail;
+		break;
+	default:
+		return;
+	}
+	r->key_hash = key_hash(key, key_def);
+	r->is_space_wide = false;
+	return;
+fail:
+	diag_clear(diag_get());
+}
+
+/**
+ * Return true if the row must not be applied until
+ * one of the rows being applied is committed.
+ */
+static bool
+applier_row_conflicts(struct applier *applier, struct applier_row *r)
+{
+	struct applier_row *other;
+	rlist_foreach_entry(other, &applier->apply_inflight, in_inflight) {
+		if (r->is_barrier || other->is_barrier)
+			return true;
+		if (r->space_id != other->space_id)
+			continue;
+		if (r->is_space_wide || other->is_space_wide ||
+		    r->key_hash == other->key_hash)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Stop the reader and apply fibers with the error
+ * set in the diagnostics area of the current fiber.
+ * Only the first error is remembered.
+ */
+static void
+applier_set_error(struct applier *applier)
+{
+	if (!applier->apply_stop) {
+		diag_move(diag_get(), &applier->apply_diag);
+		applier->apply_stop = true;
+	}
+	diag_clear(diag_get());
+	fiber_cond_broadcast(&applier->apply_cond);
+}
+
+/**
+ * Let the next row be submitted to WAL. Invoked right
+ * before the WAL write of the current row is queued.
+ */
+static void
+applier_on_journal_write(struct trigger *trigger, void * /* event */)
+{
+	struct applier *applier = (struct applier *) trigger->data;
+	applier->apply_seq++;
+	fiber_cond_broadcast(&applier->apply_cond);
+}
+
+/**
+ * Apply a row received from the master and wait for it
+ * to be committed. Rows are submitted to WAL strictly in
+ * the order they were received, since LSNs of the rows
+ * of each replica must grow.
+ */
+static void
+applier_apply_row(struct applier *applier, struct applier_row *r)
+{
+	struct xrow_header *row = &r->row;
+
+	/* Wait for all preceding rows to be submitted to WAL. */
+	while (r->seq != applier->apply_seq) {
+		if (applier->apply_stop)
+			return;
+		fiber_cond_wait(&applier->apply_cond);
+	}
+	/* Wait for preceding rows modifying the same key to commit. */
+	applier_row_set_key(r);
+	while (applier_row_conflicts(applier, r)) {
+		if (applier->apply_stop)
+			return;
+		fiber_cond_wait(&applier->apply_cond);
+	}
+	if (vclock_get(&replicaset_vclock, row->replica_id) >= row->lsn) {
+		/* The row has already been applied. */
+		applier->apply_seq++;
+		return;
+	}
+	/**
+	 * Promote the replica set vclock before
+	 * applying the row. If there is an
+	 * exception (conflict) applying the row,
+	 * the row is skipped when the replication
+	 * is resumed.
+	 */
+	vclock_follow(&replicaset_vclock, row->replica_id, row->lsn);
+
+	struct trigger on_journal_write;
+	trigger_create(&on_journal_write, applier_on_journal_write,
+		       applier, NULL);
+	rlist_add_tail_entry(&applier->apply_inflight, r, in_inflight);
+	try {
+		struct txn *txn = txn_begin(true);
+		txn_on_journal_write(txn, &on_journal_write);
+		xstream_write_xc(applier->subscribe_stream, row);
+	} catch (Exception *e) {
+		txn_rollback();
+		rlist_del_entry(r, in_inflight);
+		throw;
+	}
+	rlist_del_entry(r, in_inflight);
+	if (applier->apply_seq == r->seq) {
+		/* Nothing was written to WAL, e.g. a temporary space. */
+		applier->apply_seq++;
+	}
+	applier->lag = ev_now(loop()) - row->tm;
+}
+
+/** Fiber function applying rows from applier::apply_queue. */
+static int
+applier_apply_f(va_list ap)
+{
+	struct applier *applier = va_arg(ap, struct applier *);
+	while (!applier->apply_stop) {
+		if (stailq_empty(&applier->apply_queue)) {
+			fiber_cond_wait(&applier->apply_cond);
+			continue;
+		}
+		struct applier_row *r = stailq_shift_entry(&applier->apply_queue,
+						struct applier_row, in_queue);
+		try {
+			applier_apply_row(applier, r);
+		} catch (Exception *e) {
+			applier_set_error(applier);
+		}
+		free(r);
+		applier->queue_len--;
+		fiber_cond_broadcast(&applier->apply_cond);
+		fiber_gc();
+	}
+	return 0;
+}
+
+/** Read rows from the master to applier::apply_queue. */
+static void
+applier_read_rows(struct applier *applier)
+{
+	struct iobuf *iobuf = applier->iobuf;
+	struct xrow_header row;
+
+	while (true) {
+		while (applier->queue_len >= APPLIER_QUEUE_MAX) {
+			fiber_cond_wait(&applier->apply_cond);
+			fiber_testcancel();
+		}
+		applier_read_xrow(applier, &row);
+		applier->last_row_time = ev_now(loop());
+
+		if (iproto_type_is_error(row.type))
+			xrow_decode_error_xc(&row);  /* error */
+		/* Replication request. */
+		if (row.replica_id == REPLICA_ID_NIL ||
+		    row.replica_id >= VCLOCK_MAX) {
+			/*
+			 * A safety net, this can only occur
+			 * if we're fed a strangely broken xlog.
+			 */
+			tnt_raise(ClientError, ER_UNKNOWN_REPLICA,
+				  int2str(row.replica_id),
+				  tt_uuid_str(&REPLICASET_UUID));
+		}
+		struct applier_row *r = applier_row_new(&row);
+		r->seq = applier->read_seq++;
+		stailq_add_tail_entry(&applier->apply_queue, r, in_queue);
+		applier->queue_len++;
+		fiber_cond_broadcast(&applier->apply_cond);
+		iobuf_reset(iobuf);
+		fiber_gc();
+	}
+}
+
+static int
+applier_net_reader_f(va_list ap)
+{
+	struct applier *applier = va_arg(ap, struct applier *);
+	try {
+		applier_read_rows(applier);
+	} catch (Exception *e) {
+		applier_set_error(applier);
+	}
+	return 0;
+}
+
+/**
+ * Follow updates from the master until an error occurs:
+ * start the reader and apply fibers, then wait for any of
+ * them to fail and rethrow the error.
+ */
+static void
+applier_follow(struct applier *applier)
+{
+	assert(stailq_empty(&applier->apply_queue));
+	assert(rlist_empty(&applier->apply_inflight));
+	applier->queue_len = 0;
+	applier->read_seq = 0;
+	applier->apply_seq = 0;
+	applier->apply_stop = false;
+	diag_clear(&applier->apply_diag);
+
+	struct fiber *fibers[APPLIER_FIBERS_MAX];
+	int fiber_count = 0;
+	applier->net_reader = fiber_new("applier_reader",
+					applier_net_reader_f);
+	if (applier->net_reader == NULL)
+		diag_raise();
+	fiber_set_joinable(applier->net_reader, true);
+	fiber_start(applier->net_reader, applier);
+	for (int i = 0; i < applier_fiber_count; i++) {
+		struct fiber *f = fiber_new("applier_apply", applier_apply_f);
+		if (f == NULL) {
+			applier_set_error(applier);
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fibers[fiber_count++] = f;
+		fiber_start(f, applier);
+	}
+
+	while (!applier->apply_stop && !fiber_is_cancelled())
+		fiber_cond_wait(&applier->apply_cond);
+
+	/*
+	 * Rows that are being written to WAL can't be
+	 * cancelled, so let the apply fibers finish.
+	 */
+	applier->apply_stop = true;
+	fiber_cond_broadcast(&applier->apply_cond);
+	fiber_cancel(applier->net_reader);
+	fiber_join(applier->net_reader);
+	applier->net_reader = NULL;
+	for (int i = 0; i < fiber_count; i++)
+		fiber_join(fibers[i]);
+
+	/* Rows that haven't been applied will be resent. */
+	while (!stailq_empty(&applier->apply_queue)) {
+		free(stailq_shift_entry(&applier->apply_queue,
+					struct applier_row, in_queue));
+	}
+	applier->queue_len = 0;
+
+	fiber_testcancel();
+	diag_move(&applier->apply_diag, diag_get());
+	diag_raise();
+}
+
 /**
  * Execute and process SUBSCRIBE request (follow updates from a master).
  */
@@ -308,7 +970,7 @@ applier_subscribe(struct applier *applier)
 	struct xrow_header row;
 
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &replicaset_vclock);
+				 &replicaset_vclock, applier_compression);
 	coio_write_xrow(coio, &row);
 	applier_set_state(applier, APPLIER_FOLLOW);
 
@@ -345,45 +1007,14 @@ applier_subscribe(struct applier *applier)
 	/*
 	 * Process a stream of rows from the binary log.
 	 */
-	while (true) {
-		coio_read_xrow(coio, &iobuf->in, &row);
-		applier->lag = ev_now(loop()) - row.tm;
-		applier->last_row_time = ev_now(loop());
-
-		if (iproto_type_is_error(row.type))
-			xrow_decode_error_xc(&row);  /* error */
-		/* Replication request. */
-		if (row.replica_id == REPLICA_ID_NIL ||
-		    row.replica_id >= VCLOCK_MAX) {
-			/*
-			 * A safety net, this can only occur
-			 * if we're fed a strangely broken xlog.
-			 */
-			tnt_raise(ClientError, ER_UNKNOWN_REPLICA,
-				  int2str(row.replica_id),
-				  tt_uuid_str(&REPLICASET_UUID));
-		}
-		if (vclock_get(&replicaset_vclock, row.replica_id) < row.lsn) {
-			/**
-			 * Promote the replica set vclock before
-			 * applying the row. If there is an
-			 * exception (conflict) applying the row,
-			 * the row is skipped when the replication
-			 * is resumed.
-			 */
-			vclock_follow(&replicaset_vclock, row.replica_id,
-				      row.lsn);
-			xstream_write_xc(applier->subscribe_stream, &row);
-		}
-		iobuf_reset(iobuf);
-		fiber_gc();
-	}
+	applier_follow(applier);
 }
 
 static inline void
 applier_disconnect(struct applier *applier, enum applier_state state)
 {
 	coio_close(loop(), &applier->io);
+	applier_close_tx_cursor(applier);
 	iobuf_reset(applier->iobuf);
 	applier_set_state(applier, state);
 	fiber_gc();
@@ -398,10 +1029,12 @@ applier_f(va_list ap)
 	while (!fiber_is_cancelled()) {
 		try {
 			applier_connect(applier);
-			if (tt_uuid_is_nil(&REPLICASET_UUID)) {
+			if (tt_uuid_is_nil(&REPLICASET_UUID) ||
+			    applier->join_is_resumable) {
 				/*
 				 * Execute JOIN if this is a bootstrap,
-				 * and there is no snapshot. The
+				 * and there is no snapshot, or resume
+				 * the interrupted one. The
 				 * join will pause the applier
 				 * until WAL is created.
 				 */
@@ -489,6 +1122,9 @@ applier_stop(struct applier *applier)
 	fiber_join(f);
 	applier_set_state(applier, APPLIER_OFF);
 	applier->reader = NULL;
+	/* The bootstrap has been aborted. */
+	if (applier_stop_join_helpers(applier) != 0)
+		error_log(diag_last_error(diag_get()));
 }
 
 struct applier *
@@ -514,9 +1150,14 @@ applier_new(const char *uri, struct xstream *join_stream,
 
 	applier->join_stream = join_stream;
 	applier->subscribe_stream = subscribe_stream;
+	stailq_create(&applier->apply_queue);
+	rlist_create(&applier->apply_inflight);
+	fiber_cond_create(&applier->apply_cond);
+	diag_create(&applier->apply_diag);
 	applier->last_row_time = ev_now(loop());
 	rlist_create(&applier->on_state);
 	fiber_channel_create(&applier->pause, 0);
+	fiber_cond_create(&applier->join_cond);
 
 	return applier;
 }
@@ -527,7 +1168,14 @@ applier_delete(struct applier *applier)
 	assert(applier->reader == NULL);
 	iobuf_delete(applier->iobuf);
 	assert(applier->io.fd == -1);
+	assert(!applier->tx_cursor_is_open);
+	assert(applier->join_helpers == NULL);
+	if (applier->zdctx != NULL)
+		ZSTD_freeDStream(applier->zdctx);
 	fiber_channel_destroy(&applier->pause);
+	fiber_cond_destroy(&applier->join_cond);
+	fiber_cond_destroy(&applier->apply_cond);
+	diag_destroy(&applier->apply_diag);
 	trigger_destroy(&applier->on_state);
 	free(applier);
 }
@@ -35,18 +35,47 @@
 #include <sys/socket.h>
 #include <tarantool_ev.h>
 
+#include "diag.h"
 #include "fiber_channel.h"
+#include "fiber_cond.h"
+#include "salad/stailq.h"
 #include "trigger.h"
 #include "trivia/util.h"
 #include "tt_uuid.h"
 #include "uri.h"
 
 #include "vclock.h"
+#include "xlog.h"
+#include "xrow.h"
 
 struct xstream;
 
 enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 
+/** Max value of box.cfg.replication_apply_fibers. */
+enum { APPLIER_FIBERS_MAX = 64 };
+
+/**
+ * Number of fibers applying rows received from a master,
+ * box.cfg.replication_apply_fibers.
+ */
+extern int applier_fiber_count;
+
+/**
+ * Set if masters are asked to compress the replication
+ * stream, box.cfg.replication_compression.
+ */
+extern bool applier_compression;
+
+/** Max value of box.cfg.replication_join_connections. */
+enum { APPLIER_JOIN_CONNECTIONS_MAX = 32 };
+
+/**
+ * Number of connections to receive initial data over on
+ * bootstrap, box.cfg.replication_join_connections.
+ */
+extern int applier_join_connections;
+
 #define applier_STATE(_)                                             \
 	_(APPLIER_OFF, 0)                                            \
 	_(APPLIER_CONNECT, 1)                                        \
@@ -74,7 +103,10 @@ struct applier {
 	enum applier_state state;
 	/** Local time of this replica when the last row has been received */
 	ev_tstamp last_row_time;
-	/** Number of seconds this replica is behind the remote master */
+	/**
+	 * Number of seconds this replica is behind the remote master,
+	 * as of the last applied row
+	 */
 	ev_tstamp lag;
 	/** The last box_error_code() logged to avoid log flooding */
 	uint32_t last_logged_errcode;
@@ -105,6 +137,74 @@ struct applier {
 	struct xstream *join_stream;
 	/** xstream to process rows during final JOIN and SUBSCRIBE */
 	struct xstream *subscribe_stream;
+	/**
+	 * In SUBSCRIBE mode, rows are read from the master by
+	 * a separate fiber, put to a queue and applied by
+	 * applier_fiber_count fibers. WAL writes of rows are
+	 * submitted in the order the rows were received, but
+	 * a row may be applied while WAL writes of preceding
+	 * rows are still in progress, unless it modifies the
+	 * same key.
+	 */
+	/** Fiber reading rows from the master. */
+	struct fiber *net_reader;
+	/** Rows read from the master, not taken by an apply fiber. */
+	struct stailq apply_queue;
+	/** Rows being applied, used to detect conflicts. */
+	struct rlist apply_inflight;
+	/** Number of rows received, but not applied yet. */
+	int queue_len;
+	/** Sequence number of the next row read from the master. */
+	int64_t read_seq;
+	/** Sequence number of the row to be submitted to WAL next. */
+	int64_t apply_seq;
+	/** Signaled whenever the state of the apply queue changes. */
+	struct fiber_cond apply_cond;
+	/** Set if the reader and apply fibers must stop. */
+	bool apply_stop;
+	/** Error that stopped the reader or an apply fiber. */
+	struct diag apply_diag;
+	/**
+	 * If the stream is compressed, the master sends rows
+	 * packed in xlog tx blocks, see applier_read_xrow().
+	 */
+	/** Rows of the last block received from the master. */
+	struct xlog_tx_cursor tx_cursor;
+	/** Set if @tx_cursor has been created and not destroyed. */
+	bool tx_cursor_is_open;
+	/** Decompression context, created on the first block. */
+	ZSTD_DStream *zdctx;
+	/** Size of blocks received from the master. */
+	int64_t tx_bytes;
+	/** Size of rows unpacked from the blocks. */
+	int64_t tx_raw_bytes;
+	/** CPU time spent unpacking the blocks, in seconds. */
+	double decompress_time;
+	/**
+	 * Initial data may be split into parts received over
+	 * separate connections, see applier_join(). Part 0 is
+	 * received by the applier itself, the others by helper
+	 * appliers, which only receive initial data.
+	 */
+	/** Part of the initial data received by this applier. */
+	struct join_part join_part;
+	/** Vclock of the checkpoint the initial data is sent from. */
+	struct vclock join_vclock;
+	/** Number of rows of @join_part applied so far. */
+	uint64_t join_rows;
+	/**
+	 * Set while the initial data is being received from
+	 * a master that can resume it after a reconnect.
+	 */
+	bool join_is_resumable;
+	/** Applier receiving part 0 if this is a helper. */
+	struct applier *join_leader;
+	/** Helpers receiving the other parts. */
+	struct applier **join_helpers;
+	/** Number of helpers in @join_helpers. */
+	int join_helper_count;
+	/** Signaled when a helper is done. */
+	struct fiber_cond join_cond;
 };
 
 /**
@@ -67,8 +67,11 @@
 #include "gc.h"
 #include "checkpoint.h"
 #include "sql.h"
+#include "sql_stmt_cache.h"
 #include "systemd.h"
 #include "call.h"
+#include "clock.h"
+#include "info.h"
 
 static char status[64] = "unknown";
 
@@ -169,11 +172,39 @@ request_rebind_to_primary_key(struct request *request, struct space *space,
 	request->header = NULL;
 }
 
+/** Map a DML request type to a latency statistics operation. */
+static enum latency_stat_op
+latency_stat_op_by_type(uint32_t type)
+{
+	switch (type) {
+	case IPROTO_INSERT:
+		return LATENCY_STAT_INSERT;
+	case IPROTO_REPLACE:
+		return LATENCY_STAT_REPLACE;
+	case IPROTO_UPDATE:
+		return LATENCY_STAT_UPDATE;
+	case IPROTO_UPSERT:
+		return LATENCY_STAT_UPSERT;
+	case IPROTO_DELETE:
+		return LATENCY_STAT_DELETE;
+	default:
+		unreachable();
+		return latency_stat_op_MAX;
+	}
+}
+
 static void
 process_rw(struct request *request, struct space *space, struct tuple **result)
 {
 	assert(iproto_type_is_dml(request->type));
 	rmean_collect(rmean_box, request->type, 1);
+	/*
+	 * The request may be rebound to the primary key
+	 * below, so remember the index it was addressed to.
+	 */
+	uint32_t space_id = request->space_id;
+	uint32_t index_id = request->index_id;
+	double start = latency_stat_enabled ? clock_monotonic() : 0;
 	try {
 		struct txn *txn = txn_begin_stmt(space);
 		access_check_space(space, PRIV_W);
@@ -223,6 +254,10 @@ process_rw(struct request *request, struct space *space, struct tuple **result)
 		 */
 		TupleRefNil ref(tuple);
 		txn_commit_stmt(txn, request);
+		if (start != 0) {
+			space_collect_latency(space_id, index_id,
+				latency_stat_op_by_type(request->type), start);
+		}
 		if (result) {
 			if (tuple)
 				tuple_bless_xc(tuple);
@@ -406,6 +441,18 @@ box_check_wal_mode(const char *mode_name)
 	return (enum wal_mode) mode;
 }
 
+static void
+box_check_vinyl_compaction(const char *policy)
+{
+	assert(policy != NULL); /* checked in Lua */
+	if (strindex(index_compaction_policy_strs, policy,
+		     index_compaction_policy_MAX) ==
+	    index_compaction_policy_MAX) {
+		tnt_raise(ClientError, ER_CFG, "vinyl_compaction",
+			  "must be either 'tiered' or 'leveled'");
+	}
+}
+
 static void
 box_check_readahead(int readahead)
 {
@@ -417,6 +464,33 @@ box_check_readahead(int readahead)
 	}
 }
 
+static void
+box_check_iproto_threads(int threads)
+{
+	if (threads < 1 || threads > IPROTO_THREADS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "iproto_threads",
+			  "specified value is out of bounds");
+	}
+}
+
+static void
+box_check_replication_apply_fibers(int fibers)
+{
+	if (fibers < 1 || fibers > APPLIER_FIBERS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "replication_apply_fibers",
+			  "specified value is out of bounds");
+	}
+}
+
+static void
+box_check_replication_join_connections(int connections)
+{
+	if (connections < 1 || connections > APPLIER_JOIN_CONNECTIONS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "replication_join_connections",
+			  "specified value is out of bounds");
+	}
+}
+
 static void
 box_check_checkpoint_count(int checkpoint_count)
 {
@@ -426,6 +500,42 @@ box_check_checkpoint_count(int checkpoint_count)
 	}
 }
 
+static void
+box_check_memtx_checkpoint_threads(int threads)
+{
+	if (threads < 1) {
+		tnt_raise(ClientError, ER_CFG, "memtx_checkpoint_threads",
+			  "the value must not be less than one");
+	}
+}
+
+static void
+box_check_sql_stmt_cache_size(int size)
+{
+	if (size < 0) {
+		tnt_raise(ClientError, ER_CFG, "sql_stmt_cache_size",
+			  "the value must not be negative");
+	}
+}
+
+static void
+box_check_memtx_recovery_threads(int threads)
+{
+	if (threads < 1) {
+		tnt_raise(ClientError, ER_CFG, "memtx_recovery_threads",
+			  "the value must not be less than one");
+	}
+}
+
+static void
+box_check_wal_recovery_threads(int threads)
+{
+	if (threads < 1) {
+		tnt_raise(ClientError, ER_CFG, "wal_recovery_threads",
+			  "the value must not be less than one");
+	}
+}
+
 static int64_t
 box_check_wal_max_rows(int64_t wal_max_rows)
 {
@@ -448,27 +558,78 @@ box_check_wal_max_size(int64_t wal_max_size)
 	return wal_max_size;
 }
 
+static double
+box_check_wal_commit_delay(double delay)
+{
+	if (delay < 0) {
+		tnt_raise(ClientError, ER_CFG, "wal_commit_delay",
+			  "the value must not be negative");
+	}
+	return delay;
+}
+
+static int64_t
+box_check_wal_commit_max_txns(int64_t txns)
+{
+	if (txns < 1) {
+		tnt_raise(ClientError, ER_CFG, "wal_commit_max_txns",
+			  "the value must not be less than one");
+	}
+	return txns;
+}
+
+static int64_t
+box_check_wal_commit_max_size(int64_t size)
+{
+	if (size < 1) {
+		tnt_raise(ClientError, ER_CFG, "wal_commit_max_size",
+			  "the value must not be less than one");
+	}
+	return size;
+}
+
 void
 box_check_config()
 {
 	box_check_log(cfg_gets("log"));
 	box_check_uri(cfg_gets("listen"), "listen");
 	box_check_replication();
+	box_check_replication_apply_fibers(cfg_geti("replication_apply_fibers"));
+	box_check_replication_join_connections(
+		cfg_geti("replication_join_connections"));
 	box_check_readahead(cfg_geti("readahead"));
+	box_check_iproto_threads(cfg_geti("iproto_threads"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
+	box_check_memtx_checkpoint_threads(cfg_geti("memtx_checkpoint_threads"));
+	box_check_memtx_recovery_threads(cfg_geti("memtx_recovery_threads"));
+	box_check_sql_stmt_cache_size(cfg_geti("sql_stmt_cache_size"));
+	box_check_wal_recovery_threads(cfg_geti("wal_recovery_threads"));
 	box_check_wal_max_rows(cfg_geti64("rows_per_wal"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
+	box_check_wal_commit_delay(cfg_getd("wal_commit_delay"));
+	box_check_wal_commit_max_txns(cfg_geti64("wal_commit_max_txns"));
+	box_check_wal_commit_max_size(cfg_geti64("wal_commit_max_size"));
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
+	box_check_vinyl_compaction(cfg_gets("vinyl_compaction"));
 	if (cfg_geti64("vinyl_page_size") > cfg_geti64("vinyl_range_size"))
 		tnt_raise(ClientError, ER_CFG, "vinyl_page_size",
 			  "can't be greater than vinyl_range_size");
 	if (cfg_geti("vinyl_read_threads") < 1)
 		tnt_raise(ClientError, ER_CFG,
 			  "vinyl_read_threads", "must be >= 1");
+	if (cfg_geti("vinyl_readahead") < 0)
+		tnt_raise(ClientError, ER_CFG,
+			  "vinyl_readahead", "must be >= 0");
+	if (cfg_geti("vinyl_aio_queue_depth") < 0)
+		tnt_raise(ClientError, ER_CFG,
+			  "vinyl_aio_queue_depth", "must be >= 0");
 	if (cfg_geti("vinyl_write_threads") < 2)
 		tnt_raise(ClientError, ER_CFG,
 			  "vinyl_write_threads", "must be >= 2");
+	if (cfg_geti("vinyl_compaction_threads") < 1)
+		tnt_raise(ClientError, ER_CFG,
+			  "vinyl_compaction_threads", "must be >= 1");
 }
 
 /*
@@ -584,12 +745,36 @@ box_set_snap_io_rate_limit(void)
 		memtx->setSnapIoRateLimit(cfg_getd("snap_io_rate_limit"));
 }
 
+void
+box_set_memtx_checkpoint_threads(void)
+{
+	int threads = cfg_geti("memtx_checkpoint_threads");
+	box_check_memtx_checkpoint_threads(threads);
+	MemtxEngine *memtx = (MemtxEngine *) engine_find("memtx");
+	if (memtx)
+		memtx->setCheckpointThreads(threads);
+}
+
+void
+box_set_sql_stmt_cache_size(void)
+{
+	int size = cfg_geti("sql_stmt_cache_size");
+	box_check_sql_stmt_cache_size(size);
+	sql_stmt_cache_set_size(size);
+}
+
 void
 box_set_too_long_threshold(void)
 {
 	too_long_threshold = cfg_getd("too_long_threshold");
 }
 
+void
+box_set_latency_stat(void)
+{
+	latency_stat_enabled = cfg_geti("latency_stat");
+}
+
 void
 box_set_readahead(void)
 {
@@ -764,6 +949,7 @@ box_select(struct port *port, uint32_t space_id, uint32_t index_id,
 	   const char *key, const char *key_end)
 {
 	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+	double start = latency_stat_enabled ? clock_monotonic() : 0;
 
 	try {
 		struct space *space = space_cache_find(space_id);
@@ -772,6 +958,10 @@ box_select(struct port *port, uint32_t space_id, uint32_t index_id,
 		space->handler->executeSelect(txn, space, index_id, iterator,
 					      offset, limit, key, key_end, port);
 		txn_commit_ro_stmt(txn);
+		if (start != 0) {
+			space_collect_latency(space_id, index_id,
+					      LATENCY_STAT_SELECT, start);
+		}
 		return 0;
 	} catch (Exception *e) {
 		txn_rollback_stmt();
@@ -909,6 +1099,40 @@ box_truncate(uint32_t space_id)
 	}
 }
 
+int
+box_space_stat(uint32_t space_id, struct info_handler *info)
+{
+	try {
+		struct space *space = space_cache_find(space_id);
+		info_begin(info);
+		space_latency_info(space, info);
+		info_end(info);
+		return 0;
+	} catch (Exception *) {
+		return -1;
+	}
+}
+
+static void
+box_latency_stat_space(struct space *space, void *udata)
+{
+	struct info_handler *info = (struct info_handler *) udata;
+	/* Index requests are accounted in the space, too. */
+	if (latency_stat_is_empty(&space->latency_stat))
+		return;
+	info_table_begin(info, space_name(space));
+	space_latency_info(space, info);
+	info_table_end(info);
+}
+
+void
+box_latency_stat(struct info_handler *info)
+{
+	info_begin(info);
+	space_foreach(box_latency_stat_space, info);
+	info_end(info);
+}
+
 static inline void
 box_register_replica(uint32_t id, const struct tt_uuid *uuid)
 {
@@ -965,6 +1189,20 @@ box_process_auth(struct auth_request *request, struct obuf *out)
 	iproto_reply_ok_xc(out, request->header->sync, ::schema_version);
 }
 
+/** Return true if there is a checkpoint with the given vclock. */
+static bool
+checkpoint_exists(const struct vclock *vclock)
+{
+	struct checkpoint_iterator it;
+	checkpoint_iterator_init(&it);
+	const struct vclock *curr;
+	while ((curr = checkpoint_iterator_prev(&it)) != NULL) {
+		if (vclock_compare(curr, vclock) == 0)
+			return true;
+	}
+	return false;
+}
+
 void
 box_process_join(struct ev_io *io, struct xrow_header *header)
 {
@@ -974,7 +1212,7 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 	 *
 	 * Replica => Master
 	 *
-	 * => JOIN { INSTANCE_UUID: replica_uuid }
+	 * => JOIN { INSTANCE_UUID: replica_uuid, COMPRESSION: true }
 	 * <= OK { VCLOCK: start_vclock }
 	 *    Replica has enough permissions and master is ready for JOIN.
 	 *     - start_vclock - vclock of the latest master's checkpoint.
@@ -1002,6 +1240,20 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 	 *      - `current_vclock` - master's vclock after final stage.
 	 *
 	 * All packets must have the same SYNC value as initial JOIN request.
+	 *
+	 * The replica may receive initial data over several connections
+	 * and resume it after a reconnect. Then it sets the optional
+	 * JOIN_PART key: [part_id, part_count, skip], and, unless both
+	 * part_id and skip are 0, VCLOCK of the checkpoint to send. The
+	 * master sends only rows of spaces from the given part, skipping
+	 * the first `skip` of them, and echoes JOIN_PART in the first OK.
+	 * A JOIN for part_id > 0 ends with the initial stage.
+	 *
+	 * If the replica sets the optional COMPRESSION key, the
+	 * master may send initial and final data rows packed in xlog
+	 * tx blocks (zstd-compressed if big enough) instead of iproto
+	 * packets. The replica tells them apart by the first byte.
+	 *
 	 * Master can send ERROR at any time. Replica doesn't confirm rows
 	 * by OKs. Either initial or final stream includes:
 	 *  - Cluster UUID in _schema space
@@ -1013,7 +1265,20 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 
 	/* Decode JOIN request */
 	struct tt_uuid instance_uuid = uuid_nil;
-	xrow_decode_join(header, &instance_uuid);
+	struct vclock join_vclock;
+	vclock_create(&join_vclock);
+	bool compress = false;
+	struct join_part part;
+	memset(&part, 0, sizeof(part));
+	xrow_decode_join(header, &instance_uuid, &join_vclock, &compress, &part);
+	bool has_part = part.count > 0;
+	if (!has_part)
+		part.count = 1;
+	if (part.skip > 0) {
+		say_info("resuming initial join part %u of %u after %llu rows",
+			 (unsigned) part.id, (unsigned) part.count,
+			 (unsigned long long) part.skip);
+	}
 
 	/* Check that bootstrap has been finished */
 	if (!is_box_configured)
@@ -1038,19 +1303,38 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 
 	/* Remember start vclock. */
 	struct vclock start_vclock;
-	/*
-	 * The only case when the directory index is empty is
-	 * when someone has deleted a snapshot and tries to join
-	 * as a replica. Our best effort is to not crash in such
-	 * case: raise ER_MISSING_SNAPSHOT.
-	 */
-	if (checkpoint_last(&start_vclock) < 0)
-		tnt_raise(ClientError, ER_MISSING_SNAPSHOT);
+	if (part.id == 0 && part.skip == 0) {
+		/*
+		 * The only case when the directory index is empty
+		 * is when someone has deleted a snapshot and tries
+		 * to join as a replica. Our best effort is to not
+		 * crash in such case: raise ER_MISSING_SNAPSHOT.
+		 */
+		if (checkpoint_last(&start_vclock) < 0)
+			tnt_raise(ClientError, ER_MISSING_SNAPSHOT);
+	} else {
+		/*
+		 * All parts of the initial data must be sent
+		 * from the same checkpoint. If it has been
+		 * garbage collected, the replica has to start
+		 * over.
+		 */
+		if (!checkpoint_exists(&join_vclock)) {
+			say_warn("can't resume initial join part %u: "
+				 "the checkpoint has been collected",
+				 (unsigned) part.id);
+			tnt_raise(ClientError, ER_MISSING_SNAPSHOT);
+		}
+		vclock_copy(&start_vclock, &join_vclock);
+	}
 
 	/* Register the replica with the garbage collector. */
-	struct gc_consumer *gc = gc_consumer_register(
-		tt_sprintf("replica %s", tt_uuid_str(&instance_uuid)),
-		vclock_sum(&start_vclock));
+	const char *gc_name = part.id == 0 ?
+		tt_sprintf("replica %s", tt_uuid_str(&instance_uuid)) :
+		tt_sprintf("replica %s part %u", tt_uuid_str(&instance_uuid),
+			   (unsigned) part.id);
+	struct gc_consumer *gc = gc_consumer_register(gc_name,
+					vclock_sum(&start_vclock));
 	if (gc == NULL)
 		diag_raise();
 	auto gc_guard = make_scoped_guard([=]{
@@ -1059,16 +1343,29 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 
 	/* Respond to JOIN request with start_vclock. */
 	struct xrow_header row;
-	xrow_encode_vclock_xc(&row, &start_vclock);
+	xrow_encode_join_response_xc(&row, &start_vclock,
+				     has_part ? &part : NULL);
 	row.sync = header->sync;
 	coio_write_xrow(io, &row);
 
 	/*
 	 * Initial stream: feed replica with dirty data from engines.
 	 */
-	relay_initial_join(io->fd, header->sync, &start_vclock);
+	relay_initial_join(io->fd, header->sync, &start_vclock, compress,
+			   &part);
 	say_info("initial data sent.");
 
+	if (part.id != 0) {
+		/*
+		 * The rest is sent over the connection
+		 * of part 0.
+		 */
+		xrow_encode_vclock_xc(&row, &start_vclock);
+		row.sync = header->sync;
+		coio_write_xrow(io, &row);
+		return;
+	}
+
 	/**
 	 * Call the server-side hook which stores the replica uuid
 	 * in _cluster space after sending the last row but before
@@ -1079,6 +1376,9 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 
 	struct replica *replica = replica_by_uuid(&instance_uuid);
 	assert(replica != NULL);
+	/* Left by an interrupted JOIN. */
+	if (replica->gc != NULL)
+		gc_consumer_unregister(replica->gc);
 	replica->gc = gc;
 	gc_guard.is_active = false;
 
@@ -1095,7 +1395,8 @@ box_process_join(struct ev_io *io, struct xrow_header *header)
 	 * Final stage: feed replica with WALs in range
 	 * (start_vclock, stop_vclock).
 	 */
-	relay_final_join(io->fd, header->sync, &start_vclock, &stop_vclock);
+	relay_final_join(io->fd, header->sync, &start_vclock, &stop_vclock,
+			 compress);
 	say_info("final data sent.");
 
 	/* Send end of WAL stream marker */
@@ -1118,8 +1419,9 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	struct tt_uuid replicaset_uuid = uuid_nil, replica_uuid = uuid_nil;
 	struct vclock replica_clock;
 	vclock_create(&replica_clock);
+	bool compress = false;
 	xrow_decode_subscribe_xc(header, &replicaset_uuid, &replica_uuid,
-				 &replica_clock);
+				 &replica_clock, &compress, NULL);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -1186,7 +1488,8 @@ box_process_subscribe(struct ev_io *io, struct xrow_header *header)
 	 * a stall in updates (in this case replica may hang
 	 * indefinitely).
 	 */
-	relay_subscribe(io->fd, header->sync, replica, &replica_clock);
+	relay_subscribe(io->fd, header->sync, replica, &replica_clock,
+			compress);
 }
 
 /** Insert a new cluster into _schema */
@@ -1213,6 +1516,7 @@ box_free(void)
 #if 0
 		session_free();
 		replication_free();
+		sql_stmt_cache_free();
 		sql_free();
 		user_cache_free();
 		schema_free();
@@ -1240,6 +1544,7 @@ engine_init()
 					     cfg_geti("memtx_min_tuple_size"),
 					     cfg_geti("memtx_max_tuple_size"),
 					     cfg_getd("slab_alloc_factor"));
+	memtx->setRecoveryThreads(cfg_geti("memtx_recovery_threads"));
 	engine_register(memtx);
 
 	SysviewEngine *sysview = new SysviewEngine();
@@ -1408,7 +1713,7 @@ box_cfg_xc(void)
 	schema_init();
 	replication_init();
 	port_init();
-	iproto_init();
+	iproto_init(cfg_geti("iproto_threads"));
 	wal_thread_start();
 
 	title("loading");
@@ -1417,6 +1722,9 @@ box_cfg_xc(void)
 	box_set_too_long_threshold();
 	xstream_create(&join_stream, apply_initial_join_row);
 	xstream_create(&subscribe_stream, apply_row);
+	applier_fiber_count = cfg_geti("replication_apply_fibers");
+	applier_compression = cfg_geti("replication_compression");
+	applier_join_connections = cfg_geti("replication_join_connections");
 
 	struct vclock last_checkpoint_vclock;
 	int64_t last_checkpoint_lsn = checkpoint_last(&last_checkpoint_vclock);
@@ -1452,6 +1760,7 @@ box_cfg_xc(void)
 					cfg_geti("force_recovery"),
 					&last_checkpoint_vclock);
 		auto guard = make_scoped_guard([=]{ recovery_delete(recovery); });
+		recovery->read_threads = cfg_geti("wal_recovery_threads");
 
 		/*
 		 * recovery->vclock is needed by Vinyl to filter
@@ -1548,8 +1857,16 @@ box_cfg_xc(void)
 	int64_t wal_max_rows = box_check_wal_max_rows(cfg_geti64("rows_per_wal"));
 	int64_t wal_max_size = box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	enum wal_mode wal_mode = box_check_wal_mode(cfg_gets("wal_mode"));
+	double commit_delay =
+		box_check_wal_commit_delay(cfg_getd("wal_commit_delay"));
+	int64_t commit_max_txns =
+		box_check_wal_commit_max_txns(cfg_geti64("wal_commit_max_txns"));
+	int64_t commit_max_size =
+		box_check_wal_commit_max_size(cfg_geti64("wal_commit_max_size"));
 	wal_init(wal_mode, cfg_gets("wal_dir"), &INSTANCE_UUID,
-		 &replicaset_vclock, wal_max_rows, wal_max_size);
+		 &replicaset_vclock, wal_max_rows, wal_max_size,
+		 commit_delay, commit_max_txns, commit_max_size,
+		 cfg_geti("wal_preallocate"));
 
 	rmean_cleanup(rmean_box);
 
@@ -1560,6 +1877,8 @@ box_cfg_xc(void)
 	}
 
 	sql_init();
+	sql_stmt_cache_init();
+	box_set_sql_stmt_cache_size();
 
 	title("running");
 	say_info("ready to accept requests");
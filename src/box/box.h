@@ -147,7 +147,10 @@ void box_set_replication(void);
 void box_set_log_level(void);
 void box_set_io_collect_interval(void);
 void box_set_snap_io_rate_limit(void);
+void box_set_memtx_checkpoint_threads(void);
+void box_set_sql_stmt_cache_size(void);
 void box_set_too_long_threshold(void);
+void box_set_latency_stat(void);
 void box_set_readahead(void);
 void box_set_checkpoint_count(void);
 void box_update_vinyl_options(void);
@@ -313,6 +316,26 @@ box_truncate(uint32_t space_id);
 
 /** \endcond public */
 
+struct info_handler;
+
+/**
+ * Space request latency introspection (space:stat()).
+ *
+ * \param space_id space identifier
+ * \param info info handler
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+int
+box_space_stat(uint32_t space_id, struct info_handler *info);
+
+/**
+ * Request latency of all spaces which have been accessed
+ * since latency statistics was enabled (box.stat.latency()).
+ */
+void
+box_latency_stat(struct info_handler *info);
+
 /**
  * The main entry point to the
  * Box: callbacks into the request processor.
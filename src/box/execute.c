@@ -38,6 +38,7 @@
 #include "small/obuf.h"
 #include "diag.h"
 #include "sql.h"
+#include "sql_stmt_cache.h"
 #include "xrow.h"
 #include "schema.h"
 #include "port.h"
@@ -262,12 +263,15 @@ error:
 
 	uint32_t map_size = mp_decode_map(&data);
 	request->sql_text = NULL;
+	request->stmt_id = 0;
 	request->bind = NULL;
 	request->bind_count = 0;
 	request->sync = row->sync;
+	bool has_stmt_id = false;
 	for (uint32_t i = 0; i < map_size; ++i) {
 		uint8_t key = *data;
-		if (key != IPROTO_SQL_BIND && key != IPROTO_SQL_TEXT) {
+		if (key != IPROTO_SQL_BIND && key != IPROTO_SQL_TEXT &&
+		    key != IPROTO_SQL_STMT_ID) {
 			mp_check(&data, end);   /* skip the key */
 			mp_check(&data, end);   /* skip the value */
 			continue;
@@ -278,11 +282,23 @@ error:
 		if (key == IPROTO_SQL_BIND) {
 			if (sql_bind_list_decode(request, value, region) != 0)
 				return -1;
+		} else if (key == IPROTO_SQL_STMT_ID) {
+			if (mp_typeof(*value) != MP_UINT)
+				goto error;
+			uint64_t id = mp_decode_uint(&value);
+			if (id > UINT32_MAX)
+				goto error;
+			request->stmt_id = id;
+			has_stmt_id = true;
 		} else {
+			if (mp_typeof(*value) != MP_STR)
+				goto error;
 			request->sql_text = value;
 		}
 	}
-	if (request->sql_text == NULL) {
+	/* EXECUTE takes either a statement text or a prepared id. */
+	if (request->sql_text == NULL &&
+	    (row->type != IPROTO_EXECUTE || !has_stmt_id)) {
 		diag_set(ClientError, ER_MISSING_REQUEST_FIELD,
 			 iproto_key_name(IPROTO_SQL_TEXT));
 		return -1;
@@ -640,31 +656,60 @@ err_execute:
 }
 
 int
-sql_prepare_and_execute(const struct sql_request *request, struct obuf *out,
-			struct region *region)
+sql_prepare(const struct sql_request *request, struct obuf *out)
 {
+	assert(request->sql_text != NULL);
 	const char *sql = request->sql_text;
 	uint32_t len;
 	sql = mp_decode_str(&sql, &len);
-	struct sqlite3_stmt *stmt;
+	uint32_t id;
+	if (sql_stmt_cache_prepare(sql, len, &id) != 0)
+		return -1;
+	struct obuf_svp header_svp;
+	if (iproto_prepare_header(out, &header_svp, IPROTO_SQL_HEADER_LEN) != 0)
+		return -1;
+	int size = mp_sizeof_uint(IPROTO_SQL_STMT_ID) + mp_sizeof_uint(id);
+	char *pos = (char *) obuf_alloc(out, size);
+	if (pos == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+		obuf_rollback_to_svp(out, &header_svp);
+		return -1;
+	}
+	pos = mp_encode_uint(pos, IPROTO_SQL_STMT_ID);
+	pos = mp_encode_uint(pos, id);
+	iproto_reply_sql(out, &header_svp, request->sync, schema_version, 1);
+	return 0;
+}
+
+int
+sql_prepare_and_execute(const struct sql_request *request, struct obuf *out,
+			struct region *region)
+{
 	sqlite3 *db = sql_get();
 	if (db == NULL) {
 		diag_set(ClientError, ER_LOADING);
 		return -1;
 	}
-	if (sqlite3_prepare_v2(db, sql, len, &stmt, NULL) != SQLITE_OK) {
-		diag_set(ClientError, ER_SQL_EXECUTE, sqlite3_errmsg(db));
-		return -1;
+	struct sql_stmt_entry *entry;
+	struct sqlite3_stmt *stmt;
+	if (request->sql_text != NULL) {
+		const char *sql = request->sql_text;
+		uint32_t len;
+		sql = mp_decode_str(&sql, &len);
+		stmt = sql_stmt_cache_get(sql, len, &entry);
+	} else {
+		stmt = sql_stmt_cache_find(request->stmt_id, &entry);
 	}
-	assert(stmt != NULL);
+	if (stmt == NULL)
+		return -1;
 	if (sql_bind(request, stmt) != 0)
 		goto err_stmt;
 	if (sql_execute_and_encode(db, stmt, out, request->sync,
 				   region) != 0)
 		goto err_stmt;
-	sqlite3_finalize(stmt);
+	sql_stmt_cache_put(stmt, entry);
 	return 0;
 err_stmt:
-	sqlite3_finalize(stmt);
+	sql_stmt_cache_put(stmt, entry);
 	return -1;
 }
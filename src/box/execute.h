@@ -43,11 +43,13 @@ struct region;
 struct sql_bind;
 struct xrow_header;
 
-/** EXECUTE request. */
+/** EXECUTE or PREPARE request. */
 struct sql_request {
 	uint64_t sync;
 	/** SQL statement text. */
 	const char *sql_text;
+	/** Id of a prepared statement, if @sql_text is NULL. */
+	uint32_t stmt_id;
 	/** Array of parameters. */
 	struct sql_bind *bind;
 	/** Length of the @bind. */
@@ -55,7 +57,7 @@ struct sql_request {
 };
 
 /**
- * Parse the EXECUTE request.
+ * Parse the EXECUTE or PREPARE request.
  * @param row Encoded data.
  * @param[out] request Request to decode to.
  * @param region Allocator.
@@ -67,9 +69,25 @@ int
 xrow_decode_sql(const struct xrow_header *row, struct sql_request *request,
 		struct region *region);
 
+/**
+ * Prepare an SQL statement and put it to the statement cache so
+ * that it can be executed by id, and encode the response in an
+ * iproto message.
+ * Response body: {IPROTO_SQL_STMT_ID: number}.
+ *
+ * @param request IProto request.
+ * @param out Out buffer of the iproto message.
+ *
+ * @retval  0 Success.
+ * @retval -1 Client or memory error.
+ */
+int
+sql_prepare(const struct sql_request *request, struct obuf *out);
+
 /**
  * Prepare and execute an SQL statement and encode the response in
- * an iproto message.
+ * an iproto message. The statement is looked up in the statement
+ * cache by text or, if the request has no text, by id.
  * Response structure:
  * +----------------------------------------------+
  * | IPROTO_OK, sync, schema_version   ...        | iproto_header
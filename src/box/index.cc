@@ -38,6 +38,7 @@
 #include "txn.h"
 #include "rmean.h"
 #include "info.h"
+#include "clock.h"
 
 /* {{{ Utilities. **********************************************/
 
@@ -167,10 +168,12 @@ Index::Index(struct index_def *index_def_arg)
 	index_def = index_def_dup(index_def_arg);
 	if (index_def == NULL)
 		diag_raise();
+	latency_stat_create(&latency_stat);
 }
 
 Index::~Index()
 {
+	latency_stat_destroy(&latency_stat);
 	index_def_delete(index_def);
 }
 
@@ -230,6 +233,19 @@ Index::findByKey(const char *key, uint32_t part_count) const
 	return NULL;
 }
 
+void
+Index::findByKeys(const char **keys, uint32_t key_count,
+		  struct tuple **result) const
+{
+	for (uint32_t i = 0; i < key_count; i++) {
+		const char *key = keys[i];
+		uint32_t part_count = mp_decode_array(&key);
+		result[i] = findByKey(key, part_count);
+		if (result[i] != NULL)
+			tuple_ref(result[i]);
+	}
+}
+
 struct tuple *
 Index::findByTuple(struct tuple *tuple) const
 {
@@ -371,6 +387,7 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 {
 	assert(key != NULL && key_end != NULL && result != NULL);
 	mp_tuple_assert(key, key_end);
+	double start = latency_stat_enabled ? clock_monotonic() : 0;
 	try {
 		struct space *space;
 		Index *index = check_index(space_id, index_id, &space);
@@ -388,6 +405,10 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 
 		*result = tuple_bless_null_xc(tuple);
 		txn_commit_ro_stmt(txn);
+		if (start != 0) {
+			space_collect_latency(space_id, index_id,
+					      LATENCY_STAT_SELECT, start);
+		}
 		return 0;
 	}  catch (Exception *) {
 		txn_rollback_stmt();
@@ -395,6 +416,49 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	}
 }
 
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id,
+		   const char **keys, uint32_t key_count,
+		   struct tuple **result)
+{
+	assert(keys != NULL && result != NULL);
+	memset(result, 0, key_count * sizeof(*result));
+	double start = latency_stat_enabled ? clock_monotonic() : 0;
+	try {
+		struct space *space;
+		Index *index = check_index(space_id, index_id, &space);
+		if (!index->index_def->opts.is_unique)
+			tnt_raise(ClientError, ER_MORE_THAN_ONE_TUPLE);
+		for (uint32_t i = 0; i < key_count; i++) {
+			const char *key = keys[i];
+			uint32_t part_count = mp_decode_array(&key);
+			if (primary_key_validate(index->index_def->key_def,
+						 key, part_count))
+				diag_raise();
+		}
+		/* Start transaction in the engine. */
+		struct txn *txn = txn_begin_ro_stmt(space);
+		index->findByKeys(keys, key_count, result);
+		/* Count statistics */
+		rmean_collect(rmean_box, IPROTO_SELECT, key_count);
+		txn_commit_ro_stmt(txn);
+		if (start != 0) {
+			space_collect_latency(space_id, index_id,
+					      LATENCY_STAT_SELECT, start);
+		}
+		return 0;
+	} catch (Exception *) {
+		for (uint32_t i = 0; i < key_count; i++) {
+			if (result[i] != NULL) {
+				tuple_unref(result[i]);
+				result[i] = NULL;
+			}
+		}
+		txn_rollback_stmt();
+		return -1;
+	}
+}
+
 int
 box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result)
@@ -231,9 +231,32 @@ int
 box_index_info(uint32_t space_id, uint32_t index_id,
 	       struct info_handler *info);
 
+/**
+ * Get tuples from a unique index by several keys at once.
+ * Engines may look the keys up concurrently, see
+ * Index::findByKeys().
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys encoded keys in MsgPack Array format
+ * \param key_count number of keys
+ * \param[out] result tuples found by the keys, in the order of
+ *             \a keys, NULL for a missing key. Unlike other box
+ *             functions, the tuples are referenced and must be
+ *             unreferenced by the caller.
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \sa \code box.space[space_id].index[index_id]:get_many(keys) \endcode
+ */
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id,
+		   const char **keys, uint32_t key_count,
+		   struct tuple **result);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #include "key_def.h"
+#include "latency_stat.h"
 
 struct iterator {
 	struct tuple *(*next)(struct iterator *);
@@ -300,6 +323,8 @@ public:
 	struct index_def *index_def;
 	/* Schema version on index construction moment */
 	uint32_t schema_version;
+	/** Latency of requests to the index, box.space.X:stat(). */
+	struct latency_stat latency_stat;
 
 protected:
 	/**
@@ -338,6 +363,16 @@ public:
 	virtual size_t count(enum iterator_type type, const char *key,
 			     uint32_t part_count) const;
 	virtual struct tuple *findByKey(const char *key, uint32_t part_count) const;
+	/**
+	 * Look up several full keys of a unique index. @keys are
+	 * MessagePack arrays. Found tuples are referenced and
+	 * stored in @result in the order of @keys, NULL is stored
+	 * for a missing key. The default implementation calls
+	 * findByKey() for each key. On exception, @result may
+	 * contain some referenced tuples.
+	 */
+	virtual void findByKeys(const char **keys, uint32_t key_count,
+				struct tuple **result) const;
 	virtual struct tuple *findByTuple(struct tuple *tuple) const;
 	virtual struct tuple *replace(struct tuple *old_tuple,
 				      struct tuple *new_tuple,
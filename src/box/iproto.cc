@@ -108,7 +108,8 @@ struct iproto_msg: public cmsg
 	bool close_connection;
 };
 
-static struct mempool iproto_msg_pool;
+/** Messages of the current network thread. */
+static __thread struct mempool iproto_msg_pool;
 
 static struct iproto_msg *
 iproto_msg_new(struct iproto_connection *con)
@@ -137,24 +138,9 @@ iproto_msg_delete(struct cmsg *msg)
 
 /* {{{ iproto connection and requests */
 
-/**
- * A single global queue for all requests in all connections. All
- * requests from all connections are processed concurrently.
- * Is also used as a queue for just established connections and to
- * execute disconnect triggers. A few notes about these triggers:
- * - they need to be run in a fiber
- * - unlike an ordinary request failure, on_connect trigger
- *   failure must lead to connection close.
- * - on_connect trigger must be processed before any other
- *   request on this connection.
- */
-static struct cpipe tx_pipe;
-static struct cpipe net_pipe;
 /* A pointer to the transaction processor cord. */
 struct cord *tx_cord;
 
-struct rmean *rmean_net;
-
 enum rmean_net_name {
 	IPROTO_SENT,
 	IPROTO_RECEIVED,
@@ -163,6 +149,58 @@ enum rmean_net_name {
 
 const char *rmean_net_strings[IPROTO_LAST] = { "SENT", "RECEIVED" };
 
+/**
+ * A network thread. Client connections are spread among
+ * network threads, each serving its connections on its own
+ * event loop and talking to the tx thread over its own pair
+ * of pipes.
+ */
+struct iproto_thread {
+	/** Network thread. */
+	struct cord cord;
+	/** Name of the cbus endpoint of the thread. */
+	char endpoint_name[FIBER_NAME_MAX];
+	/**
+	 * A queue for all requests in all connections of the
+	 * thread. All requests from all connections are processed
+	 * concurrently. Is also used as a queue for just
+	 * established connections and to execute disconnect
+	 * triggers. A few notes about these triggers:
+	 * - they need to be run in a fiber
+	 * - unlike an ordinary request failure, on_connect trigger
+	 *   failure must lead to connection close.
+	 * - on_connect trigger must be processed before any other
+	 *   request on this connection.
+	 */
+	struct cpipe tx_pipe;
+	/** Pipe from the tx thread to the network thread. */
+	struct cpipe net_pipe;
+	/**
+	 * Pipe from the first network thread, which accepts
+	 * connections, to this one.
+	 */
+	struct cpipe accept_pipe;
+	/** Network statistics of the thread. */
+	struct rmean *rmean_net;
+	/* Message routes, all ending in this thread. */
+	struct cmsg_hop disconnect_route[2];
+	struct cmsg_hop misc_route[2];
+	struct cmsg_hop select_route[2];
+	struct cmsg_hop process1_route[2];
+	struct cmsg_hop sql_route[2];
+	struct cmsg_hop sync_route[2];
+	struct cmsg_hop connect_route[2];
+	const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX];
+};
+
+static struct iproto_thread *iproto_threads;
+static int iproto_threads_count;
+/**
+ * The number of messages in flight per network thread,
+ * IPROTO_MSG_MAX split evenly among the threads.
+ */
+static int iproto_thread_msg_max = IPROTO_MSG_MAX;
+
 /**
  * Context of a single client connection.
  * Interaction scheme:
@@ -226,10 +264,13 @@ struct iproto_connection
 	/* Pre-allocated disconnect msg. */
 	struct iproto_msg *disconnect;
 	struct rlist in_stop_list;
+	/** The network thread serving the connection. */
+	struct iproto_thread *iproto_thread;
 };
 
-static struct mempool iproto_connection_pool;
-static RLIST_HEAD(stopped_connections);
+/** Connections of the current network thread. */
+static __thread struct mempool iproto_connection_pool;
+static __thread struct rlist stopped_connections;
 
 /**
  * Return true if we have not enough spare messages
@@ -241,7 +282,7 @@ iproto_must_stop_input()
 {
 	size_t connection_count = mempool_count(&iproto_connection_pool);
 	size_t request_count = mempool_count(&iproto_msg_pool);
-	return request_count > connection_count + IPROTO_MSG_MAX;
+	return request_count > connection_count + iproto_thread_msg_max;
 }
 
 /**
@@ -360,6 +401,11 @@ tx_process_join_subscribe(struct cmsg *msg);
 static void
 net_end_join_subscribe(struct cmsg *msg);
 
+static void
+tx_process_connect(struct cmsg *m);
+static void
+net_send_greeting(struct cmsg *m);
+
 static void
 tx_fiber_init(struct session *session, uint64_t sync)
 {
@@ -416,57 +462,51 @@ net_finish_disconnect(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
-static const struct cmsg_hop disconnect_route[] = {
-	{ tx_process_disconnect, &net_pipe },
-	{ net_finish_disconnect, NULL },
-};
-
-static const struct cmsg_hop misc_route[] = {
-	{ tx_process_misc, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop select_route[] = {
-	{ tx_process_select, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop process1_route[] = {
-	{ tx_process1, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop sql_route[] = {
-	{ tx_process_sql, &net_pipe },
-	{ net_send_msg, NULL },
-};
-
-static const struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX] = {
-	NULL,                                   /* IPROTO_OK */
-	select_route,                           /* IPROTO_SELECT */
-	process1_route,                         /* IPROTO_INSERT */
-	process1_route,                         /* IPROTO_REPLACE */
-	process1_route,                         /* IPROTO_UPDATE */
-	process1_route,                         /* IPROTO_DELETE */
-	misc_route,                             /* IPROTO_CALL_16 */
-	misc_route,                             /* IPROTO_AUTH */
-	misc_route,                             /* IPROTO_EVAL */
-	process1_route,                         /* IPROTO_UPSERT */
-	misc_route,                             /* IPROTO_CALL */
-	sql_route,                              /* IPROTO_EXECUTE */
-};
-
-static const struct cmsg_hop sync_route[] = {
-	{ tx_process_join_subscribe, &net_pipe },
-	{ net_end_join_subscribe, NULL },
-};
+/**
+ * Set up routes of messages served by a network thread.
+ */
+static void
+iproto_thread_init_routes(struct iproto_thread *thread)
+{
+	struct cpipe *net_pipe = &thread->net_pipe;
+
+	thread->disconnect_route[0] = { tx_process_disconnect, net_pipe };
+	thread->disconnect_route[1] = { net_finish_disconnect, NULL };
+	thread->misc_route[0] = { tx_process_misc, net_pipe };
+	thread->misc_route[1] = { net_send_msg, NULL };
+	thread->select_route[0] = { tx_process_select, net_pipe };
+	thread->select_route[1] = { net_send_msg, NULL };
+	thread->process1_route[0] = { tx_process1, net_pipe };
+	thread->process1_route[1] = { net_send_msg, NULL };
+	thread->sql_route[0] = { tx_process_sql, net_pipe };
+	thread->sql_route[1] = { net_send_msg, NULL };
+	thread->sync_route[0] = { tx_process_join_subscribe, net_pipe };
+	thread->sync_route[1] = { net_end_join_subscribe, NULL };
+	thread->connect_route[0] = { tx_process_connect, net_pipe };
+	thread->connect_route[1] = { net_send_greeting, NULL };
+
+	const struct cmsg_hop **dml_route = thread->dml_route;
+	dml_route[IPROTO_OK] = NULL;
+	dml_route[IPROTO_SELECT] = thread->select_route;
+	dml_route[IPROTO_INSERT] = thread->process1_route;
+	dml_route[IPROTO_REPLACE] = thread->process1_route;
+	dml_route[IPROTO_UPDATE] = thread->process1_route;
+	dml_route[IPROTO_DELETE] = thread->process1_route;
+	dml_route[IPROTO_CALL_16] = thread->misc_route;
+	dml_route[IPROTO_AUTH] = thread->misc_route;
+	dml_route[IPROTO_EVAL] = thread->misc_route;
+	dml_route[IPROTO_UPSERT] = thread->process1_route;
+	dml_route[IPROTO_CALL] = thread->misc_route;
+	dml_route[IPROTO_EXECUTE] = thread->sql_route;
+}
 
 static struct iproto_connection *
-iproto_connection_new(const char *name, int fd)
+iproto_connection_new(struct iproto_thread *thread, const char *name, int fd)
 {
 	(void) name;
 	struct iproto_connection *con = (struct iproto_connection *)
 		mempool_alloc_xc(&iproto_connection_pool);
+	con->iproto_thread = thread;
 	con->input.data = con->output.data = con;
 	con->loop = loop();
 	ev_io_init(&con->input, iproto_connection_on_input, fd, EV_READ);
@@ -478,7 +518,7 @@ iproto_connection_new(const char *name, int fd)
 	rlist_create(&con->in_stop_list);
 	/* It may be very awkward to allocate at close. */
 	con->disconnect = iproto_msg_new(con);
-	cmsg_init(con->disconnect, disconnect_route);
+	cmsg_init(con->disconnect, thread->disconnect_route);
 	return con;
 }
 
@@ -523,7 +563,7 @@ iproto_connection_close(struct iproto_connection *con)
 		assert(con->disconnect != NULL);
 		struct iproto_msg *msg = con->disconnect;
 		con->disconnect = NULL;
-		cpipe_push(&tx_pipe, msg);
+		cpipe_push(&con->iproto_thread->tx_pipe, msg);
 	}
 	rlist_del(&con->in_stop_list);
 }
@@ -625,6 +665,7 @@ static void
 iproto_decode_msg(struct iproto_msg *msg, const char **pos, const char *reqend,
 		  bool *stop_input)
 {
+	struct iproto_thread *thread = msg->connection->iproto_thread;
 	xrow_header_decode_xc(&msg->header, pos, reqend);
 	assert(*pos == reqend);
 	uint8_t type = msg->header.type;
@@ -643,31 +684,33 @@ iproto_decode_msg(struct iproto_msg *msg, const char **pos, const char *reqend,
 	case IPROTO_UPSERT:
 		xrow_decode_dml_xc(&msg->header, &msg->dml_request,
 				   dml_request_key_map(type));
-		assert(type < sizeof(dml_route)/sizeof(*dml_route));
-		cmsg_init(msg, dml_route[type]);
+		assert(type < sizeof(thread->dml_route) /
+			      sizeof(*thread->dml_route));
+		cmsg_init(msg, thread->dml_route[type]);
 		break;
 	case IPROTO_CALL_16:
 	case IPROTO_CALL:
 	case IPROTO_EVAL:
 		xrow_decode_call_xc(&msg->header, &msg->call_request);
-		cmsg_init(msg, misc_route);
+		cmsg_init(msg, thread->misc_route);
 		break;
 	case IPROTO_PING:
-		cmsg_init(msg, misc_route);
+		cmsg_init(msg, thread->misc_route);
 		break;
 	case IPROTO_JOIN:
 	case IPROTO_SUBSCRIBE:
-		cmsg_init(msg, sync_route);
+		cmsg_init(msg, thread->sync_route);
 		*stop_input = true;
 		break;
 	case IPROTO_EXECUTE:
+	case IPROTO_PREPARE:
 		xrow_decode_sql_xc(&msg->header, &msg->sql_request,
 				   &fiber()->gc);
-		cmsg_init(msg, sql_route);
+		cmsg_init(msg, thread->sql_route);
 		break;
 	case IPROTO_AUTH:
 		xrow_decode_auth_xc(&msg->header, &msg->auth_request);
-		cmsg_init(msg, misc_route);
+		cmsg_init(msg, thread->misc_route);
 		break;
 	default:
 		tnt_raise(ClientError, ER_UNKNOWN_REQUEST_TYPE,
@@ -681,6 +724,7 @@ iproto_decode_msg(struct iproto_msg *msg, const char **pos, const char *reqend,
 static inline void
 iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 {
+	struct cpipe *tx_pipe = &con->iproto_thread->tx_pipe;
 	int n_requests = 0;
 	bool stop_input = false;
 	while (con->parse_size && stop_input == false) {
@@ -709,7 +753,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 			 * This can't throw, but should not be
 			 * done in case of exception.
 			 */
-			cpipe_push_input(&tx_pipe, msg);
+			cpipe_push_input(tx_pipe, msg);
 			guard.is_active = false;
 			n_requests++;
 		} catch (Exception *e) {
@@ -775,7 +819,7 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		 */
 		ev_feed_event(con->loop, &con->input, EV_READ);
 	}
-	cpipe_flush_input(&tx_pipe);
+	cpipe_flush_input(tx_pipe);
 }
 
 static void
@@ -828,7 +872,8 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			return;
 		}
 		/* Count statistics */
-		rmean_collect(rmean_net, IPROTO_RECEIVED, nrd);
+		rmean_collect(con->iproto_thread->rmean_net,
+			      IPROTO_RECEIVED, nrd);
 
 		/* Update the read position and connection state. */
 		in->wpos += nrd;
@@ -885,7 +930,7 @@ iproto_flush(struct iobuf *iobuf, struct iproto_connection *con)
 	ssize_t nwr = sio_writev(fd, iov, iovcnt);
 
 	/* Count statistics */
-	rmean_collect(rmean_net, IPROTO_SENT, nwr);
+	rmean_collect(con->iproto_thread->rmean_net, IPROTO_SENT, nwr);
 	if (nwr > 0) {
 		if (begin->used + nwr == end->used) {
 			if (ibuf_used(&iobuf->in) == 0) {
@@ -1066,9 +1111,15 @@ tx_process_sql(struct cmsg *m)
 
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
-	assert(msg->header.type == IPROTO_EXECUTE);
-	if (sql_prepare_and_execute(&msg->sql_request, out,
-				    &fiber()->gc) == 0) {
+	int rc;
+	if (msg->header.type == IPROTO_PREPARE) {
+		rc = sql_prepare(&msg->sql_request, out);
+	} else {
+		assert(msg->header.type == IPROTO_EXECUTE);
+		rc = sql_prepare_and_execute(&msg->sql_request, out,
+					     &fiber()->gc);
+	}
+	if (rc == 0) {
 		msg->write_end = obuf_create_svp(out);
 		return;
 	}
@@ -1202,7 +1253,8 @@ net_send_greeting(struct cmsg *m)
 						 obuf_iovcnt(out));
 
 			/* Count statistics */
-			rmean_collect(rmean_net, IPROTO_SENT, nwr);
+			rmean_collect(con->iproto_thread->rmean_net,
+				      IPROTO_SENT, nwr);
 		} catch (Exception *e) {
 			e->log();
 		}
@@ -1223,37 +1275,92 @@ net_send_greeting(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
-static const struct cmsg_hop connect_route[] = {
-	{ tx_process_connect, &net_pipe },
-	{ net_send_greeting, NULL },
-};
-
 /** }}} */
 
 /**
- * Create a connection and start input.
+ * Create a connection served by the given network thread
+ * and start input.
  */
 static void
-iproto_on_accept(struct evio_service * /* service */, int fd,
-		 struct sockaddr *addr, socklen_t addrlen)
+iproto_connection_accept(struct iproto_thread *thread,
+			 const char *name, int fd)
 {
-	char name[SERVICE_NAME_MAXLEN];
-	snprintf(name, sizeof(name), "%s/%s", "iobuf",
-		sio_strfaddr(addr, addrlen));
-
 	struct iproto_connection *con;
 
-	con = iproto_connection_new(name, fd);
+	con = iproto_connection_new(thread, name, fd);
 	/*
 	 * Ignore msg allocation failure - the queue size is
 	 * fixed so there is a limited number of msgs in
 	 * use, all stored in just a few blocks of the memory pool.
 	 */
 	struct iproto_msg *msg = iproto_msg_new(con);
-	cmsg_init(msg, connect_route);
+	cmsg_init(msg, thread->connect_route);
 	msg->iobuf = con->iobuf[0];
 	msg->close_connection = false;
-	cpipe_push(&tx_pipe, msg);
+	cpipe_push(&thread->tx_pipe, msg);
+}
+
+/**
+ * A message passing an accepted socket from the first
+ * network thread to the thread which is to serve it.
+ */
+struct iproto_accept_msg: public cmsg
+{
+	struct iproto_thread *iproto_thread;
+	int fd;
+	char name[SERVICE_NAME_MAXLEN];
+};
+
+static void
+net_accept(struct cmsg *m)
+{
+	struct iproto_accept_msg *msg = (struct iproto_accept_msg *) m;
+	try {
+		iproto_connection_accept(msg->iproto_thread, msg->name,
+					 msg->fd);
+	} catch (Exception *e) {
+		close(msg->fd);
+		e->log();
+	}
+	free(msg);
+}
+
+static const struct cmsg_hop accept_route[] = {
+	{ net_accept, NULL },
+};
+
+/** The thread to serve the next accepted connection. */
+static int iproto_next_thread;
+
+/**
+ * Accept a connection and pass it to one of the network
+ * threads, round-robin.
+ */
+static void
+iproto_on_accept(struct evio_service * /* service */, int fd,
+		 struct sockaddr *addr, socklen_t addrlen)
+{
+	char name[SERVICE_NAME_MAXLEN];
+	snprintf(name, sizeof(name), "%s/%s", "iobuf",
+		sio_strfaddr(addr, addrlen));
+
+	struct iproto_thread *thread = &iproto_threads[iproto_next_thread];
+	iproto_next_thread = (iproto_next_thread + 1) % iproto_threads_count;
+	if (thread == &iproto_threads[0]) {
+		iproto_connection_accept(thread, name, fd);
+		return;
+	}
+	struct iproto_accept_msg *msg = (struct iproto_accept_msg *)
+		malloc(sizeof(*msg));
+	if (msg == NULL) {
+		tnt_raise(OutOfMemory, sizeof(*msg), "malloc",
+			  "struct iproto_accept_msg");
+	}
+	cmsg_init(msg, accept_route);
+	msg->iproto_thread = thread;
+	msg->fd = fd;
+	snprintf(msg->name, sizeof(msg->name), "%s", name);
+	cpipe_push(&thread->accept_pipe, msg);
 }
 
 static struct evio_service binary; /* iproto binary listener */
@@ -1263,62 +1370,114 @@ static struct evio_service binary; /* iproto binary listener */
  * begin serving the message bus.
  */
 static int
-net_cord_f(va_list /* ap */)
+net_cord_f(va_list ap)
 {
+	struct iproto_thread *thread = va_arg(ap, struct iproto_thread *);
+	/* Only the first thread accepts connections. */
+	bool is_acceptor = (thread == &iproto_threads[0]);
+
 	/* Got to be called in every thread using iobuf */
 	iobuf_init();
 	mempool_create(&iproto_msg_pool, &cord()->slabc,
 		       sizeof(struct iproto_msg));
 	mempool_create(&iproto_connection_pool, &cord()->slabc,
 		       sizeof(struct iproto_connection));
+	rlist_create(&stopped_connections);
 
-	evio_service_init(loop(), &binary, "binary",
-			  iproto_on_accept, NULL);
+	if (is_acceptor) {
+		evio_service_init(loop(), &binary, "binary",
+				  iproto_on_accept, NULL);
+	}
 
 
 	/* Init statistics counter */
-	rmean_net = rmean_new(rmean_net_strings, IPROTO_LAST);
+	thread->rmean_net = rmean_new(rmean_net_strings, IPROTO_LAST);
 
-	if (rmean_net == NULL) {
+	if (thread->rmean_net == NULL) {
 		tnt_raise(OutOfMemory, sizeof(struct rmean),
 			  "rmean", "struct rmean");
 	}
 
 	struct cbus_endpoint endpoint;
 	/* Create "net" endpoint. */
-	cbus_endpoint_create(&endpoint, "net", fiber_schedule_cb, fiber());
+	cbus_endpoint_create(&endpoint, thread->endpoint_name,
+			     fiber_schedule_cb, fiber());
 	/* Create a pipe to "tx" thread. */
-	cpipe_create(&tx_pipe, "tx");
-	cpipe_set_max_input(&tx_pipe, IPROTO_MSG_MAX/2);
+	cpipe_create(&thread->tx_pipe, "tx");
+	cpipe_set_max_input(&thread->tx_pipe, iproto_thread_msg_max/2);
+	cpipe_set_adaptive_max_input(&thread->tx_pipe, iproto_thread_msg_max);
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
-	cpipe_destroy(&tx_pipe);
+	cpipe_destroy(&thread->tx_pipe);
 	/*
 	 * Nothing to do in the fiber so far, the service
 	 * will take care of creating events for incoming
 	 * connections.
 	 */
-	if (evio_service_is_active(&binary))
+	if (is_acceptor && evio_service_is_active(&binary))
 		evio_service_stop(&binary);
 
-	rmean_delete(rmean_net);
+	rmean_delete(thread->rmean_net);
 	return 0;
 }
 
-/** Initialize the iproto subsystem and start network io thread */
+/** Initialize the iproto subsystem and start network io threads */
 void
-iproto_init()
+iproto_init(int threads)
 {
+	assert(threads > 0 && threads <= IPROTO_THREADS_MAX);
 	tx_cord = cord();
 
-	static struct cord net_cord;
-	if (cord_costart(&net_cord, "iproto", net_cord_f, NULL))
-		panic("failed to initialize iproto thread");
+	iproto_threads = (struct iproto_thread *)
+		calloc(threads, sizeof(*iproto_threads));
+	if (iproto_threads == NULL)
+		panic("failed to allocate iproto threads");
+	iproto_threads_count = threads;
+	iproto_thread_msg_max = IPROTO_MSG_MAX / threads;
+
+	for (int i = 0; i < threads; i++) {
+		struct iproto_thread *thread = &iproto_threads[i];
+		char name[FIBER_NAME_MAX];
+
+		if (i == 0) {
+			snprintf(name, sizeof(name), "iproto");
+			snprintf(thread->endpoint_name,
+				 sizeof(thread->endpoint_name), "net");
+		} else {
+			snprintf(name, sizeof(name), "iproto.%d", i);
+			snprintf(thread->endpoint_name,
+				 sizeof(thread->endpoint_name), "net.%d", i);
+		}
+		iproto_thread_init_routes(thread);
+		if (cord_costart(&thread->cord, name, net_cord_f, thread))
+			panic("failed to initialize iproto thread");
+
+		/* Create a pipe to "net" thread. */
+		cpipe_create(&thread->net_pipe, thread->endpoint_name);
+		cpipe_set_max_input(&thread->net_pipe,
+				    iproto_thread_msg_max/2);
+		cpipe_set_adaptive_max_input(&thread->net_pipe,
+					     iproto_thread_msg_max);
+	}
+}
 
-	/* Create a pipe to "net" thread. */
-	cpipe_create(&net_pipe, "net");
-	cpipe_set_max_input(&net_pipe, IPROTO_MSG_MAX/2);
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx)
+{
+	for (size_t i = 0; i < IPROTO_LAST; i++) {
+		int64_t rps = 0;
+		int64_t total = 0;
+		for (int j = 0; j < iproto_threads_count; j++) {
+			struct rmean *rmean = iproto_threads[j].rmean_net;
+			rps += rmean_mean(rmean, i);
+			total += rmean_total(rmean, i);
+		}
+		int rc = cb(rmean_net_strings[i], rps, total, cb_ctx);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
 }
 
 /**
@@ -1347,10 +1506,29 @@ iproto_do_bind(struct cbus_call_msg *m)
 	return 0;
 }
 
+/**
+ * Connect the first network thread, which accepts connections,
+ * to the other ones. Can't be done on thread start, since the
+ * other threads don't exist yet.
+ */
+static void
+iproto_create_accept_pipes()
+{
+	static bool is_created = false;
+	if (is_created)
+		return;
+	for (int i = 1; i < iproto_threads_count; i++) {
+		struct iproto_thread *thread = &iproto_threads[i];
+		cpipe_create(&thread->accept_pipe, thread->endpoint_name);
+	}
+	is_created = true;
+}
+
 static int
 iproto_do_listen(struct cbus_call_msg *m)
 {
 	(void) m;
+	iproto_create_accept_pipes();
 	try {
 		if (evio_service_is_active(&binary))
 			evio_service_listen(&binary);
@@ -1365,8 +1543,9 @@ iproto_bind(const char *uri)
 {
 	static struct iproto_bind_msg m;
 	m.uri = uri;
-	if (cbus_call(&net_pipe, &tx_pipe, &m, iproto_do_bind,
-		      NULL, TIMEOUT_INFINITY))
+	struct iproto_thread *thread = &iproto_threads[0];
+	if (cbus_call(&thread->net_pipe, &thread->tx_pipe, &m,
+		      iproto_do_bind, NULL, TIMEOUT_INFINITY))
 		diag_raise();
 }
 
@@ -1375,8 +1554,9 @@ iproto_listen()
 {
 	/* Declare static to avoid stack corruption on fiber cancel. */
 	static struct cbus_call_msg m;
-	if (cbus_call(&net_pipe, &tx_pipe, &m, iproto_do_listen,
-		      NULL, TIMEOUT_INFINITY))
+	struct iproto_thread *thread = &iproto_threads[0];
+	if (cbus_call(&thread->net_pipe, &thread->tx_pipe, &m,
+		      iproto_do_listen, NULL, TIMEOUT_INFINITY))
 		diag_raise();
 }
 
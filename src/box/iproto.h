@@ -30,8 +30,31 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include "rmean.h"
+
+enum {
+	/** Maximal number of network threads. */
+	IPROTO_THREADS_MAX = 32,
+};
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Invoke the callback for each network statistics counter,
+ * summed up over all network threads.
+ */
+int
+iproto_rmean_foreach(rmean_cb cb, void *cb_ctx);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+/** Start the given number of network threads. */
 void
-iproto_init();
+iproto_init(int threads);
 
 void
 iproto_bind(const char *uri);
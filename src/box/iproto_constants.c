@@ -87,6 +87,8 @@ const unsigned char iproto_key_type[IPROTO_KEY_MAX] =
 	/* 0x27 */	MP_STR, /* IPROTO_EXPR */
 	/* 0x28 */	MP_ARRAY, /* IPROTO_OPS */
 	/* 0x29 */	MP_STR, /* IPROTO_FIELD_NAME */
+	/* 0x2a */	MP_BOOL, /* IPROTO_COMPRESSION */
+	/* 0x2b */	MP_ARRAY, /* IPROTO_JOIN_PART */
 	/* }}} */
 };
 
@@ -164,8 +166,8 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"expression",       /* 0x27 */
 	"operations",       /* 0x28 */
 	"field name",       /* 0x29 */
-	NULL,               /* 0x2a */
-	NULL,               /* 0x2b */
+	"compression",      /* 0x2a */
+	"join part",        /* 0x2b */
 	NULL,               /* 0x2c */
 	NULL,               /* 0x2d */
 	NULL,               /* 0x2e */
@@ -191,6 +193,7 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"SQL options",      /* 0x42 */
 	"SQL info",         /* 0x43 */
 	"SQL row count",    /* 0x44 */
+	"SQL statement id", /* 0x45 */
 };
 
 const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
@@ -200,7 +203,8 @@ const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
 	"unpacked size",
 	"row count",
 	"min key",
-	"row index offset"
+	"row index offset",
+	"bloom",
 };
 
 const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
@@ -210,7 +214,8 @@ const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
 	"min lsn",
 	"max lsn",
 	"page count",
-	"bloom filter"
+	"bloom filter",
+	"dictionary",
 };
 
 const char *vy_row_index_key_strs[VY_ROW_INDEX_KEY_MAX] = {
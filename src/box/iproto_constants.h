@@ -88,6 +88,10 @@ enum iproto_key {
 	IPROTO_EXPR = 0x27, /* EVAL */
 	IPROTO_OPS = 0x28, /* UPSERT but not UPDATE ops, because of legacy */
 	IPROTO_FIELD_NAME = 0x29,
+	/* JOIN and SUBSCRIBE: compress the replication stream. */
+	IPROTO_COMPRESSION = 0x2a,
+	/* JOIN: part of the initial data to send, see join_part. */
+	IPROTO_JOIN_PART = 0x2b,
 
 	/* Leave a gap between request keys and response keys */
 	IPROTO_DATA = 0x30,
@@ -112,6 +116,8 @@ enum iproto_key {
 	 */
 	IPROTO_SQL_INFO = 0x43,
 	IPROTO_SQL_ROW_COUNT = 0x44,
+	/** Id of a prepared SQL statement. */
+	IPROTO_SQL_STMT_ID = 0x45,
 	IPROTO_KEY_MAX
 };
 
@@ -178,6 +184,8 @@ enum iproto_type {
 	IPROTO_EXECUTE = 11,
 	/** The maximum typecode used for box.stat() */
 	IPROTO_TYPE_STAT_MAX,
+	/** Prepare an SQL statement for execution by id. */
+	IPROTO_PREPARE = 13,
 
 	/** PING request */
 	IPROTO_PING = 64,
@@ -213,6 +221,8 @@ iproto_type_name(uint32_t type)
 		return iproto_type_strs[type];
 
 	switch (type) {
+	case IPROTO_PREPARE:
+		return "PREPARE";
 	case VY_INDEX_RUN_INFO:
 		return "RUNINFO";
 	case VY_INDEX_PAGE_INFO:
@@ -320,6 +330,8 @@ enum vy_run_info_key {
 	VY_RUN_INFO_PAGE_COUNT = 5,
 	/** Bloom filter for keys. */
 	VY_RUN_INFO_BLOOM = 6,
+	/** zstd dictionary pages are compressed with. */
+	VY_RUN_INFO_DICT = 7,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
@@ -354,6 +366,8 @@ enum vy_page_info_key {
 	VY_PAGE_INFO_MIN_KEY = 5,
 	/** Offset of the row index in the page. */
 	VY_PAGE_INFO_ROW_INDEX_OFFSET = 6,
+	/** Bloom filter of keys stored in the page, optional. */
+	VY_PAGE_INFO_BLOOM = 7,
 	/** The last key in this enum + 1 */
 	VY_PAGE_INFO_KEY_MAX
 };
@@ -89,6 +89,8 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *index_compaction_policy_strs[] = { "tiered", "leveled" };
+
 const char *func_language_strs[] = {"LUA", "C"};
 
 const uint32_t key_mp_type[] = {
@@ -120,7 +122,12 @@ const struct index_opts index_opts_default = {
 	/* .page_size           = */ 0,
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
+	/* .compactionbuf       = */ { '\0' },
+	/* .compaction          = */ INDEX_COMPACTION_TIERED,
 	/* .bloom_fpr           = */ 0.05,
+	/* .page_bloom          = */ false,
+	/* .compression_dict_size = */ 0,
+	/* .hint                = */ false,
 	/* .lsn                 = */ 0,
 	/* .sql                 = */ NULL,
 };
@@ -133,7 +140,12 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("page_size", OPT_INT, struct index_opts, page_size),
 	OPT_DEF("run_count_per_level", OPT_INT, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
+	OPT_DEF("compaction", OPT_STR, struct index_opts, compactionbuf),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF("page_bloom", OPT_BOOL, struct index_opts, page_bloom),
+	OPT_DEF("compression_dict_size", OPT_INT, struct index_opts,
+		compression_dict_size),
+	OPT_DEF("hint", OPT_BOOL, struct index_opts, hint),
 	OPT_DEF("lsn", OPT_INT, struct index_opts, lsn),
 	OPT_DEF("sql", OPT_STRPTR, struct index_opts, sql),
 	{ NULL, opt_type_MAX, 0, 0 },
@@ -372,6 +384,9 @@ index_def_change_requires_rebuild(struct index_def *old_index_def,
 			 new_index_def->key_def->part_count) != 0) {
 		return true;
 	}
+	if (old_index_def->type == TREE &&
+	    old_index_def->opts.hint != new_index_def->opts.hint)
+		return true;
 	if (old_index_def->type == RTREE) {
 		if (old_index_def->opts.dimension != new_index_def->opts.dimension
 		    || old_index_def->opts.distance != new_index_def->opts.distance)
@@ -174,6 +174,22 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** Vinyl compaction policy, see vy_range_update_compact_priority(). */
+enum index_compaction_policy {
+	/*
+	 * Allow up to run_count_per_level runs per level,
+	 * write-optimized.
+	 */
+	INDEX_COMPACTION_TIERED,
+	/*
+	 * Keep each run run_size_ratio times bigger than all
+	 * newer runs together, read-optimized.
+	 */
+	INDEX_COMPACTION_LEVELED,
+	index_compaction_policy_MAX
+};
+extern const char *index_compaction_policy_strs[];
+
 /** Descriptor of a single part in a multipart key. */
 struct key_part {
 	uint32_t fieldno;
@@ -212,8 +228,29 @@ struct index_opts {
 	 * previous one.
 	 */
 	double run_size_ratio;
+	/**
+	 * Vinyl compaction policy.
+	 */
+	char compactionbuf[16];
+	enum index_compaction_policy compaction;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Store a bloom filter for each page of a vinyl run
+	 * in addition to the one for the whole run.
+	 */
+	bool page_bloom;
+	/**
+	 * Size of the zstd dictionary trained on each dump of
+	 * a vinyl index to compress run pages with, 0 if pages
+	 * are compressed without a dictionary.
+	 */
+	int64_t compression_dict_size;
+	/**
+	 * Store a hint of the first key part next to each
+	 * tuple in a memtx TREE index, see memtx_tree.h.
+	 */
+	bool hint;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -245,8 +282,17 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		       -1 : 1;
 	if (o1->run_size_ratio != o2->run_size_ratio)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
+	if (o1->compaction != o2->compaction)
+		return o1->compaction < o2->compaction ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->page_bloom != o2->page_bloom)
+		return o1->page_bloom < o2->page_bloom ? -1 : 1;
+	if (o1->compression_dict_size != o2->compression_dict_size)
+		return o1->compression_dict_size <
+		       o2->compression_dict_size ? -1 : 1;
+	if (o1->hint != o2->hint)
+		return o1->hint < o2->hint ? -1 : 1;
 	return 0;
 }
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "latency_stat.h"
+
+#include "histogram.h"
+#include "info.h"
+
+const char *latency_stat_op_strs[] = {
+	"select",
+	"insert",
+	"replace",
+	"update",
+	"upsert",
+	"delete",
+};
+
+bool latency_stat_enabled;
+
+void
+latency_stat_destroy(struct latency_stat *stat)
+{
+	for (int op = 0; op < latency_stat_op_MAX; op++) {
+		if (stat->latency[op].histogram != NULL)
+			latency_destroy(&stat->latency[op]);
+	}
+}
+
+void
+latency_stat_swap(struct latency_stat *a, struct latency_stat *b)
+{
+	struct latency_stat tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+bool
+latency_stat_is_empty(const struct latency_stat *stat)
+{
+	for (int op = 0; op < latency_stat_op_MAX; op++) {
+		if (stat->count[op] > 0)
+			return false;
+	}
+	return true;
+}
+
+void
+latency_stat_collect(struct latency_stat *stat, enum latency_stat_op op,
+		     double value)
+{
+	struct latency *latency = &stat->latency[op];
+	if (latency->histogram == NULL && latency_create(latency) != 0)
+		return;
+	latency_collect(latency, value);
+	stat->count[op]++;
+}
+
+void
+latency_stat_info(const struct latency_stat *stat, struct info_handler *h)
+{
+	for (int op = 0; op < latency_stat_op_MAX; op++) {
+		if (stat->count[op] == 0)
+			continue;
+		struct latency *latency = (struct latency *)&stat->latency[op];
+		info_table_begin(h, latency_stat_op_strs[op]);
+		info_append_double(h, "p50",
+				   latency_get_percentile(latency, 50));
+		info_append_double(h, "p90",
+				   latency_get_percentile(latency, 90));
+		info_append_double(h, "p99",
+				   latency_get_percentile(latency, 99));
+		info_append_double(h, "p999",
+				   latency_get_percentile(latency, 99.9));
+		info_append_int(h, "count", stat->count[op]);
+		info_table_end(h);
+	}
+}
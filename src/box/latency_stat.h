@@ -0,0 +1,120 @@
+#ifndef INCLUDES_TARANTOOL_BOX_LATENCY_STAT_H
+#define INCLUDES_TARANTOOL_BOX_LATENCY_STAT_H
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "latency.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct info_handler;
+
+/** Operations latency is collected for. */
+enum latency_stat_op {
+	LATENCY_STAT_SELECT,
+	LATENCY_STAT_INSERT,
+	LATENCY_STAT_REPLACE,
+	LATENCY_STAT_UPDATE,
+	LATENCY_STAT_UPSERT,
+	LATENCY_STAT_DELETE,
+	latency_stat_op_MAX
+};
+
+/** Lua names of latency_stat_op, e.g. "select". */
+extern const char *latency_stat_op_strs[];
+
+/**
+ * Set if latency of requests should be collected,
+ * box.cfg.latency_stat.
+ */
+extern bool latency_stat_enabled;
+
+/**
+ * Latency of requests to a space or an index, broken down
+ * by operation type.
+ */
+struct latency_stat {
+	/**
+	 * Latency histograms. A histogram is allocated on
+	 * the first observation so that spaces and indexes
+	 * which are never accessed with statistics enabled
+	 * don't waste memory.
+	 */
+	struct latency latency[latency_stat_op_MAX];
+	/** Number of observations, per operation. */
+	int64_t count[latency_stat_op_MAX];
+};
+
+static inline void
+latency_stat_create(struct latency_stat *stat)
+{
+	memset(stat, 0, sizeof(*stat));
+}
+
+void
+latency_stat_destroy(struct latency_stat *stat);
+
+/** Exchange contents of two latency statistics objects. */
+void
+latency_stat_swap(struct latency_stat *a, struct latency_stat *b);
+
+/** Return true if no observation has been collected. */
+bool
+latency_stat_is_empty(const struct latency_stat *stat);
+
+/**
+ * Account an operation of type @op which took @value seconds.
+ * Observations which we fail to allocate a histogram for are
+ * silently dropped.
+ */
+void
+latency_stat_collect(struct latency_stat *stat, enum latency_stat_op op,
+		     double value);
+
+/**
+ * Append a table with p50, p90, p99, p999 (in seconds) and
+ * count for each operation observed at least once to the
+ * current table of @h.
+ */
+void
+latency_stat_info(const struct latency_stat *stat, struct info_handler *h);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* INCLUDES_TARANTOOL_BOX_LATENCY_STAT_H */
@@ -36,6 +36,8 @@
 #include "box/lua/info.h"
 #include "box/lua/tuple.h"
 #include "box/lua/misc.h" /* lbox_encode_tuple_on_gc() */
+#include "box/tuple.h"
+#include "fiber.h"
 
 /** {{{ box.index Lua library: access to spaces and indexes
  */
@@ -169,6 +171,50 @@ lbox_index_get(lua_State *L)
 	return luaT_pushtupleornil(L, tuple);
 }
 
+static int
+lbox_index_get_many(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) || lua_type(L, 3) != LUA_TTABLE)
+		return luaL_error(L, "Usage index.get_many(space_id, "
+				  "index_id, keys)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	uint32_t key_count = lua_objlen(L, 3);
+	if (key_count == 0) {
+		lua_newtable(L);
+		return 1;
+	}
+	struct region *gc = &fiber()->gc;
+	const char **keys = region_alloc(gc, key_count * sizeof(*keys));
+	struct tuple **result = region_alloc(gc, key_count * sizeof(*result));
+	if (keys == NULL || result == NULL) {
+		diag_set(OutOfMemory, key_count * sizeof(*keys),
+			 "region", "keys");
+		return luaT_error(L);
+	}
+	for (uint32_t i = 0; i < key_count; i++) {
+		lua_rawgeti(L, 3, i + 1);
+		size_t key_len;
+		keys[i] = lbox_encode_tuple_on_gc(L, -1, &key_len);
+		lua_pop(L, 1);
+	}
+
+	if (box_index_get_many(space_id, index_id, keys, key_count,
+			       result) != 0)
+		return luaT_error(L);
+	lua_createtable(L, key_count, 0);
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (result[i] == NULL)
+			continue;
+		luaT_pushtuple(L, result[i]);
+		lua_rawseti(L, -2, i + 1);
+		tuple_unref(result[i]);
+	}
+	return 1;
+}
+
 static int
 lbox_index_min(lua_State *L)
 {
@@ -314,6 +360,21 @@ lbox_index_info(lua_State *L)
 	return 1;
 }
 
+static int
+lbox_space_stat(lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_isnumber(L, 1))
+		return luaL_error(L, "usage space.stat(space_id)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	if (box_space_stat(space_id, &info) != 0)
+		return luaT_error(L);
+	return 1;
+}
+
 /* }}} */
 
 void
@@ -343,6 +404,7 @@ box_lua_index_init(struct lua_State *L)
 		{"delete",  lbox_index_delete},
 		{"random", lbox_index_random},
 		{"get",  lbox_index_get},
+		{"get_many", lbox_index_get_many},
 		{"min", lbox_index_min},
 		{"max", lbox_index_max},
 		{"count", lbox_index_count},
@@ -350,6 +412,7 @@ box_lua_index_init(struct lua_State *L)
 		{"iterator_next", lbox_iterator_next},
 		{"truncate", lbox_truncate},
 		{"info", lbox_index_info},
+		{"stat", lbox_space_stat},
 		{NULL, NULL}
 	};
 
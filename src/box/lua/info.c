@@ -67,6 +67,26 @@ lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
 	luaL_setmaphint(L, -1); /* compact flow */
 }
 
+/**
+ * Push statistics of a compressed replication stream:
+ * the ratio of the size of rows to the size of data sent
+ * over the network and CPU time spent on (de)compression.
+ */
+static void
+lbox_pushcompression(lua_State *L, int64_t raw_bytes, int64_t bytes,
+		     double time)
+{
+	lua_newtable(L);
+
+	lua_pushstring(L, "ratio");
+	lua_pushnumber(L, bytes > 0 ? (double) raw_bytes / bytes : 1.0);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "time");
+	lua_pushnumber(L, time);
+	lua_settable(L, -3);
+}
+
 static void
 lbox_pushapplier(lua_State *L, struct applier *applier)
 {
@@ -91,6 +111,18 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 		lua_pushnumber(L, ev_now(loop()) - applier->last_row_time);
 		lua_settable(L, -3);
 
+		lua_pushstring(L, "queue");
+		lua_pushinteger(L, applier->queue_len);
+		lua_settable(L, -3);
+
+		if (applier_compression) {
+			lua_pushstring(L, "compression");
+			lbox_pushcompression(L, applier->tx_raw_bytes,
+					     applier->tx_bytes,
+					     applier->decompress_time);
+			lua_settable(L, -3);
+		}
+
 		struct error *e = diag_last_error(&applier->reader->diag);
 		if (e != NULL) {
 			lua_pushstring(L, "message");
@@ -107,6 +139,26 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 	lua_pushstring(L, "vclock");
 	lbox_pushvclock(L, relay_vclock(relay));
 	lua_settable(L, -3);
+
+	const struct relay_stat *stat = relay_stat(relay);
+	lua_pushstring(L, "rows");
+	luaL_pushint64(L, stat->rows);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "bytes");
+	luaL_pushint64(L, stat->bytes);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "writes");
+	luaL_pushint64(L, stat->writes);
+	lua_settable(L, -3);
+
+	if (relay_is_compressed(relay)) {
+		lua_pushstring(L, "compression");
+		lbox_pushcompression(L, stat->raw_bytes, stat->bytes,
+				     stat->compress_time);
+		lua_settable(L, -3);
+	}
 }
 
 static void
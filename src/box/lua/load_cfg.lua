@@ -12,20 +12,30 @@ local default_cfg = {
     memtx_memory        = 256 * 1024 *1024,
     memtx_min_tuple_size = 16,
     memtx_max_tuple_size = 1024 * 1024,
+    memtx_checkpoint_threads = 1,
+    memtx_recovery_threads = 1,
     slab_alloc_factor   = 1.1,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
 
     vinyl_dir           = '.',
+    vinyl_tiers         = nil,
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
+    vinyl_readahead     = 0,
+    vinyl_readahead_memory = 16 * 1024 * 1024,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
+    vinyl_aio_queue_depth = 0,
     vinyl_write_threads = 2,
+    vinyl_compaction_threads = 1,
     vinyl_timeout       = 60,
+    vinyl_throttling    = false,
     vinyl_run_count_per_level = 2,
     vinyl_run_size_ratio      = 3.5,
+    vinyl_compaction          = 'tiered',
     vinyl_range_size          = 1024 * 1024 * 1024,
     vinyl_page_size           = 8 * 1024,
     vinyl_bloom_fpr           = 0.05,
@@ -34,14 +44,25 @@ local default_cfg = {
     log_level           = 5,
     io_collect_interval = nil,
     readahead           = 16320,
+    iproto_threads      = 1,
     snap_io_rate_limit  = nil, -- no limit
     too_long_threshold  = 0.5,
+    latency_stat        = false,
+    sql_stmt_cache_size = 100,
     wal_mode            = "write",
     rows_per_wal        = 500000,
     wal_max_size        = 256 * 1024 * 1024,
+    wal_commit_delay    = 0,
+    wal_commit_max_txns = 1024,
+    wal_commit_max_size = 1024 * 1024,
+    wal_preallocate     = false,
+    wal_recovery_threads = 1,
     wal_dir_rescan_delay= 2,
     force_recovery      = false,
     replication         = nil,
+    replication_apply_fibers = 1,
+    replication_compression = false,
+    replication_join_connections = 1,
     custom_proc_title   = nil,
     pid_file            = nil,
     background          = false,
@@ -60,19 +81,29 @@ local template_cfg = {
     memtx_memory        = 'number',
     memtx_min_tuple_size  = 'number',
     memtx_max_tuple_size  = 'number',
+    memtx_checkpoint_threads = 'number',
+    memtx_recovery_threads = 'number',
     slab_alloc_factor   = 'number',
     work_dir            = 'string',
     memtx_dir            = 'string',
     wal_dir             = 'string',
     vinyl_dir           = 'string',
+    vinyl_tiers         = 'string, table',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_readahead           = 'number',
+    vinyl_readahead_memory    = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
+    vinyl_aio_queue_depth     = 'number',
     vinyl_write_threads       = 'number',
+    vinyl_compaction_threads  = 'number',
     vinyl_timeout             = 'number',
+    vinyl_throttling          = 'boolean',
     vinyl_run_count_per_level = 'number',
     vinyl_run_size_ratio      = 'number',
+    vinyl_compaction          = 'string',
     vinyl_range_size          = 'number',
     vinyl_page_size           = 'number',
     vinyl_bloom_fpr           = 'number',
@@ -82,14 +113,25 @@ local template_cfg = {
     log_level           = 'number',
     io_collect_interval = 'number',
     readahead           = 'number',
+    iproto_threads      = 'number',
     snap_io_rate_limit  = 'number',
     too_long_threshold  = 'number',
+    latency_stat        = 'boolean',
+    sql_stmt_cache_size = 'number',
     wal_mode            = 'string',
     rows_per_wal        = 'number',
     wal_max_size        = 'number',
+    wal_commit_delay    = 'number',
+    wal_commit_max_txns = 'number',
+    wal_commit_max_size = 'number',
+    wal_preallocate     = 'boolean',
+    wal_recovery_threads = 'number',
     wal_dir_rescan_delay= 'number',
     force_recovery      = 'boolean',
     replication         = 'string, number, table',
+    replication_apply_fibers = 'number',
+    replication_compression = 'boolean',
+    replication_join_connections = 'number',
     custom_proc_title   = 'string',
     pid_file            = 'string',
     background          = 'boolean',
@@ -149,9 +191,16 @@ local dynamic_cfg = {
     io_collect_interval     = private.cfg_set_io_collect_interval,
     readahead               = private.cfg_set_readahead,
     too_long_threshold      = private.cfg_set_too_long_threshold,
+    latency_stat            = private.cfg_set_latency_stat,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
+    memtx_checkpoint_threads = private.cfg_set_memtx_checkpoint_threads,
+    sql_stmt_cache_size     = private.cfg_set_sql_stmt_cache_size,
     read_only               = private.cfg_set_read_only,
     vinyl_timeout           = private.cfg_update_vinyl_options,
+    vinyl_throttling        = private.cfg_update_vinyl_options,
+    vinyl_page_cache        = private.cfg_update_vinyl_options,
+    vinyl_readahead         = private.cfg_update_vinyl_options,
+    vinyl_readahead_memory  = private.cfg_update_vinyl_options,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.checkpoint_daemon.set_checkpoint_interval,
     -- do nothing, affects new replicas, which query this value on start
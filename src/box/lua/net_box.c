@@ -566,10 +566,17 @@ netbox_encode_execute(lua_State *L)
 
 	luamp_encode_map(cfg, &stream, 3);
 
-	size_t len;
-	const char *query = lua_tolstring(L, 4, &len);
-	luamp_encode_uint(cfg, &stream, IPROTO_SQL_TEXT);
-	luamp_encode_str(cfg, &stream, query, len);
+	if (lua_type(L, 4) == LUA_TNUMBER) {
+		/* Id of a statement prepared with PREPARE. */
+		uint32_t stmt_id = lua_tonumber(L, 4);
+		luamp_encode_uint(cfg, &stream, IPROTO_SQL_STMT_ID);
+		luamp_encode_uint(cfg, &stream, stmt_id);
+	} else {
+		size_t len;
+		const char *query = lua_tolstring(L, 4, &len);
+		luamp_encode_uint(cfg, &stream, IPROTO_SQL_TEXT);
+		luamp_encode_str(cfg, &stream, query, len);
+	}
 
 	luamp_encode_uint(cfg, &stream, IPROTO_SQL_BIND);
 	luamp_encode_tuple(L, cfg, &stream, 5);
@@ -581,6 +588,26 @@ netbox_encode_execute(lua_State *L)
 	return 0;
 }
 
+static int
+netbox_encode_prepare(lua_State *L)
+{
+	if (lua_gettop(L) < 4)
+		return luaL_error(L, "Usage: netbox.encode_prepare(ibuf, "\
+				  "sync, schema_version, query)");
+	struct mpstream stream;
+	size_t svp = netbox_prepare_request(L, &stream, IPROTO_PREPARE);
+
+	luamp_encode_map(cfg, &stream, 1);
+
+	size_t len;
+	const char *query = lua_tolstring(L, 4, &len);
+	luamp_encode_uint(cfg, &stream, IPROTO_SQL_TEXT);
+	luamp_encode_str(cfg, &stream, query, len);
+
+	netbox_encode_request(&stream, svp);
+	return 0;
+}
+
 int
 luaopen_net_box(struct lua_State *L)
 {
@@ -596,6 +623,7 @@ luaopen_net_box(struct lua_State *L)
 		{ "encode_update",  netbox_encode_update },
 		{ "encode_upsert",  netbox_encode_upsert },
 		{ "encode_execute", netbox_encode_execute},
+		{ "encode_prepare", netbox_encode_prepare},
 		{ "encode_auth",    netbox_encode_auth },
 		{ "decode_greeting",netbox_decode_greeting },
 		{ "communicate",    netbox_communicate },
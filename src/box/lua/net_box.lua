@@ -39,6 +39,7 @@ local IPROTO_SCHEMA_VERSION_KEY = 0x05
 local IPROTO_METADATA_KEY = 0x32
 local IPROTO_SQL_INFO_KEY = 0x43
 local IPROTO_SQL_ROW_COUNT_KEY = 0x44
+local IPROTO_SQL_STMT_ID_KEY = 0x45
 local IPROTO_FIELD_NAME_KEY = 0x29
 local IPROTO_DATA_KEY      = 0x30
 local IPROTO_ERROR_KEY     = 0x31
@@ -65,6 +66,7 @@ local method_codec           = {
     upsert  = internal.encode_upsert,
     select  = internal.encode_select,
     execute = internal.encode_execute,
+    prepare = internal.encode_prepare,
     -- inject raw data into connection, used by console and tests
     inject = function(buf, id, schema_version, bytes)
         local ptr = buf:reserve(#bytes)
@@ -296,7 +298,11 @@ local function create_transport(host, port, user, password, callback)
         -- Decode xrow.body[DATA] to Lua objects
         body_end_check, body = ibuf_decode(body_rpos)
         assert(body_end == body_end_check, "invalid xrow length")
-        request.response = body[IPROTO_DATA_KEY]
+        if request.method == 'prepare' then
+            request.response = body[IPROTO_SQL_STMT_ID_KEY]
+        else
+            request.response = body[IPROTO_DATA_KEY]
+        end
         request.metadata = body[IPROTO_METADATA_KEY]
         request.info = body[IPROTO_SQL_INFO_KEY]
         wakeup_client(request.client)
@@ -834,6 +840,21 @@ function remote_methods:execute(query, parameters, sql_opts, netbox_opts)
     return {metadata = metadata, rows = res}
 end
 
+--
+-- Prepare an SQL statement on the server. The returned id can
+-- be passed to execute() instead of the statement text.
+--
+function remote_methods:prepare(query, netbox_opts)
+    check_remote_arg(self, "prepare")
+    local timeout = self:request_timeout(netbox_opts)
+    local err, res = self._transport.perform_request(timeout, nil,
+                                    'prepare', self.schema_version, query)
+    if err then
+        box.error({code = err, reason = res})
+    end
+    return res
+end
+
 function remote_methods:wait_state(state, timeout)
     check_remote_arg(self, 'wait_state')
     if timeout == nil then
@@ -407,9 +407,13 @@ local index_options = {
     distance = 'string',
     run_count_per_level = 'number',
     run_size_ratio = 'number',
+    compaction = 'string',
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    page_bloom = 'boolean',
+    compression_dict_size = 'number',
+    hint = 'boolean',
 }
 
 --
@@ -457,6 +461,7 @@ box.schema.index.create = function(space_id, name, options)
             range_size = box.cfg.vinyl_range_size,
             run_count_per_level = box.cfg.vinyl_run_count_per_level,
             run_size_ratio = box.cfg.vinyl_run_size_ratio,
+            compaction = box.cfg.vinyl_compaction,
             bloom_fpr = box.cfg.vinyl_bloom_fpr
         }
     else
@@ -504,7 +509,11 @@ box.schema.index.create = function(space_id, name, options)
             range_size = options.range_size,
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
+            compaction = options.compaction,
             bloom_fpr = options.bloom_fpr,
+            page_bloom = options.page_bloom,
+            compression_dict_size = options.compression_dict_size,
+            hint = options.hint,
     }
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
@@ -900,6 +909,19 @@ function box.schema.space.bless(space)
         key = keify(key)
         return internal.get(index.space_id, index.id, key)
     end
+    -- Returns a table with the tuple found by keys[i] at index i.
+    index_mt.get_many = function(index, keys)
+        check_index_arg(index, 'get_many')
+        if type(keys) ~= 'table' then
+            box.error(box.error.PROC_LUA,
+                      "Usage: index:get_many({key1, key2, ...})")
+        end
+        local keyified = {}
+        for i, key in ipairs(keys) do
+            keyified[i] = keify(key)
+        end
+        return internal.get_many(index.space_id, index.id, keyified)
+    end
 
     local function check_select_opts(opts, key_is_nil)
         local offset = 0
@@ -1015,12 +1037,21 @@ function box.schema.space.bless(space)
         end
         return builtin.space_bsize(s)
     end
+    space_mt.stat = function(space)
+        check_space_arg(space, 'stat')
+        check_space_exists(space)
+        return internal.stat(space.id)
+    end
     space_mt.__newindex = index_mt.__newindex
 
     space_mt.get = function(space, key)
         check_space_arg(space, 'get')
         return check_primary_index(space):get(key)
     end
+    space_mt.get_many = function(space, keys)
+        check_space_arg(space, 'get_many')
+        return check_primary_index(space):get_many(keys)
+    end
     space_mt.select = function(space, key, opts)
         check_space_arg(space, 'select')
         return check_primary_index(space):select(key, opts)
@@ -170,6 +170,10 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 		if (index_def->type == HASH || index_def->type == TREE) {
 			lua_pushboolean(L, index_opts->is_unique);
 			lua_setfield(L, -2, "unique");
+			if (index_def->type == TREE && index_opts->hint) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "hint");
+			}
 		} else if (index_def->type == RTREE) {
 			lua_pushnumber(L, index_opts->dimension);
 			lua_setfield(L, -2, "dimension");
@@ -222,9 +226,19 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->run_size_ratio);
 			lua_setfield(L, -2, "run_size_ratio");
 
+			lua_pushstring(L, index_compaction_policy_strs[
+					index_opts->compaction]);
+			lua_setfield(L, -2, "compaction");
+
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			lua_pushboolean(L, index_opts->page_bloom);
+			lua_setfield(L, -2, "page_bloom");
+
+			lua_pushnumber(L, index_opts->compression_dict_size);
+			lua_setfield(L, -2, "compression_dict_size");
+
 			lua_settable(L, -3);
 		}
 
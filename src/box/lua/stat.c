@@ -39,11 +39,15 @@
 #include <lualib.h>
 
 #include "lua/utils.h"
+#include "box/iproto.h"
+#include "box/wal.h"
+#include "box/box.h"
+#include "box/info.h"
+#include "box/lua/info.h"
+#include "cbus.h"
 
 extern struct rmean *rmean_box;
 extern struct rmean *rmean_error;
-/** network statistics (iproto & cbus) */
-extern struct rmean *rmean_net;
 extern struct rmean *rmean_tx_wal_bus;
 
 static void
@@ -113,14 +117,99 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	luaL_checkstring(L, -1);
-	return rmean_foreach(rmean_net, seek_stat_item, L);
+	return iproto_rmean_foreach(seek_stat_item, L);
 }
 
 static int
 lbox_stat_net_call(struct lua_State *L)
 {
 	lua_newtable(L);
-	rmean_foreach(rmean_net, set_stat_item, L);
+	iproto_rmean_foreach(set_stat_item, L);
+	return 1;
+}
+
+static int
+set_cpipe_stat_item(const char *name, const struct cpipe_stat *stat,
+		    void *cb_ctx)
+{
+	struct lua_State *L = (struct lua_State *) cb_ctx;
+
+	/* Sum up statistics of pipes with the same name. */
+	lua_getfield(L, -1, name);
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, -3, name);
+	}
+	const char *names[] = { "messages", "batches", "wakeups" };
+	int64_t values[] = { stat->messages, stat->batches, stat->wakeups };
+	for (int i = 0; i < (int) lengthof(names); i++) {
+		lua_getfield(L, -1, names[i]);
+		int64_t value = values[i] + (int64_t) lua_tonumber(L, -1);
+		lua_pop(L, 1);
+		lua_pushnumber(L, value);
+		lua_setfield(L, -2, names[i]);
+	}
+	lua_getfield(L, -1, "messages");
+	lua_getfield(L, -2, "batches");
+	double batches = lua_tonumber(L, -1);
+	double avg_batch = batches > 0 ? lua_tonumber(L, -2) / batches : 0;
+	lua_pop(L, 2);
+	lua_pushnumber(L, avg_batch);
+	lua_setfield(L, -2, "avg_batch");
+	lua_pop(L, 1);
+	return 0;
+}
+
+/**
+ * box.stat.cbus(): statistics of inter-thread pipes,
+ * keyed by pipe name.
+ */
+static int
+lbox_stat_cbus(struct lua_State *L)
+{
+	lua_newtable(L);
+	if (cpipe_stat_foreach(set_cpipe_stat_item, L) != 0)
+		return luaT_error(L);
+	return 1;
+}
+
+/**
+ * box.stat.wal(): WAL group commit statistics, including
+ * the average number of transactions and bytes per group.
+ */
+static int
+lbox_stat_wal(struct lua_State *L)
+{
+	struct wal_stat stat;
+	wal_get_stat(&stat);
+	lua_newtable(L);
+	lua_pushnumber(L, stat.groups);
+	lua_setfield(L, -2, "groups");
+	lua_pushnumber(L, stat.txns);
+	lua_setfield(L, -2, "txns");
+	lua_pushnumber(L, stat.bytes);
+	lua_setfield(L, -2, "bytes");
+	double groups = stat.groups > 0 ? stat.groups : 1;
+	lua_pushnumber(L, stat.txns / groups);
+	lua_setfield(L, -2, "avg_txns");
+	lua_pushnumber(L, stat.bytes / groups);
+	lua_setfield(L, -2, "avg_bytes");
+	return 1;
+}
+
+/**
+ * box.stat.latency(): request latency percentiles of all
+ * spaces and indexes, keyed by space name. Collected only
+ * if box.cfg.latency_stat is set.
+ */
+static int
+lbox_stat_latency(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	box_latency_stat(&info);
 	return 1;
 }
 
@@ -143,8 +232,14 @@ box_lua_stat_init(struct lua_State *L)
 	static const struct luaL_Reg statlib [] = {
 		{NULL, NULL}
 	};
+	static const struct luaL_Reg lbox_stat_functions [] = {
+		{"cbus", lbox_stat_cbus},
+		{"wal", lbox_stat_wal},
+		{"latency", lbox_stat_latency},
+		{NULL, NULL}
+	};
 
-	luaL_register_module(L, "box.stat", statlib);
+	luaL_register_module(L, "box.stat", lbox_stat_functions);
 
 	lua_newtable(L);
 	luaL_register(L, NULL, lbox_stat_meta);
@@ -32,6 +32,8 @@
 #include "memtx_space.h"
 #include "memtx_tuple.h"
 
+#include "cbus.h"
+#include "fiber_cond.h"
 #include "coio_file.h"
 #include "scoped_guard.h"
 
@@ -40,6 +42,7 @@
 #include "memtx_tree.h"
 #include "iproto_constants.h"
 #include "xrow.h"
+#include "xlog_parallel.h"
 #include "xstream.h"
 #include "bootstrap.h"
 #include "replication.h"
@@ -126,6 +129,8 @@ MemtxEngine::MemtxEngine(const char *snap_dirname, bool force_recovery,
 	m_state(MEMTX_INITIALIZED),
 	m_checkpoint(0),
 	m_snap_io_rate_limit(0),
+	m_checkpoint_threads(1),
+	m_recovery_threads(1),
 	m_force_recovery(force_recovery)
 {
 	memtx_tuple_init(tuple_arena_max_size, objsize_min, objsize_max,
@@ -143,6 +148,70 @@ MemtxEngine::~MemtxEngine()
 	memtx_tuple_free();
 }
 
+/* {{{ Parallel snapshot reader */
+
+/** Snapshot recovery state shared by the reader callbacks. */
+struct snapshot_recovery {
+	MemtxEngine *engine;
+	/** Snapshot signature, used as LSN of recovered rows. */
+	int64_t signature;
+	/** Number of rows applied so far. */
+	uint64_t row_count;
+};
+
+/** Apply rows of a snapshot tx, see xlog_read_parallel(). */
+static int
+snapshot_recovery_apply_tx(struct xrow_header *rows, int row_count,
+			   void *arg)
+{
+	struct snapshot_recovery *recovery =
+		(struct snapshot_recovery *) arg;
+	try {
+		for (int i = 0; i < row_count; i++) {
+			rows[i].lsn = recovery->signature;
+			recovery->engine->recoverSnapshotRow(&rows[i]);
+			++recovery->row_count;
+			if (recovery->row_count % 100000 == 0) {
+				say_info("%.1fM rows processed",
+					 recovery->row_count / 1000000.);
+				fiber_yield_timeout(0);
+			}
+		}
+	} catch (Exception *) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Recover a snapshot using the given number of reader
+ * threads to read, check, decompress and decode it.
+ */
+static void
+snapshot_recover_parallel(MemtxEngine *engine, const char *filename,
+			  int64_t signature, int threads)
+{
+	struct snapshot_recovery recovery;
+	recovery.engine = engine;
+	recovery.signature = signature;
+	recovery.row_count = 0;
+	bool is_eof;
+	if (xlog_read_parallel(filename, threads, "snapshot.reader",
+			       snapshot_recovery_apply_tx, &recovery,
+			       &is_eof) != 0)
+		diag_raise();
+
+	/**
+	 * We should never try to read snapshots with no EOF
+	 * marker - such snapshots are very likely corrupted and
+	 * should not be trusted.
+	 */
+	if (!is_eof)
+		panic("snapshot `%s' has no EOF marker", filename);
+}
+
+/* }}} */
+
 void
 MemtxEngine::recoverSnapshot(const struct vclock *vclock)
 {
@@ -160,6 +229,16 @@ MemtxEngine::recoverSnapshot(const struct vclock *vclock)
 		xlog_cursor_close(&cursor, false);
 	});
 
+	/*
+	 * Parallel reading relies on every tx in the file being
+	 * intact, so disaster recovery always goes row by row.
+	 */
+	if (m_recovery_threads > 1 && !m_force_recovery) {
+		snapshot_recover_parallel(this, filename, signature,
+					  m_recovery_threads);
+		return;
+	}
+
 	struct xrow_header row;
 	uint64_t row_count = 0;
 	while (xlog_cursor_next_xc(&cursor, &row, m_force_recovery) == 0) {
@@ -400,15 +479,16 @@ MemtxEngine::bootstrap()
 }
 
 static void
-checkpoint_write_row(struct xlog *l, struct xrow_header *row)
+checkpoint_log_progress(int64_t rows_before, int64_t rows)
 {
-	static ev_tstamp last = 0;
-	if (last == 0) {
-		ev_now_update(loop());
-		last = ev_now(loop());
-	}
+	if (rows / 100000 != rows_before / 100000)
+		say_crit("%.1fM rows written", rows / 1000000.0);
+}
 
-	row->tm = last;
+static void
+checkpoint_write_row(struct xlog *l, struct xrow_header *row, ev_tstamp tm)
+{
+	row->tm = tm;
 	row->replica_id = 0;
 	/**
 	 * Rows in snapshot are numbered from 1 to %rows.
@@ -426,32 +506,44 @@ checkpoint_write_row(struct xlog *l, struct xrow_header *row)
 		diag_raise();
 	}
 
-	if ((l->rows + l->tx_rows) % 100000 == 0)
-		say_crit("%.1fM rows written", (l->rows + l->tx_rows) / 1000000.0);
+	checkpoint_log_progress(l->rows + l->tx_rows - 1,
+				l->rows + l->tx_rows);
+}
 
+/**
+ * Fill in a snapshot row for a tuple. The row references
+ * @a body, so the body must not be freed before the row.
+ */
+static void
+checkpoint_encode_tuple(uint32_t space_id, struct tuple *tuple,
+			struct request_replace_body *body,
+			struct xrow_header *row)
+{
+	body->m_body = 0x82; /* map of two elements. */
+	body->k_space_id = IPROTO_SPACE_ID;
+	body->m_space_id = 0xce; /* uint32 */
+	body->v_space_id = mp_bswap_u32(space_id);
+	body->k_tuple = IPROTO_TUPLE;
+
+	memset(row, 0, sizeof(struct xrow_header));
+	row->type = IPROTO_INSERT;
+
+	row->bodycnt = 2;
+	row->body[0].iov_base = body;
+	row->body[0].iov_len = sizeof(*body);
+	uint32_t bsize;
+	row->body[1].iov_base = (char *) tuple_data_range(tuple, &bsize);
+	row->body[1].iov_len = bsize;
 }
 
 static void
-checkpoint_write_tuple(struct xlog *l, uint32_t n, struct tuple *tuple)
+checkpoint_write_tuple(struct xlog *l, uint32_t n, struct tuple *tuple,
+		       ev_tstamp tm)
 {
 	struct request_replace_body body;
-	body.m_body = 0x82; /* map of two elements. */
-	body.k_space_id = IPROTO_SPACE_ID;
-	body.m_space_id = 0xce; /* uint32 */
-	body.v_space_id = mp_bswap_u32(n);
-	body.k_tuple = IPROTO_TUPLE;
-
 	struct xrow_header row;
-	memset(&row, 0, sizeof(struct xrow_header));
-	row.type = IPROTO_INSERT;
-
-	row.bodycnt = 2;
-	row.body[0].iov_base = &body;
-	row.body[0].iov_len = sizeof(body);
-	uint32_t bsize;
-	row.body[1].iov_base = (char *) tuple_data_range(tuple, &bsize);
-	row.body[1].iov_len = bsize;
-	checkpoint_write_row(l, &row);
+	checkpoint_encode_tuple(n, tuple, &body, &row);
+	checkpoint_write_row(l, &row, tm);
 }
 
 struct checkpoint_entry {
@@ -467,6 +559,11 @@ struct checkpoint {
 	 */
 	struct rlist entries;
 	uint64_t snap_io_rate_limit;
+	/**
+	 * The number of threads encoding and compressing
+	 * snapshot rows. @sa checkpoint_write_parallel().
+	 */
+	int threads;
 	struct cord cord;
 	bool waiting_for_snap_thread;
 	/** The vclock of the snapshot file. */
@@ -481,12 +578,13 @@ struct checkpoint {
 
 static void
 checkpoint_init(struct checkpoint *ckpt, const char *snap_dirname,
-		uint64_t snap_io_rate_limit)
+		uint64_t snap_io_rate_limit, int threads)
 {
 	ckpt->entries = RLIST_HEAD_INITIALIZER(ckpt->entries);
 	ckpt->waiting_for_snap_thread = false;
 	xdir_create(&ckpt->dir, snap_dirname, SNAP, &INSTANCE_UUID);
 	ckpt->snap_io_rate_limit = snap_io_rate_limit;
+	ckpt->threads = threads;
 	/* May be used in abortCheckpoint() */
 	ckpt->vclock = (struct vclock *) malloc(sizeof(*ckpt->vclock));
 	if (ckpt->vclock == NULL)
@@ -533,6 +631,324 @@ checkpoint_add_space(struct space *sp, void *data)
 	pk->createReadViewForIterator(entry->iterator);
 };
 
+/* {{{ Parallel snapshot writer */
+
+enum {
+	/** Max number of tuples in a batch sent to a worker. */
+	CHECKPOINT_BATCH_ROWS_MAX = 4096,
+	/** Max total size of tuples in a batch, in bytes. */
+	CHECKPOINT_BATCH_BSIZE_MAX = 128 * 1024,
+};
+
+/**
+ * Row encoding and compression is what costs the snapshot
+ * thread most of its CPU time, so with checkpoint threads
+ * configured it is offloaded to worker threads. The snapshot
+ * thread walks the read views, hands tuples to the workers in
+ * batches and appends the encoded blocks to the snapshot file
+ * in the order the batches were handed out, so that row LSNs
+ * keep growing through the file. The file format doesn't
+ * change: each block is a regular xlog tx.
+ */
+struct checkpoint_worker;
+
+/** A batch of tuples to encode, sent to a worker. */
+struct checkpoint_batch {
+	struct cbus_call_msg base;
+	/** The worker the batch is bound to. */
+	struct checkpoint_worker *worker;
+	/** Space the tuples belong to. */
+	uint32_t space_id;
+	/** Ordinal number of the batch. */
+	int64_t seq;
+	/** LSN of the first row of the batch. */
+	int64_t lsn;
+	/** Timestamp of the snapshot rows. */
+	ev_tstamp tm;
+	/** Tuples to encode. */
+	struct tuple *tuples[CHECKPOINT_BATCH_ROWS_MAX];
+	int count;
+};
+
+/** A thread encoding and compressing snapshot rows. */
+struct checkpoint_worker {
+	struct cord cord;
+	/** Pipe from the snapshot thread to the worker. */
+	struct cpipe worker_pipe;
+	/** Pipe from the worker to the snapshot thread. */
+	struct cpipe snap_pipe;
+	/** The block the worker encodes batches into. */
+	struct xlog_tx_block block;
+	/**
+	 * Set if the block has been created. The block is
+	 * created on demand, since its memory belongs to
+	 * the worker thread.
+	 */
+	bool has_block;
+	/** The batch currently being processed by the worker. */
+	struct checkpoint_batch batch;
+};
+
+/** State of the parallel writer, used in the snapshot thread. */
+struct checkpoint_writer {
+	/** The snapshot file. */
+	struct xlog *snap;
+	/** The list of spaces to write. */
+	struct rlist *entries;
+	/** The space to take the next batch from. */
+	struct checkpoint_entry *entry;
+	/** LSN to assign to the next row. */
+	int64_t lsn;
+	/** Ordinal number of the next batch to hand out. */
+	int64_t next_seq;
+	/** Ordinal number of the next batch to write. */
+	int64_t write_seq;
+	/** Signaled when a batch has been written or on failure. */
+	struct fiber_cond write_cond;
+	/** Timestamp of the snapshot rows. */
+	ev_tstamp tm;
+	/** Set if any of the workers failed. */
+	bool is_failed;
+};
+
+/** Snapshot worker thread function. */
+static int
+checkpoint_worker_f(va_list ap)
+{
+	struct checkpoint_worker *worker =
+		va_arg(ap, struct checkpoint_worker *);
+	struct cbus_endpoint endpoint;
+
+	cpipe_create(&worker->snap_pipe, "snapshot");
+	cbus_endpoint_create(&endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	cpipe_destroy(&worker->snap_pipe);
+	if (worker->has_block)
+		xlog_tx_block_destroy(&worker->block);
+	return 0;
+}
+
+/** Encode a batch of tuples, called in a worker thread. */
+static int
+checkpoint_encode_batch_f(struct cbus_call_msg *base)
+{
+	struct checkpoint_batch *batch = (struct checkpoint_batch *) base;
+	struct checkpoint_worker *worker = batch->worker;
+	struct xlog_tx_block *block = &worker->block;
+	if (!worker->has_block) {
+		if (xlog_tx_block_create(block) != 0)
+			return -1;
+		worker->has_block = true;
+	}
+	xlog_tx_block_reset(block);
+	for (int i = 0; i < batch->count; i++) {
+		struct request_replace_body body;
+		struct xrow_header row;
+		checkpoint_encode_tuple(batch->space_id, batch->tuples[i],
+					&body, &row);
+		row.tm = batch->tm;
+		row.lsn = batch->lsn + i;
+		ssize_t rc = xlog_tx_block_add_row(block, &row);
+		fiber_gc();
+		if (rc < 0)
+			return -1;
+	}
+	return xlog_tx_block_encode(block);
+}
+
+/**
+ * Collect the next batch of tuples to write.
+ * Returns false if there are no tuples left.
+ */
+static bool
+checkpoint_writer_next_batch(struct checkpoint_writer *writer,
+			     struct checkpoint_batch *batch)
+{
+	size_t bsize = 0;
+	batch->count = 0;
+	while (&writer->entry->link != writer->entries) {
+		struct checkpoint_entry *entry = writer->entry;
+		struct iterator *it = entry->iterator;
+		batch->space_id = space_id(entry->space);
+		struct tuple *tuple;
+		while (batch->count < CHECKPOINT_BATCH_ROWS_MAX &&
+		       bsize < CHECKPOINT_BATCH_BSIZE_MAX &&
+		       (tuple = it->next(it)) != NULL) {
+			batch->tuples[batch->count++] = tuple;
+			bsize += tuple->bsize;
+		}
+		if (batch->count > 0)
+			break;
+		/* The space is exhausted, switch to the next one. */
+		writer->entry = rlist_next_entry(entry, link);
+	}
+	if (batch->count == 0)
+		return false;
+	batch->seq = writer->next_seq++;
+	batch->lsn = writer->lsn;
+	batch->tm = writer->tm;
+	writer->lsn += batch->count;
+	return true;
+}
+
+/**
+ * A fiber feeding one worker with batches and writing
+ * the blocks encoded by it to the snapshot file.
+ */
+static int
+checkpoint_feed_worker_f(va_list ap)
+{
+	struct checkpoint_writer *writer =
+		va_arg(ap, struct checkpoint_writer *);
+	struct checkpoint_worker *worker =
+		va_arg(ap, struct checkpoint_worker *);
+	struct checkpoint_batch *batch = &worker->batch;
+	struct xlog *snap = writer->snap;
+
+	while (!writer->is_failed &&
+	       checkpoint_writer_next_batch(writer, batch)) {
+		if (cbus_call(&worker->worker_pipe, &worker->snap_pipe,
+			      &batch->base, checkpoint_encode_batch_f,
+			      NULL, TIMEOUT_INFINITY) != 0)
+			goto fail;
+		/* Wait for the blocks of earlier batches. */
+		while (writer->write_seq != batch->seq) {
+			if (writer->is_failed)
+				return 0;
+			fiber_cond_wait(&writer->write_cond);
+		}
+		int64_t rows_before = snap->rows;
+		if (xlog_write_tx_block(snap, &worker->block) < 0)
+			goto fail;
+		checkpoint_log_progress(rows_before, snap->rows);
+		writer->write_seq++;
+		fiber_cond_broadcast(&writer->write_cond);
+	}
+	return 0;
+fail:
+	writer->is_failed = true;
+	fiber_cond_broadcast(&writer->write_cond);
+	return -1;
+}
+
+/**
+ * Run the cbus endpoint of the snapshot thread, which delivers
+ * replies from the workers.
+ */
+static int
+checkpoint_cbus_loop_f(va_list ap)
+{
+	(void) ap;
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "snapshot",
+			     fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	return 0;
+}
+
+/**
+ * Write all tuples starting from @a entry to the snapshot file
+ * using ckpt->threads worker threads.
+ */
+static void
+checkpoint_write_parallel(struct checkpoint *ckpt, struct xlog *snap,
+			  struct checkpoint_entry *entry, ev_tstamp tm)
+{
+	int threads = ckpt->threads;
+	struct checkpoint_writer writer;
+	writer.snap = snap;
+	writer.entries = &ckpt->entries;
+	writer.entry = entry;
+	writer.lsn = snap->rows + snap->tx_rows;
+	writer.next_seq = 0;
+	writer.write_seq = 0;
+	writer.tm = tm;
+	writer.is_failed = false;
+
+	if (xlog_flush(snap) < 0)
+		diag_raise();
+
+	struct checkpoint_worker *workers = (struct checkpoint_worker *)
+		calloc(threads, sizeof(*workers));
+	struct fiber **feeders = (struct fiber **)
+		calloc(threads, sizeof(*feeders));
+	if (workers == NULL || feeders == NULL) {
+		free(workers);
+		free(feeders);
+		tnt_raise(OutOfMemory, threads * sizeof(*workers),
+			  "calloc", "checkpoint workers");
+	}
+	fiber_cond_create(&writer.write_cond);
+	auto guard = make_scoped_guard([&]{
+		free(workers);
+		free(feeders);
+		fiber_cond_destroy(&writer.write_cond);
+	});
+
+	struct fiber *cbus_fiber = fiber_new_xc("snapshot.cbus",
+						checkpoint_cbus_loop_f);
+	fiber_set_joinable(cbus_fiber, true);
+	fiber_start(cbus_fiber);
+
+	int started = 0;
+	for (; started < threads; started++) {
+		struct checkpoint_worker *worker = &workers[started];
+		worker->batch.worker = worker;
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "snapshot.worker.%d", started);
+		if (cord_costart(&worker->cord, name,
+				 checkpoint_worker_f, worker) != 0)
+			break;
+		cpipe_create(&worker->worker_pipe, name);
+	}
+
+	int rc = started == threads ? 0 : -1;
+	int fed = 0;
+	for (; rc == 0 && fed < started; fed++) {
+		struct fiber *f = fiber_new("snapshot.feeder",
+					    checkpoint_feed_worker_f);
+		if (f == NULL) {
+			rc = -1;
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fiber_start(f, &writer, &workers[fed]);
+		feeders[fed] = f;
+	}
+	/* Don't let the started feeders go on after a failure. */
+	if (rc != 0)
+		writer.is_failed = true;
+
+	for (int i = 0; i < fed; i++) {
+		if (fiber_join(feeders[i]) != 0)
+			rc = -1;
+	}
+	for (int i = 0; i < started; i++) {
+		struct checkpoint_worker *worker = &workers[i];
+		cbus_stop_loop(&worker->worker_pipe);
+		cpipe_destroy(&worker->worker_pipe);
+		if (cord_join(&worker->cord) != 0)
+			rc = -1;
+	}
+	/*
+	 * Joining a cancelled fiber clears the diagnostics
+	 * area, so save the error which stopped the writer.
+	 */
+	struct diag diag;
+	diag_create(&diag);
+	diag_move(diag_get(), &diag);
+	fiber_cancel(cbus_fiber);
+	fiber_join(cbus_fiber);
+	diag_move(&diag, diag_get());
+	if (rc != 0)
+		diag_raise();
+}
+
+/* }}} */
+
 int
 checkpoint_f(va_list ap)
 {
@@ -555,14 +971,28 @@ checkpoint_f(va_list ap)
 	auto guard = make_scoped_guard([&]{ xlog_close(&snap, false); });
 	snap.rate_limit = ckpt->snap_io_rate_limit;
 
+	ev_now_update(loop());
+	ev_tstamp tm = ev_now(loop());
+
 	say_info("saving snapshot `%s'", snap.filename);
 	struct checkpoint_entry *entry;
 	rlist_foreach_entry(entry, &ckpt->entries, link) {
+		/*
+		 * System spaces must precede user spaces in the
+		 * snapshot, since the latter can't be recovered
+		 * before their definitions are. Write them from
+		 * this thread and let the workers do the rest.
+		 */
+		if (ckpt->threads > 1 &&
+		    !space_is_system(entry->space)) {
+			checkpoint_write_parallel(ckpt, &snap, entry, tm);
+			break;
+		}
 		struct tuple *tuple;
 		struct iterator *it = entry->iterator;
 		for (tuple = it->next(it); tuple; tuple = it->next(it)) {
 			checkpoint_write_tuple(&snap, space_id(entry->space),
-					       tuple);
+					       tuple, tm);
 		}
 	}
 	xlog_flush(&snap);
@@ -577,7 +1007,8 @@ MemtxEngine::beginCheckpoint()
 
 	m_checkpoint = region_alloc_object_xc(&fiber()->gc, struct checkpoint);
 
-	checkpoint_init(m_checkpoint, m_snap_dir.dirname, m_snap_io_rate_limit);
+	checkpoint_init(m_checkpoint, m_snap_dir.dirname, m_snap_io_rate_limit,
+			m_checkpoint_threads);
 	space_foreach(checkpoint_add_space, m_checkpoint);
 
 	/* increment snapshot version; set tuple deletion to delayed mode */
@@ -731,6 +1162,14 @@ memtx_initial_join_f(va_list ap)
 	auto reader_guard = make_scoped_guard([&]{
 		xlog_cursor_close(&cursor, false);
 	});
+	/*
+	 * The stream may buffer rows in memory of this thread,
+	 * e.g. to compress them, so it must be flushed before
+	 * the thread exits, even on error.
+	 */
+	auto flush_guard = make_scoped_guard([&]{
+		xstream_flush(stream);
+	});
 
 	struct xrow_header row;
 	while (xlog_cursor_next_xc(&cursor, &row, true) == 0) {
@@ -746,6 +1185,7 @@ memtx_initial_join_f(va_list ap)
 	if (cursor.state != XLOG_CURSOR_EOF)
 		panic("snapshot `%s' has no EOF marker",
 		      cursor.name);
+	xstream_flush_xc(stream);
 	return 0;
 }
 
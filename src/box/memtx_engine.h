@@ -101,6 +101,16 @@ struct MemtxEngine: public Engine {
 	{
 		m_snap_io_rate_limit = new_limit * 1024 * 1024;
 	}
+	/* Update memtx_checkpoint_threads. */
+	void setCheckpointThreads(int threads)
+	{
+		m_checkpoint_threads = threads;
+	}
+	/* Set memtx_recovery_threads. */
+	void setRecoveryThreads(int threads)
+	{
+		m_recovery_threads = threads;
+	}
 	/**
 	 * Return LSN and vclock of the most recent snapshot
 	 * or -1 if there is no snapshot.
@@ -134,18 +144,28 @@ struct MemtxEngine: public Engine {
 				      (struct vclock *)vclock);
 	}
 	void recoverSnapshot(const struct vclock *vclock);
+	void
+	recoverSnapshotRow(struct xrow_header *row);
 public:
 	/** Engine recovery state */
 	enum memtx_recovery_state m_state;
 private:
-	void
-	recoverSnapshotRow(struct xrow_header *row);
 	/** Non-zero if there is a checkpoint (snapshot) in progress. */
 	struct checkpoint *m_checkpoint;
 	/** The directory where to store snapshots. */
 	struct xdir m_snap_dir;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t m_snap_io_rate_limit;
+	/**
+	 * The number of threads used to encode and compress
+	 * snapshot rows.
+	 */
+	int m_checkpoint_threads;
+	/**
+	 * The number of threads used to read and decompress
+	 * the snapshot on recovery.
+	 */
+	int m_recovery_threads;
 	bool m_force_recovery;
 };
 
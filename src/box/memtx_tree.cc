@@ -39,14 +39,65 @@
 
 /* {{{ Utilities. *************************************************/
 
-struct key_data
+/** The greatest hint, which is still not MEMTX_TREE_HINT_NONE. */
+static const uint64_t MEMTX_TREE_HINT_MAX = MEMTX_TREE_HINT_NONE - 1;
+
+/**
+ * Compute the hint of a MsgPack field of the given type.
+ * The hint function must be monotonic: a < b implies
+ * hint(a) <= hint(b), see memtx_tree.h.
+ */
+static uint64_t
+memtx_tree_field_hint(const char *field, enum field_type type)
 {
-	const char *key;
-	uint32_t part_count;
-};
+	switch (type) {
+	case FIELD_TYPE_UNSIGNED: {
+		if (mp_typeof(*field) != MP_UINT)
+			return MEMTX_TREE_HINT_NONE;
+		uint64_t val = mp_decode_uint(&field);
+		return MIN(val, MEMTX_TREE_HINT_MAX);
+	}
+	case FIELD_TYPE_INTEGER: {
+		/* Shift the signed range to [0, UINT64_MAX). */
+		const uint64_t offset = (uint64_t)1 << 63;
+		if (mp_typeof(*field) == MP_UINT) {
+			uint64_t val = mp_decode_uint(&field);
+			if (val >= (uint64_t)INT64_MAX)
+				return MEMTX_TREE_HINT_MAX;
+			return val + offset;
+		}
+		if (mp_typeof(*field) != MP_INT)
+			return MEMTX_TREE_HINT_NONE;
+		int64_t val = mp_decode_int(&field);
+		return (uint64_t)val + offset;
+	}
+	case FIELD_TYPE_STRING: {
+		if (mp_typeof(*field) != MP_STR)
+			return MEMTX_TREE_HINT_NONE;
+		uint32_t len;
+		const unsigned char *str =
+			(const unsigned char *)mp_decode_str(&field, &len);
+		/*
+		 * Strings are compared with memcmp(), so the
+		 * first bytes make a big-endian number. Leave
+		 * the lowest byte zero to never hit HINT_NONE.
+		 */
+		uint64_t hint = 0;
+		for (uint32_t i = 0; i < sizeof(hint) - 1; i++) {
+			hint <<= 8;
+			if (i < len)
+				hint |= str[i];
+		}
+		return hint << 8;
+	}
+	default:
+		return MEMTX_TREE_HINT_NONE;
+	}
+}
 
 int
-memtx_tree_compare(const tuple *a, const tuple *b, struct index_def *index_def)
+memtx_tree_compare(const struct tuple *a, const struct tuple *b,
+		   struct index_def *index_def)
 {
 	int r = tuple_compare(a, b, index_def->key_def);
 	if (r == 0 && !index_def->opts.is_unique)
@@ -55,7 +106,7 @@ memtx_tree_compare(const tuple *a, const tuple *b, struct index_def *index_def)
 }
 
 int
-memtx_tree_compare_key(const tuple *a, const struct key_data *key_data,
+memtx_tree_compare_key(const struct tuple *a, const struct key_data *key_data,
 		       struct index_def *index_def)
 {
 	return tuple_compare_with_key(a, key_data->key,
@@ -69,12 +120,46 @@ memtx_tree_qcompare(const void* a, const void *b, void *c)
 		*(struct tuple **)b, (struct index_def *)c);
 }
 
+int
+memtx_hinted_tree_compare(struct memtx_tree_data a, struct memtx_tree_data b,
+			  struct index_def *index_def)
+{
+	if (a.hint != b.hint && a.hint != MEMTX_TREE_HINT_NONE &&
+	    b.hint != MEMTX_TREE_HINT_NONE)
+		return a.hint < b.hint ? -1 : 1;
+	return memtx_tree_compare(a.tuple, b.tuple, index_def);
+}
+
+int
+memtx_hinted_tree_compare_key(struct memtx_tree_data a,
+			      const struct key_data *key_data,
+			      struct index_def *index_def)
+{
+	if (a.hint != key_data->hint && a.hint != MEMTX_TREE_HINT_NONE &&
+	    key_data->hint != MEMTX_TREE_HINT_NONE)
+		return a.hint < key_data->hint ? -1 : 1;
+	return memtx_tree_compare_key(a.tuple, key_data, index_def);
+}
+
+int
+memtx_hinted_tree_qcompare(const void* a, const void *b, void *c)
+{
+	return memtx_hinted_tree_compare(*(struct memtx_tree_data *)a,
+		*(struct memtx_tree_data *)b, (struct index_def *)c);
+}
+
 /* {{{ MemtxTree Iterators ****************************************/
 struct tree_iterator {
 	struct iterator base;
+	/** The index tree, NULL if the index stores hints. */
 	const struct memtx_tree *tree;
+	/** The index tree, NULL if the index doesn't store hints. */
+	const struct memtx_hinted_tree *hinted_tree;
 	struct index_def *index_def;
-	struct memtx_tree_iterator tree_iterator;
+	union {
+		struct memtx_tree_iterator tree_iterator;
+		struct memtx_hinted_tree_iterator hinted_tree_iterator;
+	};
 	struct key_data key_data;
 };
 
@@ -101,60 +186,116 @@ tree_iterator_dummie(struct iterator *iterator)
 	return 0;
 }
 
+/** Invalidate the position of a tree iterator. */
+static inline void
+tree_iterator_invalidate(struct tree_iterator *it)
+{
+	if (it->hinted_tree != NULL)
+		it->hinted_tree_iterator = memtx_hinted_tree_invalid_iterator();
+	else
+		it->tree_iterator = memtx_tree_invalid_iterator();
+}
+
+/**
+ * Return the tuple at the current position of a tree iterator
+ * or NULL if the iterator is exhausted. If @check_key is set,
+ * also return NULL if the tuple doesn't match the search key.
+ */
+static inline struct tuple *
+tree_iterator_get(struct tree_iterator *it, bool check_key)
+{
+	if (it->hinted_tree != NULL) {
+		struct memtx_tree_data *res =
+			memtx_hinted_tree_iterator_get_elem(it->hinted_tree,
+						&it->hinted_tree_iterator);
+		if (res == NULL || (check_key &&
+		    memtx_hinted_tree_compare_key(*res, &it->key_data,
+						  it->index_def) != 0))
+			return NULL;
+		return res->tuple;
+	}
+	struct tuple **res = memtx_tree_iterator_get_elem(it->tree,
+							  &it->tree_iterator);
+	if (res == NULL || (check_key &&
+	    memtx_tree_compare_key(*res, &it->key_data, it->index_def) != 0))
+		return NULL;
+	return *res;
+}
+
+/** Move a tree iterator to the next element. */
+static inline void
+tree_iterator_step_fwd(struct tree_iterator *it)
+{
+	if (it->hinted_tree != NULL)
+		memtx_hinted_tree_iterator_next(it->hinted_tree,
+						&it->hinted_tree_iterator);
+	else
+		memtx_tree_iterator_next(it->tree, &it->tree_iterator);
+}
+
+/** Move a tree iterator to the previous element. */
+static inline void
+tree_iterator_step_bwd(struct tree_iterator *it)
+{
+	if (it->hinted_tree != NULL)
+		memtx_hinted_tree_iterator_prev(it->hinted_tree,
+						&it->hinted_tree_iterator);
+	else
+		memtx_tree_iterator_prev(it->tree, &it->tree_iterator);
+}
+
 static struct tuple *
 tree_iterator_fwd(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	tuple **res = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	struct tuple *res = tree_iterator_get(it, false);
 	if (!res)
 		return 0;
-	memtx_tree_iterator_next(it->tree, &it->tree_iterator);
-	return *res;
+	tree_iterator_step_fwd(it);
+	return res;
 }
 
 static struct tuple *
 tree_iterator_bwd(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	tuple **res = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	struct tuple *res = tree_iterator_get(it, false);
 	if (!res)
 		return 0;
-	memtx_tree_iterator_prev(it->tree, &it->tree_iterator);
-	return *res;
+	tree_iterator_step_bwd(it);
+	return res;
 }
 
 static struct tuple *
 tree_iterator_fwd_check_equality(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	tuple **res = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
-	if (!res)
-		return 0;
-	if (memtx_tree_compare_key(*res, &it->key_data, it->index_def) != 0) {
-		it->tree_iterator = memtx_tree_invalid_iterator();
+	struct tuple *res = tree_iterator_get(it, true);
+	if (!res) {
+		tree_iterator_invalidate(it);
 		return 0;
 	}
-	memtx_tree_iterator_next(it->tree, &it->tree_iterator);
-	return *res;
+	tree_iterator_step_fwd(it);
+	return res;
 }
 
 static struct tuple *
 tree_iterator_fwd_check_next_equality(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	tuple **res = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
+	struct tuple *res = tree_iterator_get(it, false);
 	if (!res)
 		return 0;
-	memtx_tree_iterator_next(it->tree, &it->tree_iterator);
+	tree_iterator_step_fwd(it);
 	iterator->next = tree_iterator_fwd_check_equality;
-	return *res;
+	return res;
 }
 
 static struct tuple *
 tree_iterator_bwd_skip_one(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	memtx_tree_iterator_prev(it->tree, &it->tree_iterator);
+	tree_iterator_step_bwd(it);
 	iterator->next = tree_iterator_bwd;
 	return tree_iterator_bwd(iterator);
 }
@@ -163,22 +304,20 @@ static struct tuple *
 tree_iterator_bwd_check_equality(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	tuple **res = memtx_tree_iterator_get_elem(it->tree, &it->tree_iterator);
-	if (!res)
-		return 0;
-	if (memtx_tree_compare_key(*res, &it->key_data, it->index_def) != 0) {
-		it->tree_iterator = memtx_tree_invalid_iterator();
+	struct tuple *res = tree_iterator_get(it, true);
+	if (!res) {
+		tree_iterator_invalidate(it);
 		return 0;
 	}
-	memtx_tree_iterator_prev(it->tree, &it->tree_iterator);
-	return *res;
+	tree_iterator_step_bwd(it);
+	return res;
 }
 
 static struct tuple *
 tree_iterator_bwd_skip_one_check_next_equality(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	memtx_tree_iterator_prev(it->tree, &it->tree_iterator);
+	tree_iterator_step_bwd(it);
 	iterator->next = tree_iterator_bwd_check_equality;
 	return tree_iterator_bwd_check_equality(iterator);
 }
@@ -187,36 +326,77 @@ tree_iterator_bwd_skip_one_check_next_equality(struct iterator *iterator)
 /* {{{ MemtxTree  **********************************************************/
 
 MemtxTree::MemtxTree(struct index_def *index_def_arg)
-	: MemtxIndex(index_def_arg), build_array(0), build_array_size(0),
-	  build_array_alloc_size(0)
+	: MemtxIndex(index_def_arg), hint_type(FIELD_TYPE_ANY),
+	  build_array(0), build_array_size(0), build_array_alloc_size(0)
 {
+	enum field_type type = index_def->key_def->parts[0].type;
+	if (index_def->opts.hint && (type == FIELD_TYPE_UNSIGNED ||
+				     type == FIELD_TYPE_INTEGER ||
+				     type == FIELD_TYPE_STRING))
+		hint_type = type;
 	memtx_index_arena_init();
-	memtx_tree_create(&tree, index_def,
-			      memtx_index_extent_alloc,
-			      memtx_index_extent_free, NULL);
+	if (isHinted()) {
+		memtx_hinted_tree_create(&hinted_tree, index_def,
+					 memtx_index_extent_alloc,
+					 memtx_index_extent_free, NULL);
+	} else {
+		memtx_tree_create(&tree, index_def,
+				  memtx_index_extent_alloc,
+				  memtx_index_extent_free, NULL);
+	}
 }
 
 MemtxTree::~MemtxTree()
 {
-	memtx_tree_destroy(&tree);
+	if (isHinted())
+		memtx_hinted_tree_destroy(&hinted_tree);
+	else
+		memtx_tree_destroy(&tree);
 	free(build_array);
 }
 
+uint64_t
+MemtxTree::tupleHint(struct tuple *tuple) const
+{
+	if (hint_type == FIELD_TYPE_ANY)
+		return MEMTX_TREE_HINT_NONE;
+	const char *field = tuple_field(tuple,
+					index_def->key_def->parts[0].fieldno);
+	return memtx_tree_field_hint(field, hint_type);
+}
+
+uint64_t
+MemtxTree::keyHint(const char *key, uint32_t part_count) const
+{
+	if (hint_type == FIELD_TYPE_ANY || part_count == 0)
+		return MEMTX_TREE_HINT_NONE;
+	return memtx_tree_field_hint(key, hint_type);
+}
+
 size_t
 MemtxTree::size() const
 {
+	if (isHinted())
+		return memtx_hinted_tree_size(&hinted_tree);
 	return memtx_tree_size(&tree);
 }
 
 size_t
 MemtxTree::bsize() const
 {
+	if (isHinted())
+		return memtx_hinted_tree_mem_used(&hinted_tree);
 	return memtx_tree_mem_used(&tree);
 }
 
 struct tuple *
 MemtxTree::random(uint32_t rnd) const
 {
+	if (isHinted()) {
+		struct memtx_tree_data *res =
+			memtx_hinted_tree_random(&hinted_tree, rnd);
+		return res ? res->tuple : 0;
+	}
 	struct tuple **res = memtx_tree_random(&tree, rnd);
 	return res ? *res : 0;
 }
@@ -229,6 +409,12 @@ MemtxTree::findByKey(const char *key, uint32_t part_count) const
 	struct key_data key_data;
 	key_data.key = key;
 	key_data.part_count = part_count;
+	key_data.hint = keyHint(key, part_count);
+	if (isHinted()) {
+		struct memtx_tree_data *res =
+			memtx_hinted_tree_find(&hinted_tree, &key_data);
+		return res ? res->tuple : 0;
+	}
 	struct tuple **res = memtx_tree_find(&tree, &key_data);
 	return res ? *res : 0;
 }
@@ -240,31 +426,53 @@ MemtxTree::replace(struct tuple *old_tuple, struct tuple *new_tuple,
 	uint32_t errcode;
 
 	if (new_tuple) {
-		struct tuple *dup_tuple = NULL;
+		struct memtx_tree_data new_data;
+		new_data.tuple = new_tuple;
+		new_data.hint = tupleHint(new_tuple);
+		struct memtx_tree_data dup_data;
+		dup_data.tuple = NULL;
 
 		/* Try to optimistically replace the new_tuple. */
-		int tree_res =
-		memtx_tree_insert(&tree, new_tuple, &dup_tuple);
+		int tree_res = isHinted() ?
+			memtx_hinted_tree_insert(&hinted_tree, new_data,
+						 &dup_data) :
+			memtx_tree_insert(&tree, new_tuple, &dup_data.tuple);
 		if (tree_res) {
-			tnt_raise(OutOfMemory, BPS_TREE_EXTENT_SIZE,
+			tnt_raise(OutOfMemory, MEMTX_EXTENT_SIZE,
 				  "MemtxTree", "replace");
 		}
 
-		errcode = replace_check_dup(old_tuple, dup_tuple, mode);
+		errcode = replace_check_dup(old_tuple, dup_data.tuple, mode);
 
 		if (errcode) {
-			memtx_tree_delete(&tree, new_tuple);
-			if (dup_tuple)
-				memtx_tree_insert(&tree, dup_tuple, 0);
+			if (isHinted()) {
+				memtx_hinted_tree_delete(&hinted_tree,
+							 new_data);
+				if (dup_data.tuple)
+					memtx_hinted_tree_insert(&hinted_tree,
+								 dup_data, 0);
+			} else {
+				memtx_tree_delete(&tree, new_tuple);
+				if (dup_data.tuple)
+					memtx_tree_insert(&tree,
+							  dup_data.tuple, 0);
+			}
 			struct space *sp = space_cache_find(index_def->space_id);
 			tnt_raise(ClientError, errcode, index_name(this),
 				  space_name(sp));
 		}
-		if (dup_tuple)
-			return dup_tuple;
+		if (dup_data.tuple)
+			return dup_data.tuple;
 	}
 	if (old_tuple) {
-		memtx_tree_delete(&tree, old_tuple);
+		if (isHinted()) {
+			struct memtx_tree_data old_data;
+			old_data.tuple = old_tuple;
+			old_data.hint = tupleHint(old_tuple);
+			memtx_hinted_tree_delete(&hinted_tree, old_data);
+		} else {
+			memtx_tree_delete(&tree, old_tuple);
+		}
 	}
 	return old_tuple;
 }
@@ -280,9 +488,12 @@ MemtxTree::allocIterator() const
 	}
 
 	it->index_def = index_def;
-	it->tree = &tree;
+	if (isHinted())
+		it->hinted_tree = &hinted_tree;
+	else
+		it->tree = &tree;
 	it->base.free = tree_iterator_free;
-	it->tree_iterator = memtx_tree_invalid_iterator();
+	tree_iterator_invalidate(it);
 	return (struct iterator *) it;
 }
 
@@ -307,22 +518,36 @@ MemtxTree::initIterator(struct iterator *iterator, enum iterator_type type,
 	}
 	it->key_data.key = key;
 	it->key_data.part_count = part_count;
+	it->key_data.hint = keyHint(key, part_count);
 
 	bool exact = false;
 	if (key == 0) {
 		if (iterator_type_is_reverse(type))
-			it->tree_iterator = memtx_tree_invalid_iterator();
+			tree_iterator_invalidate(it);
+		else if (isHinted())
+			it->hinted_tree_iterator =
+				memtx_hinted_tree_iterator_first(&hinted_tree);
 		else
 			it->tree_iterator = memtx_tree_iterator_first(&tree);
 	} else {
 		if (type == ITER_ALL || type == ITER_EQ || type == ITER_GE || type == ITER_LT) {
-			it->tree_iterator = memtx_tree_lower_bound(&tree, &it->key_data, &exact);
+			if (isHinted())
+				it->hinted_tree_iterator =
+					memtx_hinted_tree_lower_bound(&hinted_tree,
+							&it->key_data, &exact);
+			else
+				it->tree_iterator = memtx_tree_lower_bound(&tree, &it->key_data, &exact);
 			if (type == ITER_EQ && !exact) {
 				it->base.next = tree_iterator_dummie;
 				return;
 			}
 		} else { // ITER_GT, ITER_REQ, ITER_LE
-			it->tree_iterator = memtx_tree_upper_bound(&tree, &it->key_data, &exact);
+			if (isHinted())
+				it->hinted_tree_iterator =
+					memtx_hinted_tree_upper_bound(&hinted_tree,
+							&it->key_data, &exact);
+			else
+				it->tree_iterator = memtx_tree_upper_bound(&tree, &it->key_data, &exact);
 			if (type == ITER_REQ && !exact) {
 				it->base.next = tree_iterator_dummie;
 				return;
@@ -358,7 +583,7 @@ MemtxTree::initIterator(struct iterator *iterator, enum iterator_type type,
 void
 MemtxTree::beginBuild()
 {
-	assert(memtx_tree_size(&tree) == 0);
+	assert(size() == 0);
 }
 
 void
@@ -366,48 +591,66 @@ MemtxTree::reserve(uint32_t size_hint)
 {
 	if (size_hint < build_array_alloc_size)
 		return;
-	struct tuple **tmp = (struct tuple**)
-		realloc(build_array, size_hint * sizeof(*tmp));
+	size_t elem_size = isHinted() ? sizeof(hinted_build_array[0]) :
+					sizeof(build_array[0]);
+	void *tmp = realloc(build_array, size_hint * elem_size);
 	if (tmp == NULL)
-		tnt_raise(OutOfMemory, size_hint * sizeof(*tmp),
+		tnt_raise(OutOfMemory, size_hint * elem_size,
 			"MemtxTree", "reserve");
-	build_array = tmp;
+	build_array = (struct tuple **)tmp;
 	build_array_alloc_size = size_hint;
 }
 
 void
 MemtxTree::buildNext(struct tuple *tuple)
 {
+	size_t elem_size = isHinted() ? sizeof(hinted_build_array[0]) :
+					sizeof(build_array[0]);
 	if (build_array == NULL) {
-		build_array = (struct tuple**) malloc(BPS_TREE_EXTENT_SIZE);
+		build_array = (struct tuple **)malloc(MEMTX_EXTENT_SIZE);
 		if (build_array == NULL) {
-			tnt_raise(OutOfMemory, BPS_TREE_EXTENT_SIZE,
+			tnt_raise(OutOfMemory, MEMTX_EXTENT_SIZE,
 				"MemtxTree", "buildNext");
 		}
-		build_array_alloc_size =
-			BPS_TREE_EXTENT_SIZE / sizeof(struct tuple*);
+		build_array_alloc_size = MEMTX_EXTENT_SIZE / elem_size;
 	}
 	assert(build_array_size <= build_array_alloc_size);
 	if (build_array_size == build_array_alloc_size) {
 		build_array_alloc_size = build_array_alloc_size +
 					 build_array_alloc_size / 2;
-		struct tuple **tmp = (struct tuple **)
-			realloc(build_array, build_array_alloc_size *
-				sizeof(*tmp));
+		void *tmp = realloc(build_array,
+				    build_array_alloc_size * elem_size);
 		if (tmp == NULL) {
 			tnt_raise(OutOfMemory, build_array_alloc_size *
-				sizeof(*tmp), "MemtxTree", "buildNext");
+				elem_size, "MemtxTree", "buildNext");
 		}
-		build_array = tmp;
+		build_array = (struct tuple **)tmp;
+	}
+	if (isHinted()) {
+		struct memtx_tree_data *elem =
+			&hinted_build_array[build_array_size++];
+		elem->tuple = tuple;
+		elem->hint = tupleHint(tuple);
+	} else {
+		build_array[build_array_size++] = tuple;
 	}
-	build_array[build_array_size++] = tuple;
 }
 
 void
 MemtxTree::endBuild()
 {
-	qsort_arg(build_array, build_array_size, sizeof(struct tuple *), memtx_tree_qcompare, index_def);
-	memtx_tree_build(&tree, build_array, build_array_size);
+	if (isHinted()) {
+		qsort_arg(hinted_build_array, build_array_size,
+			  sizeof(hinted_build_array[0]),
+			  memtx_hinted_tree_qcompare, index_def);
+		memtx_hinted_tree_build(&hinted_tree, hinted_build_array,
+					build_array_size);
+	} else {
+		qsort_arg(build_array, build_array_size,
+			  sizeof(build_array[0]),
+			  memtx_tree_qcompare, index_def);
+		memtx_tree_build(&tree, build_array, build_array_size);
+	}
 
 	free(build_array);
 	build_array = 0;
@@ -423,8 +666,15 @@ void
 MemtxTree::createReadViewForIterator(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	struct memtx_tree *tree = (struct memtx_tree *)it->tree;
-	memtx_tree_iterator_freeze(tree, &it->tree_iterator);
+	if (it->hinted_tree != NULL) {
+		struct memtx_hinted_tree *tree =
+			(struct memtx_hinted_tree *)it->hinted_tree;
+		memtx_hinted_tree_iterator_freeze(tree,
+						  &it->hinted_tree_iterator);
+	} else {
+		struct memtx_tree *tree = (struct memtx_tree *)it->tree;
+		memtx_tree_iterator_freeze(tree, &it->tree_iterator);
+	}
 }
 
 /**
@@ -435,6 +685,13 @@ void
 MemtxTree::destroyReadViewForIterator(struct iterator *iterator)
 {
 	struct tree_iterator *it = tree_iterator(iterator);
-	struct memtx_tree *tree = (struct memtx_tree *)it->tree;
-	memtx_tree_iterator_destroy(tree, &it->tree_iterator);
+	if (it->hinted_tree != NULL) {
+		struct memtx_hinted_tree *tree =
+			(struct memtx_hinted_tree *)it->hinted_tree;
+		memtx_hinted_tree_iterator_destroy(tree,
+						   &it->hinted_tree_iterator);
+	} else {
+		struct memtx_tree *tree = (struct memtx_tree *)it->tree;
+		memtx_tree_iterator_destroy(tree, &it->tree_iterator);
+	}
 }
@@ -35,13 +35,22 @@
 #include "memtx_engine.h"
 
 struct tuple;
-struct key_data;
+
+/** A key to look up in the tree. */
+struct key_data {
+	const char *key;
+	uint32_t part_count;
+	/** Hint of the first key part, used by a hinted tree. */
+	uint64_t hint;
+};
 
 int
-memtx_tree_compare(const struct tuple *a, const struct tuple *b, struct index_def *index_def);
+memtx_tree_compare(const struct tuple *a, const struct tuple *b,
+		   struct index_def *index_def);
 
 int
-memtx_tree_compare_key(const tuple *a, const key_data *b, struct index_def *index_def);
+memtx_tree_compare_key(const struct tuple *a, const struct key_data *b,
+		       struct index_def *index_def);
 
 #define BPS_TREE_NAME memtx_tree
 #define BPS_TREE_BLOCK_SIZE (512)
@@ -54,6 +63,58 @@ memtx_tree_compare_key(const tuple *a, const key_data *b, struct index_def *inde
 
 #include "salad/bps_tree.h"
 
+#undef BPS_TREE_NAME
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef bps_tree_elem_t
+
+/**
+ * A hint is an order-preserving digest of the first key part
+ * of a tuple: if hint(a) < hint(b) then a < b, so comparison
+ * of two elements with different hints can be resolved without
+ * decoding tuples. Equal hints tell nothing and fall back to
+ * the full comparison. Hints are stored only if the index
+ * was created with the 'hint' option and its first key part is
+ * of type 'unsigned', 'integer' or 'string'. Such an index uses
+ * memtx_hinted_tree, any other uses memtx_tree, which stores
+ * bare tuple pointers.
+ */
+#define MEMTX_TREE_HINT_NONE UINT64_MAX
+
+/** An element of a hinted tree: a tuple and its hint. */
+struct memtx_tree_data {
+	struct tuple *tuple;
+	uint64_t hint;
+};
+
+int
+memtx_hinted_tree_compare(struct memtx_tree_data a, struct memtx_tree_data b,
+			  struct index_def *index_def);
+
+int
+memtx_hinted_tree_compare_key(struct memtx_tree_data a,
+			      const struct key_data *b,
+			      struct index_def *index_def);
+
+#define BPS_TREE_NAME memtx_hinted_tree
+#define BPS_TREE_COMPARE(a, b, arg) memtx_hinted_tree_compare(a, b, arg)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) memtx_hinted_tree_compare_key(a, b, arg)
+#define bps_tree_elem_t struct memtx_tree_data
+/* Debug checks compare elements with operator ==. */
+#define BPS_TREE_NO_DEBUG
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+#undef BPS_TREE_NO_DEBUG
+
 class MemtxTree: public MemtxIndex {
 public:
 	MemtxTree(struct index_def *index_def);
@@ -89,9 +150,29 @@ public:
 	 */
 	virtual void destroyReadViewForIterator(struct iterator *iterator) override;
 
+	/** Whether the index stores hints, i.e. uses hinted_tree. */
+	bool isHinted() const { return hint_type != FIELD_TYPE_ANY; }
+	/** Compute the hint of a tuple stored in the index. */
+	uint64_t tupleHint(struct tuple *tuple) const;
+	/** Compute the hint of a key to look up in the index. */
+	uint64_t keyHint(const char *key, uint32_t part_count) const;
+
 // protected:
-	struct memtx_tree tree;
-	struct tuple **build_array;
+	union {
+		/** Tuples, if the index doesn't store hints. */
+		struct memtx_tree tree;
+		/** Tuples with hints, if the index stores them. */
+		struct memtx_hinted_tree hinted_tree;
+	};
+	/**
+	 * Type of the first key part if hints are enabled and
+	 * supported for it, FIELD_TYPE_ANY otherwise.
+	 */
+	enum field_type hint_type;
+	union {
+		struct tuple **build_array;
+		struct memtx_tree_data *hinted_build_array;
+	};
 	size_t build_array_size, build_array_alloc_size;
 };
 
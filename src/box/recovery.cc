@@ -37,6 +37,7 @@
 #include "xlog.h"
 #include "xrow.h"
 #include "xstream.h"
+#include "xlog_parallel.h"
 #include "wal.h" /* wal_watcher */
 #include "replication.h"
 #include "session.h"
@@ -134,6 +135,7 @@ recovery_new(const char *wal_dirname, bool force_recovery,
 
 	r->watcher = NULL;
 	rlist_create(&r->on_close_log);
+	r->read_threads = 1;
 
 	guard.is_active = false;
 	return r;
@@ -236,6 +238,73 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 	}
 }
 
+/** State of a WAL read by several threads. */
+struct recovery_parallel {
+	struct recovery *r;
+	struct xstream *stream;
+	/** Number of transactions applied so far. */
+	uint64_t tx_count;
+	/** Number of rows applied so far. */
+	uint64_t row_count;
+};
+
+/** Apply rows of a WAL tx, see xlog_read_parallel(). */
+static int
+recover_xlog_tx(struct xrow_header *rows, int row_count, void *arg)
+{
+	struct recovery_parallel *p = (struct recovery_parallel *) arg;
+	struct recovery *r = p->r;
+	try {
+		for (int i = 0; i < row_count; i++) {
+			struct xrow_header *row = &rows[i];
+			int64_t current_lsn =
+				vclock_get(&r->vclock, row->replica_id);
+			if (row->lsn <= current_lsn)
+				continue; /* already applied, skip */
+			assert(row->replica_id != 0);
+			vclock_follow(&r->vclock, row->replica_id, row->lsn);
+			xstream_write_xc(p->stream, row);
+			++p->row_count;
+			if (p->row_count % 100000 == 0)
+				say_info("%.1fM rows processed",
+					 p->row_count / 1000000.);
+		}
+	} catch (Exception *) {
+		return -1;
+	}
+	++p->tx_count;
+	return 0;
+}
+
+/**
+ * Read a WAL from the beginning using several threads to
+ * read, check, decompress and decode transactions, while
+ * the calling fiber only applies them. Advance the WAL
+ * cursor past the applied transactions, so that whatever
+ * is left in the file, e.g. the EOF marker or rows appended
+ * while it was read, is picked up by recover_xlog().
+ */
+static void
+recover_xlog_parallel(struct recovery *r, struct xstream *stream)
+{
+	struct recovery_parallel p;
+	p.r = r;
+	p.stream = stream;
+	p.tx_count = 0;
+	p.row_count = 0;
+	bool is_eof;
+	if (xlog_read_parallel(r->cursor.name, r->read_threads,
+			       "wal.reader", recover_xlog_tx, &p,
+			       &is_eof) != 0)
+		diag_raise();
+	for (uint64_t i = 0; i < p.tx_count; i++) {
+		int rc = xlog_cursor_skip_tx(&r->cursor);
+		if (rc < 0)
+			diag_raise();
+		assert(rc == 0);
+	}
+}
+
 /**
  * Find out if there are new .xlog files since the current
  * LSN, and read them all up.
@@ -304,10 +373,22 @@ recover_remaining_wals(struct recovery *r, struct xstream *stream,
 
 		say_info("recover from `%s'", r->cursor.name);
 
+		/*
+		 * Parallel reading relies on every tx in the file
+		 * being intact, so disaster recovery always goes
+		 * row by row.
+		 */
+		if (r->read_threads > 1 && stop_vclock == NULL &&
+		    !r->wal_dir.force_recovery)
+			recover_xlog_parallel(r, stream);
+
 recover_current_wal:
 		recover_xlog(r, stream, stop_vclock);
 	}
 
+	/* Caught up with the WAL, don't let the stream hold rows. */
+	xstream_flush_xc(stream);
+
 	if (r->cursor.state == XLOG_CURSOR_EOF)
 		recovery_close_log(r);
 
@@ -57,6 +57,12 @@ struct recovery {
 	struct fiber *watcher;
 	/** List of triggers invoked when the current WAL is closed. */
 	struct rlist on_close_log;
+	/**
+	 * Number of threads to read WALs with, see
+	 * xlog_read_parallel(). 1 means WALs are read
+	 * row by row in the calling fiber.
+	 */
+	int read_threads;
 };
 
 struct recovery *
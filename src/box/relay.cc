@@ -38,6 +38,8 @@
 #include "fiber.h"
 #include "say.h"
 #include "scoped_guard.h"
+#include "clock.h"
+#include "small/obuf.h"
 
 #include "coio.h"
 #include "coio_task.h"
@@ -46,8 +48,10 @@
 #include "iproto_constants.h"
 #include "recovery.h"
 #include "replication.h"
+#include "schema.h"
 #include "trigger.h"
 #include "vclock.h"
+#include "xlog.h"
 #include "xrow.h"
 #include "xrow_io.h"
 #include "xstream.h"
@@ -55,6 +59,15 @@
 /** Report relay status to tx thread at least once per this interval */
 static const int RELAY_REPORT_INTERVAL = 1;
 
+/**
+ * WAL rows are sent to the replica in batches. A batch is
+ * sent when it grows bigger than RELAY_BATCH_SIZE, when its
+ * first row is older than RELAY_BATCH_DELAY seconds, or when
+ * the relay has read all WALs written so far.
+ */
+static const size_t RELAY_BATCH_SIZE = 128 * 1024;
+static const double RELAY_BATCH_DELAY = 0.01;
+
 /**
  * Cbus message to send status updates from relay to tx thread.
  */
@@ -65,6 +78,8 @@ struct relay_status_msg {
 	struct relay *relay;
 	/** New vclock */
 	struct vclock vclock;
+	/** Send statistics */
+	struct relay_stat stat;
 };
 
 /**
@@ -107,6 +122,30 @@ struct relay {
 	ev_tstamp wal_dir_rescan_delay;
 	/** Remote replica */
 	struct replica *replica;
+	/**
+	 * Set if the replica asked to compress the stream.
+	 * Rows are then sent in xlog tx blocks, which are
+	 * compressed if they are big enough, see
+	 * xlog_tx_block.
+	 */
+	bool compress;
+	/**
+	 * The thread owning the batch buffers, NULL if they
+	 * haven't been created.
+	 */
+	struct cord *batch_cord;
+	/** Rows encoded, but not sent to the replica yet. */
+	struct obuf batch;
+	/** Rows not sent to the replica yet, if @compress is set. */
+	struct xlog_tx_block block;
+	/** Time when the first row was added to @batch. */
+	double batch_start;
+	/** Part of the initial data requested by the replica. */
+	struct join_part join_part;
+	/** Number of initial rows of @join_part seen so far. */
+	uint64_t join_rows;
+	/** Send statistics. */
+	struct relay_stat stat;
 
 	/** Relay endpoint */
 	struct cbus_endpoint endpoint;
@@ -124,6 +163,8 @@ struct relay {
 		alignas(CACHELINE_SIZE)
 		/** Current vclock sent by relay */
 		struct vclock vclock;
+		/** Send statistics as of the last status update */
+		struct relay_stat stat;
 		/** The condition is signaled at relay exit. */
 		struct fiber_cond exit_cond;
 	} tx;
@@ -135,19 +176,67 @@ relay_vclock(const struct relay *relay)
 	return &relay->tx.vclock;
 }
 
+const struct relay_stat *
+relay_stat(const struct relay *relay)
+{
+	return &relay->tx.stat;
+}
+
+bool
+relay_is_compressed(const struct relay *relay)
+{
+	return relay->compress;
+}
+
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
+relay_flush_initial_join_rows(struct xstream *stream);
+static bool
+relay_accepts_initial_join_space(struct xstream *stream, uint32_t space_id);
+static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
+static void
+relay_flush_rows(struct xstream *stream);
+
+/**
+ * Start batching rows sent by the relay. Batch buffers are
+ * allocated from the slab cache of the current thread, so
+ * they must be used and destroyed in this thread only.
+ */
+static void
+relay_batch_create(struct relay *relay)
+{
+	assert(relay->batch_cord == NULL);
+	if (relay->compress && xlog_tx_block_create(&relay->block) != 0)
+		diag_raise();
+	obuf_create(&relay->batch, &cord()->slabc, 16 * 1024);
+	relay->batch_cord = cord();
+}
+
+static void
+relay_batch_destroy(struct relay *relay)
+{
+	if (relay->batch_cord == NULL)
+		return;
+	assert(relay->batch_cord == cord());
+	obuf_destroy(&relay->batch);
+	if (relay->compress)
+		xlog_tx_block_destroy(&relay->block);
+	relay->batch_cord = NULL;
+}
 
 static inline void
-relay_create(struct relay *relay, int fd, uint64_t sync,
-	     void (*stream_write)(struct xstream *, struct xrow_header *))
+relay_create(struct relay *relay, int fd, uint64_t sync, bool compress,
+	     void (*stream_write)(struct xstream *, struct xrow_header *),
+	     void (*stream_flush)(struct xstream *))
 {
 	memset(relay, 0, sizeof(*relay));
 	xstream_create(&relay->stream, stream_write);
+	relay->stream.flush = stream_flush;
 	coio_create(&relay->io, fd);
 	relay->sync = sync;
+	relay->compress = compress;
 }
 
 static inline void
@@ -172,10 +261,14 @@ relay_set_cord_name(int fd)
 }
 
 void
-relay_initial_join(int fd, uint64_t sync, struct vclock *vclock)
+relay_initial_join(int fd, uint64_t sync, struct vclock *vclock,
+		   bool compress, const struct join_part *part)
 {
 	struct relay relay;
-	relay_create(&relay, fd, sync, relay_send_initial_join_row);
+	relay_create(&relay, fd, sync, compress, relay_send_initial_join_row,
+		     relay_flush_initial_join_rows);
+	relay.stream.accepts_space = relay_accepts_initial_join_space;
+	relay.join_part = *part;
 	auto scope_guard = make_scoped_guard([&]{
 		relay_destroy(&relay);
 	});
@@ -190,9 +283,12 @@ relay_final_join_f(va_list ap)
 	struct relay *relay = va_arg(ap, struct relay *);
 	coio_enable();
 	relay_set_cord_name(relay->io.fd);
+	auto guard = make_scoped_guard([=]{
+		relay_batch_destroy(relay);
+	});
+	relay_batch_create(relay);
 
 	/* Send all WALs until stop_vclock */
-	assert(relay->stream.write != NULL);
 	recover_remaining_wals(relay->r, &relay->stream, &relay->stop_vclock);
 	assert(vclock_compare(&relay->r->vclock, &relay->stop_vclock) == 0);
 	return 0;
@@ -200,10 +296,11 @@ relay_final_join_f(va_list ap)
 
 void
 relay_final_join(int fd, uint64_t sync, struct vclock *start_vclock,
-	         struct vclock *stop_vclock)
+	         struct vclock *stop_vclock, bool compress)
 {
 	struct relay relay;
-	relay_create(&relay, fd, sync, relay_send_row);
+	relay_create(&relay, fd, sync, compress, relay_send_row,
+		     relay_flush_rows);
 	relay.r = recovery_new(cfg_gets("wal_dir"),
 			       cfg_geti("force_recovery"),
 			       start_vclock);
@@ -246,6 +343,7 @@ tx_status_update(struct cmsg *msg)
 {
 	struct relay_status_msg *status = (struct relay_status_msg *)msg;
 	vclock_copy(&status->relay->tx.vclock, &status->vclock);
+	status->relay->tx.stat = status->stat;
 	static const struct cmsg_hop route[] = {
 		{relay_status_update, NULL}
 	};
@@ -323,7 +421,6 @@ relay_subscribe_f(va_list ap)
 	struct relay *relay = va_arg(ap, struct relay *);
 	struct recovery *r = relay->r;
 	coio_enable();
-	relay->stream.write = relay_send_row;
 	cbus_endpoint_create(&relay->endpoint, cord_name(cord()),
 			     fiber_schedule_cb, fiber());
 	cpipe_create(&relay->tx_pipe, "tx");
@@ -339,7 +436,9 @@ relay_subscribe_f(va_list ap)
 	auto guard = make_scoped_guard([&]{
 		trigger_clear(&on_close_log);
 		relay_cbus_detach(relay);
+		relay_batch_destroy(relay);
 	});
+	relay_batch_create(relay);
 	relay_set_cord_name(relay->io.fd);
 	recovery_follow_local(r, &relay->stream, fiber_name(fiber()),
 			      relay->wal_dir_rescan_delay);
@@ -411,6 +510,7 @@ relay_subscribe_f(va_list ap)
 		};
 		cmsg_init(&relay->status_msg.msg, route);
 		vclock_copy(&relay->status_msg.vclock, &r->vclock);
+		relay->status_msg.stat = relay->stat;
 		relay->status_msg.relay = relay;
 		cpipe_push(&relay->tx_pipe, &relay->status_msg.msg);
 	}
@@ -426,7 +526,7 @@ relay_subscribe_f(va_list ap)
 /** Replication acceptor fiber handler. */
 void
 relay_subscribe(int fd, uint64_t sync, struct replica *replica,
-		struct vclock *replica_clock)
+		struct vclock *replica_clock, bool compress)
 {
 	assert(replica->id != REPLICA_ID_NIL);
 	/* Don't allow multiple relays for the same replica */
@@ -449,7 +549,8 @@ relay_subscribe(int fd, uint64_t sync, struct replica *replica,
 	}
 
 	struct relay relay;
-	relay_create(&relay, fd, sync, relay_send_row);
+	relay_create(&relay, fd, sync, compress, relay_send_row,
+		     relay_flush_rows);
 	relay.r = recovery_new(cfg_gets("wal_dir"),
 			       cfg_geti("force_recovery"),
 			       replica_clock);
@@ -498,11 +599,165 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 		fiber_sleep(inj->dparam);
 }
 
+/** Return the size of rows accumulated in the batch. */
+static inline size_t
+relay_batch_size(struct relay *relay)
+{
+	if (relay->compress)
+		return xlog_tx_block_size(&relay->block);
+	return obuf_size(&relay->batch);
+}
+
+/**
+ * Send the rows accumulated in the batch to the replica,
+ * packing and compressing them into an xlog tx block first
+ * if the stream is compressed.
+ */
+static void
+relay_flush(struct relay *relay)
+{
+	size_t size = relay_batch_size(relay);
+	if (size == 0)
+		return;
+	struct obuf *data = &relay->batch;
+	if (relay->compress) {
+		double start = clock_thread();
+		if (xlog_tx_block_encode(&relay->block) != 0)
+			diag_raise();
+		relay->stat.compress_time += clock_thread() - start;
+		data = relay->block.data;
+	}
+	size_t data_size = obuf_size(data);
+	coio_writev(&relay->io, data->iov, obuf_iovcnt(data), data_size);
+	relay->stat.raw_bytes += size;
+	relay->stat.bytes += data_size;
+	relay->stat.writes++;
+	if (relay->compress)
+		xlog_tx_block_reset(&relay->block);
+	else
+		obuf_reset(&relay->batch);
+}
+
+static bool
+relay_accepts_initial_join_space(struct xstream *stream, uint32_t space_id)
+{
+	struct relay *relay = container_of(stream, struct relay, stream);
+	const struct join_part *part = &relay->join_part;
+	/*
+	 * System spaces are sent first over the connection
+	 * of part 0 so that the replica has the schema by
+	 * the time rows of other parts arrive.
+	 */
+	if (space_id_is_system(space_id))
+		return part->id == 0;
+	return space_id % part->count == part->id;
+}
+
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 {
 	struct relay *relay = container_of(stream, struct relay, stream);
-	relay_send(relay, row);
+	if (relay->join_part.count > 1) {
+		struct request request;
+		if (xrow_decode_dml(row, &request, 0) != 0)
+			diag_raise();
+		if (!relay_accepts_initial_join_space(stream,
+						      request.space_id))
+			return;
+	}
+	/* Skip rows the replica got before reconnect. */
+	if (++relay->join_rows <= relay->join_part.skip)
+		return;
+	struct errinj *inj = errinj(ERRINJ_RELAY_BREAK_JOIN, ERRINJ_INT);
+	if (inj != NULL && inj->iparam >= 0 && relay->join_part.skip == 0 &&
+	    relay->join_rows > (uint64_t) inj->iparam) {
+		/* Break the connection so that the replica resumes. */
+		shutdown(relay->io.fd, SHUT_RDWR);
+		tnt_raise(SocketError, relay->io.fd, "initial join");
+	}
+	if (!relay->compress) {
+		relay_send(relay, row);
+		return;
+	}
+	/*
+	 * Engines feed the initial join stream from their own
+	 * threads, so the batch is created in the thread that
+	 * sends the first row and destroyed when the engine
+	 * flushes the stream.
+	 */
+	if (relay->batch_cord == NULL)
+		relay_batch_create(relay);
+	relay_batch_row(relay, row);
+}
+
+static void
+relay_flush_initial_join_rows(struct xstream *stream)
+{
+	struct relay *relay = container_of(stream, struct relay, stream);
+	if (relay->batch_cord == NULL)
+		return;
+	auto guard = make_scoped_guard([=]{
+		relay_batch_destroy(relay);
+	});
+	relay_flush(relay);
+}
+
+static void
+relay_flush_rows(struct xstream *stream)
+{
+	struct relay *relay = container_of(stream, struct relay, stream);
+	relay_flush(relay);
+}
+
+/**
+ * Encode a row into the batch. The row body is copied as is,
+ * only the header is encoded, since it must carry the sync
+ * of the replica's request.
+ */
+static void
+relay_batch_add_row(struct relay *relay, struct xrow_header *packet)
+{
+	if (relay->compress) {
+		/*
+		 * Rows of an xlog tx don't carry sync, the
+		 * replica doesn't check it in the row stream.
+		 */
+		if (xlog_tx_block_add_row(&relay->block, packet) < 0)
+			diag_raise();
+		return;
+	}
+	packet->sync = relay->sync;
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(packet, iov);
+	for (int i = 0; i < iovcnt; i++) {
+		if (obuf_dup(&relay->batch, iov[i].iov_base,
+			     iov[i].iov_len) < iov[i].iov_len) {
+			tnt_raise(OutOfMemory, iov[i].iov_len,
+				  "obuf", "relay batch");
+		}
+	}
+}
+
+/** Add a row to the batch, send the batch if it is due. */
+static void
+relay_batch_row(struct relay *relay, struct xrow_header *packet)
+{
+	assert(relay->batch_cord == cord());
+	if (relay_batch_size(relay) == 0)
+		relay->batch_start = clock_monotonic();
+	relay_batch_add_row(relay, packet);
+	relay->stat.rows++;
+	fiber_gc();
+
+	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
+	if (inj != NULL && inj->dparam > 0) {
+		relay_flush(relay);
+		fiber_sleep(inj->dparam);
+		return;
+	}
+	if (relay_batch_size(relay) >= RELAY_BATCH_SIZE ||
+	    clock_monotonic() - relay->batch_start >= RELAY_BATCH_DELAY)
+		relay_flush(relay);
 }
 
 /** Send a single row to the client. */
@@ -518,6 +773,6 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 	 */
 	if (relay->replica == NULL ||
 	    packet->replica_id != relay->replica->id) {
-		relay_send(relay, packet);
+		relay_batch_row(relay, packet);
 	}
 }
@@ -31,17 +31,33 @@
  * SUCH DAMAGE.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+struct join_part;
 struct relay;
 struct replica;
 struct tt_uuid;
 struct vclock;
 
+/** Statistics of data sent by a relay. */
+struct relay_stat {
+	/** Number of rows sent to the replica. */
+	int64_t rows;
+	/** Number of bytes sent to the replica. */
+	int64_t bytes;
+	/** Size of the sent rows before compression. */
+	int64_t raw_bytes;
+	/** Number of socket writes, each sending a batch of rows. */
+	int64_t writes;
+	/** CPU time spent compressing rows, in seconds. */
+	double compress_time;
+};
+
 /**
  * Returns relay's vclock
  * @param relay relay
@@ -50,6 +66,17 @@ struct vclock;
 const struct vclock *
 relay_vclock(const struct relay *relay);
 
+/**
+ * Returns relay's send statistics, as of the last status
+ * report delivered to the tx thread.
+ */
+const struct relay_stat *
+relay_stat(const struct relay *relay);
+
+/** Returns true if the relay compresses the stream. */
+bool
+relay_is_compressed(const struct relay *relay);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -59,28 +86,33 @@ relay_vclock(const struct relay *relay);
  *
  * @param fd        client connection
  * @param sync      sync from incoming JOIN request
- * @param vclock    vclock of the last checkpoint
+ * @param vclock    vclock of the checkpoint to send
+ * @param compress  send rows in compressed xlog tx blocks
+ * @param part      part of the initial data to send
  */
 void
-relay_initial_join(int fd, uint64_t sync, struct vclock *vclock);
+relay_initial_join(int fd, uint64_t sync, struct vclock *vclock,
+		   bool compress, const struct join_part *part);
 
 /**
  * Send final JOIN rows to the replica.
  *
  * @param fd        client connection
  * @param sync      sync from incoming JOIN request
+ * @param compress  send rows in compressed xlog tx blocks
  */
 void
 relay_final_join(int fd, uint64_t sync, struct vclock *start_vclock,
-	         struct vclock *stop_vclock);
+	         struct vclock *stop_vclock, bool compress);
 
 /**
  * Subscribe a replica to updates.
  *
+ * @param compress  send rows in compressed xlog tx blocks
  * @return none.
  */
 void
 relay_subscribe(int fd, uint64_t sync, struct replica *replica,
-		struct vclock *replica_vclock);
+		struct vclock *replica_vclock, bool compress);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -69,8 +69,7 @@ struct latch schema_lock = LATCH_INITIALIZER(schema_lock);
 bool
 space_is_system(struct space *space)
 {
-	return space->def->id > BOX_SYSTEM_ID_MIN &&
-		space->def->id < BOX_SYSTEM_ID_MAX;
+	return space_id_is_system(space->def->id);
 }
 
 /** Return space by its number */
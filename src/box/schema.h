@@ -136,8 +136,19 @@ enum {
 	BOX_TRUNCATE_FIELD_COUNT = 1,
 };
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/**
+ * Return true if the space id belongs to the reserved
+ * range of system spaces.
+ */
+static inline bool
+space_id_is_system(uint32_t id)
+{
+	return id > BOX_SYSTEM_ID_MIN && id < BOX_SYSTEM_ID_MAX;
+}
+
 extern uint32_t schema_version;
 
 #if defined(__cplusplus)
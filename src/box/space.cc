@@ -38,6 +38,9 @@
 #include "trigger.h"
 #include "user.h"
 #include "session.h"
+#include "schema.h"
+#include "info.h"
+#include "clock.h"
 
 void
 access_check_space(struct space *space, uint8_t access)
@@ -107,6 +110,7 @@ space_new(struct space_def *def, struct rlist *key_list)
 	space->index_id_max = index_id_max;
 	rlist_create(&space->on_replace);
 	rlist_create(&space->on_stmt_begin);
+	latency_stat_create(&space->latency_stat);
 	auto scoped_guard = make_scoped_guard([=] { space_delete(space); });
 
 	space->index_map = (Index **)((char *) space + sizeof(*space) +
@@ -177,6 +181,7 @@ space_delete(struct space *space)
 
 	trigger_destroy(&space->on_replace);
 	trigger_destroy(&space->on_stmt_begin);
+	latency_stat_destroy(&space->latency_stat);
 	space_def_delete(space->def);
 	free(space);
 }
@@ -236,6 +241,39 @@ space_bsize_rollback(struct space *space, ptrdiff_t bsize_change)
 	space->bsize -= bsize_change;
 }
 
+void
+space_collect_latency(uint32_t space_id, uint32_t index_id,
+		      enum latency_stat_op op, double start)
+{
+	double latency = clock_monotonic() - start;
+	struct space *space = space_by_id(space_id);
+	if (space == NULL)
+		return;
+	latency_stat_collect(&space->latency_stat, op, latency);
+	if (op != LATENCY_STAT_SELECT && op != LATENCY_STAT_UPDATE &&
+	    op != LATENCY_STAT_DELETE)
+		return;
+	Index *index = space_index(space, index_id);
+	if (index != NULL)
+		latency_stat_collect(&index->latency_stat, op, latency);
+}
+
+void
+space_latency_info(struct space *space, struct info_handler *h)
+{
+	latency_stat_info(&space->latency_stat, h);
+	info_table_begin(h, "index");
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		Index *index = space->index[i];
+		if (latency_stat_is_empty(&index->latency_stat))
+			continue;
+		info_table_begin(h, index->index_def->name);
+		latency_stat_info(&index->latency_stat, h);
+		info_table_end(h);
+	}
+	info_table_end(h);
+}
+
 size_t
 space_bsize(struct space *space)
 {
@@ -32,6 +32,7 @@
  */
 #include "key_def.h"
 #include "small/rlist.h"
+#include "latency_stat.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -80,6 +81,8 @@ struct space {
 	uint64_t truncate_count;
 	/** Enable/disable triggers. */
 	bool run_triggers;
+	/** Latency of requests to the space, box.space.X:stat(). */
+	struct latency_stat latency_stat;
 
 	/** Default tuple format used by this space */
 	struct tuple_format *format;
@@ -278,6 +281,24 @@ space_bsize_update(struct space *space,
 void
 space_bsize_rollback(struct space *space, ptrdiff_t bsize_change);
 
+/**
+ * Account a request of type @op to space @space_id which
+ * started at @start (clock_monotonic()). Select, update and
+ * delete are also accounted in the index @index_id they were
+ * addressed to. The space is looked up by id, since it may
+ * have been altered or dropped while the request yielded.
+ */
+void
+space_collect_latency(uint32_t space_id, uint32_t index_id,
+		      enum latency_stat_op op, double start);
+
+/**
+ * Append latency statistics of a space and its indexes
+ * to the current table of @h, see box.space.X:stat().
+ */
+void
+space_latency_info(struct space *space, struct info_handler *h);
+
 #endif /* defined(__cplusplus) */
 
 #endif /* TARANTOOL_BOX_SPACE_H_INCLUDED */
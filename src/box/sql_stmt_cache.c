@@ -0,0 +1,337 @@
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "sql_stmt_cache.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <small/rlist.h>
+
+#include "assoc.h"
+#include "diag.h"
+#include "errcode.h"
+#include "say.h"
+#include "trivia/util.h"
+#include "schema.h"
+#include "sql.h"
+#include "sql/sqlite3.h"
+
+/** A cached prepared statement. */
+struct sql_stmt_entry {
+	/** Statement id, hash of @sql. */
+	uint32_t id;
+	/** Schema version @stmt was prepared against. */
+	uint32_t schema_version;
+	/** Prepared statement. */
+	struct sqlite3_stmt *stmt;
+	/** Set while @stmt is being executed. */
+	bool is_busy;
+	/** Link in sql_stmt_cache::lru. */
+	struct rlist in_lru;
+	/** Length of @sql. */
+	uint32_t sql_len;
+	/** Statement text, not nul-terminated. */
+	char sql[0];
+};
+
+/** Prepared statement cache state. */
+struct sql_stmt_cache {
+	/** Statement id -> struct sql_stmt_entry. */
+	struct mh_i32ptr_t *index;
+	/** All cached statements, the most recently used first. */
+	struct rlist lru;
+	/** Number of cached statements. */
+	uint32_t size;
+	/** Max number of cached statements. */
+	uint32_t max_size;
+};
+static struct sql_stmt_cache cache;
+
+static int
+sql_stmt_compile(const char *sql, uint32_t len, struct sqlite3_stmt **stmt)
+{
+	sqlite3 *db = sql_get();
+	if (db == NULL) {
+		diag_set(ClientError, ER_LOADING);
+		return -1;
+	}
+	if (sqlite3_prepare_v2(db, sql, len, stmt, NULL) != SQLITE_OK) {
+		diag_set(ClientError, ER_SQL_EXECUTE, sqlite3_errmsg(db));
+		return -1;
+	}
+	assert(*stmt != NULL);
+	return 0;
+}
+
+static inline bool
+sql_stmt_entry_matches(const struct sql_stmt_entry *entry,
+		       const char *sql, uint32_t len)
+{
+	return entry->sql_len == len && memcmp(entry->sql, sql, len) == 0;
+}
+
+static struct sql_stmt_entry *
+sql_stmt_cache_lookup(uint32_t id)
+{
+	mh_int_t k = mh_i32ptr_find(cache.index, id, NULL);
+	if (k == mh_end(cache.index))
+		return NULL;
+	return mh_i32ptr_node(cache.index, k)->val;
+}
+
+static void
+sql_stmt_entry_delete(struct sql_stmt_entry *entry)
+{
+	assert(!entry->is_busy);
+	mh_int_t k = mh_i32ptr_find(cache.index, entry->id, NULL);
+	assert(k != mh_end(cache.index));
+	mh_i32ptr_del(cache.index, k, NULL);
+	rlist_del_entry(entry, in_lru);
+	assert(cache.size > 0);
+	cache.size--;
+	sqlite3_finalize(entry->stmt);
+	free(entry);
+}
+
+/**
+ * Evict the least recently used statements until there are
+ * at most @max_size of them. Statements that are being executed
+ * are skipped.
+ */
+static void
+sql_stmt_cache_evict(uint32_t max_size)
+{
+	struct sql_stmt_entry *entry;
+	entry = rlist_last_entry(&cache.lru, struct sql_stmt_entry, in_lru);
+	while (cache.size > max_size && &entry->in_lru != &cache.lru) {
+		struct sql_stmt_entry *prev = rlist_prev_entry(entry, in_lru);
+		if (!entry->is_busy)
+			sql_stmt_entry_delete(entry);
+		entry = prev;
+	}
+}
+
+/**
+ * Put a statement prepared from @sql to the cache.
+ * The id must not be in use.
+ */
+static struct sql_stmt_entry *
+sql_stmt_entry_new(uint32_t id, const char *sql, uint32_t len,
+		   struct sqlite3_stmt *stmt)
+{
+	assert(cache.max_size > 0);
+	assert(sql_stmt_cache_lookup(id) == NULL);
+	size_t size = sizeof(struct sql_stmt_entry) + len;
+	struct sql_stmt_entry *entry = malloc(size);
+	if (entry == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "struct sql_stmt_entry");
+		return NULL;
+	}
+	struct mh_i32ptr_node_t node = { id, entry };
+	if (mh_i32ptr_put(cache.index, &node, NULL, NULL) ==
+	    mh_end(cache.index)) {
+		diag_set(OutOfMemory, 0, "mh_i32ptr_put", "sql_stmt_cache");
+		free(entry);
+		return NULL;
+	}
+	entry->id = id;
+	entry->schema_version = schema_version;
+	entry->stmt = stmt;
+	entry->is_busy = false;
+	entry->sql_len = len;
+	memcpy(entry->sql, sql, len);
+	sql_stmt_cache_evict(cache.max_size - 1);
+	rlist_add_entry(&cache.lru, entry, in_lru);
+	cache.size++;
+	return entry;
+}
+
+/**
+ * Check out the statement of a cache entry for execution,
+ * re-preparing it if the schema has changed since it was
+ * prepared.
+ */
+static struct sqlite3_stmt *
+sql_stmt_entry_checkout(struct sql_stmt_entry *entry)
+{
+	assert(!entry->is_busy);
+	if (entry->schema_version != schema_version) {
+		struct sqlite3_stmt *stmt;
+		if (sql_stmt_compile(entry->sql, entry->sql_len, &stmt) != 0)
+			return NULL;
+		sqlite3_finalize(entry->stmt);
+		entry->stmt = stmt;
+		entry->schema_version = schema_version;
+	}
+	rlist_move_entry(&cache.lru, entry, in_lru);
+	entry->is_busy = true;
+	return entry->stmt;
+}
+
+void
+sql_stmt_cache_init(void)
+{
+	cache.index = mh_i32ptr_new();
+	if (cache.index == NULL)
+		panic("failed to allocate SQL statement cache");
+	rlist_create(&cache.lru);
+	cache.size = 0;
+	cache.max_size = 0;
+}
+
+void
+sql_stmt_cache_free(void)
+{
+	struct sql_stmt_entry *entry, *next;
+	rlist_foreach_entry_safe(entry, &cache.lru, in_lru, next) {
+		sqlite3_finalize(entry->stmt);
+		free(entry);
+	}
+	mh_i32ptr_delete(cache.index);
+}
+
+void
+sql_stmt_cache_set_size(uint32_t size)
+{
+	cache.max_size = size;
+	sql_stmt_cache_evict(size);
+}
+
+int
+sql_stmt_cache_prepare(const char *sql, uint32_t len, uint32_t *id)
+{
+	if (cache.max_size == 0) {
+		diag_set(ClientError, ER_SQL_EXECUTE,
+			 "prepared statement cache is disabled");
+		return -1;
+	}
+	*id = mh_strn_hash(sql, len);
+	struct sql_stmt_entry *entry = sql_stmt_cache_lookup(*id);
+	if (entry != NULL) {
+		if (!sql_stmt_entry_matches(entry, sql, len)) {
+			/*
+			 * Hash collision: the statement can still
+			 * be executed by text, but not by id.
+			 */
+			diag_set(ClientError, ER_SQL_EXECUTE,
+				 "prepared statement id collision");
+			return -1;
+		}
+		if (entry->is_busy) {
+			rlist_move_entry(&cache.lru, entry, in_lru);
+			return 0;
+		}
+		/* Report compilation errors on PREPARE. */
+		if (sql_stmt_entry_checkout(entry) == NULL)
+			return -1;
+		entry->is_busy = false;
+		return 0;
+	}
+	struct sqlite3_stmt *stmt;
+	if (sql_stmt_compile(sql, len, &stmt) != 0)
+		return -1;
+	if (sql_stmt_entry_new(*id, sql, len, stmt) == NULL) {
+		sqlite3_finalize(stmt);
+		return -1;
+	}
+	return 0;
+}
+
+struct sqlite3_stmt *
+sql_stmt_cache_get(const char *sql, uint32_t len,
+		   struct sql_stmt_entry **entry)
+{
+	*entry = NULL;
+	uint32_t id = mh_strn_hash(sql, len);
+	struct sql_stmt_entry *e = sql_stmt_cache_lookup(id);
+	if (e != NULL && !e->is_busy && sql_stmt_entry_matches(e, sql, len)) {
+		struct sqlite3_stmt *stmt = sql_stmt_entry_checkout(e);
+		if (stmt != NULL)
+			*entry = e;
+		return stmt;
+	}
+	/*
+	 * The statement isn't cached, is being executed or its
+	 * id is taken by another statement.
+	 */
+	struct sqlite3_stmt *stmt;
+	if (sql_stmt_compile(sql, len, &stmt) != 0)
+		return NULL;
+	if (e == NULL && cache.max_size > 0) {
+		e = sql_stmt_entry_new(id, sql, len, stmt);
+		if (e == NULL) {
+			sqlite3_finalize(stmt);
+			return NULL;
+		}
+		e->is_busy = true;
+		*entry = e;
+	}
+	return stmt;
+}
+
+struct sqlite3_stmt *
+sql_stmt_cache_find(uint32_t id, struct sql_stmt_entry **entry)
+{
+	*entry = NULL;
+	struct sql_stmt_entry *e = sql_stmt_cache_lookup(id);
+	if (e == NULL) {
+		diag_set(ClientError, ER_SQL_EXECUTE,
+			 tt_sprintf("prepared statement %u not found", id));
+		return NULL;
+	}
+	if (!e->is_busy) {
+		struct sqlite3_stmt *stmt = sql_stmt_entry_checkout(e);
+		if (stmt != NULL)
+			*entry = e;
+		return stmt;
+	}
+	/* The statement is being executed, use a private copy. */
+	struct sqlite3_stmt *stmt;
+	if (sql_stmt_compile(e->sql, e->sql_len, &stmt) != 0)
+		return NULL;
+	return stmt;
+}
+
+void
+sql_stmt_cache_put(struct sqlite3_stmt *stmt, struct sql_stmt_entry *entry)
+{
+	if (entry == NULL) {
+		sqlite3_finalize(stmt);
+		return;
+	}
+	assert(entry->is_busy);
+	assert(entry->stmt == stmt);
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+	entry->is_busy = false;
+	/* The cache may have been shrunk while it was executed. */
+	sql_stmt_cache_evict(cache.max_size);
+}
@@ -0,0 +1,128 @@
+#ifndef TARANTOOL_BOX_SQL_STMT_CACHE_H_INCLUDED
+#define TARANTOOL_BOX_SQL_STMT_CACHE_H_INCLUDED
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Cache of prepared SQL statements.
+ *
+ * A statement is looked up by its text or by its id, which is
+ * a hash of the text returned to a client in response to the
+ * PREPARE request, so that the client can execute the statement
+ * without sending the text again. A statement prepared against
+ * an older schema version is transparently re-prepared. The cache
+ * holds at most box.cfg.sql_stmt_cache_size statements, the least
+ * recently used are evicted first.
+ *
+ * A cached statement is checked out while it is executed. If
+ * the same statement is requested meanwhile, e.g. by another
+ * fiber, a private copy is prepared, which is finalized when
+ * returned to the cache.
+ */
+
+struct sqlite3_stmt;
+struct sql_stmt_entry;
+
+/** Initialize the statement cache. */
+void
+sql_stmt_cache_init(void);
+
+/** Finalize all cached statements and free the cache. */
+void
+sql_stmt_cache_free(void);
+
+/**
+ * Set the max number of cached statements, evicting the least
+ * recently used ones if there are too many. Zero disables
+ * the cache.
+ */
+void
+sql_stmt_cache_set_size(uint32_t size);
+
+/**
+ * Prepare a statement and put it to the cache.
+ * @param sql Statement text.
+ * @param len Length of @a sql.
+ * @param[out] id Id to execute the statement with.
+ *
+ * @retval  0 Success.
+ * @retval -1 Compilation error, the cache is disabled or
+ *            another statement has the same id. Diag is set.
+ */
+int
+sql_stmt_cache_prepare(const char *sql, uint32_t len, uint32_t *id);
+
+/**
+ * Get a statement by text for execution, preparing it if it
+ * isn't in the cache. The statement must be returned with
+ * sql_stmt_cache_put() when done.
+ * @param sql Statement text.
+ * @param len Length of @a sql.
+ * @param[out] entry Cache entry to pass to sql_stmt_cache_put().
+ *
+ * @retval not NULL Prepared statement.
+ * @retval     NULL Compilation error, diag is set.
+ */
+struct sqlite3_stmt *
+sql_stmt_cache_get(const char *sql, uint32_t len,
+		   struct sql_stmt_entry **entry);
+
+/**
+ * Get a statement by id returned by sql_stmt_cache_prepare().
+ * @sa sql_stmt_cache_get().
+ *
+ * @retval not NULL Prepared statement.
+ * @retval     NULL The statement isn't in the cache or can't be
+ *                  re-prepared against the current schema.
+ *                  Diag is set.
+ */
+struct sqlite3_stmt *
+sql_stmt_cache_find(uint32_t id, struct sql_stmt_entry **entry);
+
+/**
+ * Return a statement obtained with sql_stmt_cache_get() or
+ * sql_stmt_cache_find() to the cache. The statement is reset
+ * and its bindings are cleared, or it is finalized if it
+ * isn't cached.
+ */
+void
+sql_stmt_cache_put(struct sqlite3_stmt *stmt, struct sql_stmt_entry *entry);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_BOX_SQL_STMT_CACHE_H_INCLUDED */
@@ -341,7 +341,7 @@ mp_compare_scalar(const char *field_a, const char *field_b)
  * @retval <0 if field_a < field_b
  * @retval >0 if field_a > field_b
  */
-static int
+static inline int
 tuple_compare_field(const char *field_a, const char *field_b,
 		    int8_t type)
 {
@@ -511,9 +511,17 @@ tuple_compare_with_key_slowpath(const struct tuple *tuple, const char *key,
 						   part_count, key_def);
 }
 
+/**
+ * Compare two fields of type TYPE. The switch in
+ * tuple_compare_field() is resolved at compile time,
+ * a few types have a hand-written specialization.
+ */
 template <int TYPE>
 static inline int
-field_compare(const char **field_a, const char **field_b);
+field_compare(const char **field_a, const char **field_b)
+{
+	return tuple_compare_field(*field_a, *field_b, TYPE);
+}
 
 template <>
 inline int
@@ -537,7 +545,13 @@ field_compare<FIELD_TYPE_STRING>(const char **field_a, const char **field_b)
 
 template <int TYPE>
 static inline int
-field_compare_and_next(const char **field_a, const char **field_b);
+field_compare_and_next(const char **field_a, const char **field_b)
+{
+	int r = tuple_compare_field(*field_a, *field_b, TYPE);
+	mp_next(field_a);
+	mp_next(field_b);
+	return r;
+}
 
 template <>
 inline int
@@ -566,6 +580,99 @@ field_compare_and_next<FIELD_TYPE_STRING>(const char **field_a,
 	return r;
 }
 
+/**
+ * Field types comparators are specialized for when field
+ * numbers are only known at run time, see
+ * tuple_compare_create(). A specialized comparator is
+ * looked up in a table by the signature of key part types:
+ * the i-th digit of the signature in base CMP_TYPE_COUNT is
+ * the position of the i-th part type in this list.
+ */
+#define CMP_TYPES(_)						\
+	_(FIELD_TYPE_UNSIGNED)					\
+	_(FIELD_TYPE_STRING)					\
+	_(FIELD_TYPE_INTEGER)					\
+	_(FIELD_TYPE_NUMBER)					\
+	_(FIELD_TYPE_SCALAR)
+
+enum {
+#define CMP_TYPE_ONE(type) + 1
+	CMP_TYPE_COUNT = 0 CMP_TYPES(CMP_TYPE_ONE),
+#undef CMP_TYPE_ONE
+	/** Max number of parts to generate a comparator for. */
+	CMP_MAX_PARTS = 4,
+	/** CMP_TYPE_COUNT ^ CMP_MAX_PARTS */
+	CMP_MAX_SIGNATURES = CMP_TYPE_COUNT * CMP_TYPE_COUNT *
+			     CMP_TYPE_COUNT * CMP_TYPE_COUNT,
+};
+
+/**
+ * Return the signature of key part types or -1 if there is
+ * no specialized comparator for the key definition.
+ */
+static int
+cmp_signature(const struct key_def *def)
+{
+	static const enum field_type types[] = {
+#define CMP_TYPE_MEMBER(type) type,
+		CMP_TYPES(CMP_TYPE_MEMBER)
+#undef CMP_TYPE_MEMBER
+	};
+	if (def->part_count == 0 || def->part_count > CMP_MAX_PARTS)
+		return -1;
+	int signature = 0;
+	for (uint32_t i = 0; i < def->part_count; i++) {
+		int pos = 0;
+		while (pos < CMP_TYPE_COUNT && types[pos] != def->parts[i].type)
+			pos++;
+		if (pos == CMP_TYPE_COUNT)
+			return -1;
+		signature = signature * CMP_TYPE_COUNT + pos;
+	}
+	return signature;
+}
+
+/**
+ * Fill a table of comparators indexed by the type signature
+ * with instances of COMPARATOR<TYPES...> for every combination
+ * of PART_COUNT types appended to TYPES.
+ */
+template <template <int...> class COMPARATOR, typename F,
+	  int PART_COUNT, int ...TYPES>
+struct CmpTableGen {
+	static void fill(F *table, int signature)
+	{
+		int i = 0;
+#define CMP_TYPE_FILL(type)						\
+		CmpTableGen<COMPARATOR, F, PART_COUNT - 1, TYPES..., type>::	\
+			fill(table, signature * CMP_TYPE_COUNT + i++);
+		CMP_TYPES(CMP_TYPE_FILL)
+#undef CMP_TYPE_FILL
+	}
+};
+
+template <template <int...> class COMPARATOR, typename F, int ...TYPES>
+struct CmpTableGen<COMPARATOR, F, 0, TYPES...> {
+	static void fill(F *table, int signature)
+	{
+		table[signature] = COMPARATOR<TYPES...>::compare;
+	}
+};
+
+/**
+ * Fill @table[part_count - 1][signature] for every part count
+ * up to CMP_MAX_PARTS.
+ */
+template <template <int...> class COMPARATOR, typename F>
+static void
+cmp_table_fill(F table[CMP_MAX_PARTS][CMP_MAX_SIGNATURES])
+{
+	CmpTableGen<COMPARATOR, F, 1>::fill(table[0], 0);
+	CmpTableGen<COMPARATOR, F, 2>::fill(table[1], 0);
+	CmpTableGen<COMPARATOR, F, 3>::fill(table[2], 0);
+	CmpTableGen<COMPARATOR, F, 4>::fill(table[3], 0);
+}
+
 /* Tuple comparator */
 namespace /* local symbols */ {
 
@@ -659,8 +766,87 @@ struct TupleCompare<0, TYPE, MORE_TYPES...> {
 					format_a, format_b, field_a, field_b);
 	}
 };
+
+/**
+ * Comparator specialized by key part types, field numbers
+ * are taken from the key definition.
+ */
+template <int TYPE, int ...MORE_TYPES> struct FieldCompareByType { };
+
+template <int TYPE, int TYPE2, int ...MORE_TYPES>
+struct FieldCompareByType<TYPE, TYPE2, MORE_TYPES...>
+{
+	inline static int compare(const struct tuple *tuple_a,
+				  const struct tuple *tuple_b,
+				  const struct tuple_format *format_a,
+				  const struct tuple_format *format_b,
+				  const struct key_part *part,
+				  const char *field_a,
+				  const char *field_b)
+	{
+		int r;
+		if (part[0].fieldno + 1 == part[1].fieldno) {
+			if ((r = field_compare_and_next<TYPE>(&field_a,
+							      &field_b)) != 0)
+				return r;
+		} else {
+			if ((r = field_compare<TYPE>(&field_a, &field_b)) != 0)
+				return r;
+			field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
+						  tuple_field_map(tuple_a),
+						  part[1].fieldno);
+			field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
+						  tuple_field_map(tuple_b),
+						  part[1].fieldno);
+		}
+		return FieldCompareByType<TYPE2, MORE_TYPES...>::
+			compare(tuple_a, tuple_b, format_a, format_b,
+				part + 1, field_a, field_b);
+	}
+};
+
+template <int TYPE>
+struct FieldCompareByType<TYPE>
+{
+	inline static int compare(const struct tuple *,
+				  const struct tuple *,
+				  const struct tuple_format *,
+				  const struct tuple_format *,
+				  const struct key_part *,
+				  const char *field_a,
+				  const char *field_b)
+	{
+		return field_compare<TYPE>(&field_a, &field_b);
+	}
+};
+
+template <int ...TYPES>
+struct TupleCompareByType
+{
+	static int compare(const struct tuple *tuple_a,
+			   const struct tuple *tuple_b,
+			   const struct key_def *key_def)
+	{
+		struct tuple_format *format_a = tuple_format(tuple_a);
+		struct tuple_format *format_b = tuple_format(tuple_b);
+		const struct key_part *part = key_def->parts;
+		const char *field_a, *field_b;
+		field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
+					  tuple_field_map(tuple_a),
+					  part->fieldno);
+		field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
+					  tuple_field_map(tuple_b),
+					  part->fieldno);
+		return FieldCompareByType<TYPES...>::
+			compare(tuple_a, tuple_b, format_a, format_b,
+				part, field_a, field_b);
+	}
+};
 } /* end of anonymous namespace */
 
+/** Comparators by part count and type signature. */
+static tuple_compare_t cmp_by_type[CMP_MAX_PARTS][CMP_MAX_SIGNATURES];
+
 struct comparator_signature {
 	tuple_compare_t f;
 	uint32_t p[64];
@@ -701,6 +887,17 @@ tuple_compare_create(const struct key_def *def) {
 		if (i == def->part_count && cmp_arr[k].p[i * 2] == UINT32_MAX)
 			return cmp_arr[k].f;
 	}
+	int signature = cmp_signature(def);
+	if (signature >= 0) {
+		/*
+		 * Fill the table on first use. Initialization
+		 * of a local static is thread-safe in C++11.
+		 */
+		static bool is_filled =
+			(cmp_table_fill<TupleCompareByType>(cmp_by_type), true);
+		(void) is_filled;
+		return cmp_by_type[def->part_count - 1][signature];
+	}
 	if (key_def_is_sequential(def))
 		return tuple_compare_sequential;
 	return tuple_compare_slowpath;
@@ -711,7 +908,11 @@ tuple_compare_create(const struct key_def *def) {
 /* {{{ tuple_compare_with_key */
 
 template <int TYPE>
-static inline int field_compare_with_key(const char **field, const char **key);
+static inline int
+field_compare_with_key(const char **field, const char **key)
+{
+	return tuple_compare_field(*field, *key, TYPE);
+}
 
 template <>
 inline int
@@ -735,7 +936,13 @@ field_compare_with_key<FIELD_TYPE_STRING>(const char **field, const char **key)
 
 template <int TYPE>
 static inline int
-field_compare_with_key_and_next(const char **field_a, const char **field_b);
+field_compare_with_key_and_next(const char **field_a, const char **field_b)
+{
+	int r = tuple_compare_field(*field_a, *field_b, TYPE);
+	mp_next(field_a);
+	mp_next(field_b);
+	return r;
+}
 
 template <>
 inline int
@@ -856,8 +1063,73 @@ struct TupleCompareWithKey<0, 0, TYPE, MORE_TYPES...>
 	}
 };
 
+/**
+ * Tuple with key comparator specialized by key part types,
+ * field numbers are taken from the key definition.
+ */
+template <int TYPE, int ...MORE_TYPES>
+struct FieldCompareWithKeyByType {};
+
+template <int TYPE, int TYPE2, int ...MORE_TYPES>
+struct FieldCompareWithKeyByType<TYPE, TYPE2, MORE_TYPES...>
+{
+	inline static int
+	compare(const struct tuple *tuple, const char *key,
+		uint32_t part_count, const struct tuple_format *format,
+		const struct key_part *part, const char *field)
+	{
+		int r = field_compare_with_key_and_next<TYPE>(&field, &key);
+		if (r || part_count == 1)
+			return r;
+		if (part[0].fieldno + 1 != part[1].fieldno) {
+			field = tuple_field_raw(format, tuple_data(tuple),
+						tuple_field_map(tuple),
+						part[1].fieldno);
+		}
+		return FieldCompareWithKeyByType<TYPE2, MORE_TYPES...>::
+			compare(tuple, key, part_count - 1, format,
+				part + 1, field);
+	}
+};
+
+template <int TYPE>
+struct FieldCompareWithKeyByType<TYPE>
+{
+	inline static int
+	compare(const struct tuple *, const char *key, uint32_t,
+		const struct tuple_format *, const struct key_part *,
+		const char *field)
+	{
+		return field_compare_with_key<TYPE>(&field, &key);
+	}
+};
+
+template <int ...TYPES>
+struct TupleCompareWithKeyByType
+{
+	static int
+	compare(const struct tuple *tuple, const char *key,
+		uint32_t part_count, const struct key_def *key_def)
+	{
+		/* Part count can be 0 in wildcard searches. */
+		if (part_count == 0)
+			return 0;
+		struct tuple_format *format = tuple_format(tuple);
+		const struct key_part *part = key_def->parts;
+		const char *field = tuple_field_raw(format, tuple_data(tuple),
+						    tuple_field_map(tuple),
+						    part->fieldno);
+		return FieldCompareWithKeyByType<TYPES...>::
+			compare(tuple, key, part_count, format, part, field);
+	}
+};
+
 } /* end of anonymous namespace */
 
+/** Tuple with key comparators by part count and type signature. */
+static tuple_compare_with_key_t
+cmp_wk_by_type[CMP_MAX_PARTS][CMP_MAX_SIGNATURES];
+
 struct comparator_with_key_signature
 {
 	tuple_compare_with_key_t f;
@@ -902,6 +1174,14 @@ tuple_compare_with_key_create(const struct key_def *def)
 		if (i == def->part_count)
 			return cmp_wk_arr[k].f;
 	}
+	int signature = cmp_signature(def);
+	if (signature >= 0) {
+		static bool is_filled =
+			(cmp_table_fill<TupleCompareWithKeyByType>(
+							cmp_wk_by_type), true);
+		(void) is_filled;
+		return cmp_wk_by_type[def->part_count - 1][signature];
+	}
 	if (key_def_is_sequential(def))
 		return tuple_compare_with_key_sequential;
 	return tuple_compare_with_key_slowpath;
@@ -202,6 +202,9 @@ txn_write_to_wal(struct txn *txn)
 	}
 	assert(row == req->rows + req->n_rows);
 
+	if (txn->has_triggers)
+		trigger_run(&txn->on_journal_write, txn);
+
 	ev_tstamp start = ev_now(loop()), stop;
 	int64_t res = journal_write(req);
 
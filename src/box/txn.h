@@ -102,6 +102,13 @@ struct txn {
 	struct trigger fiber_on_yield, fiber_on_stop;
 	 /** Commit and rollback triggers */
 	struct rlist on_commit, on_rollback;
+	/**
+	 * Triggers invoked right before the transaction is
+	 * submitted to the journal. A fiber waking up after
+	 * this point is guaranteed to have its own journal
+	 * write queued after this one.
+	 */
+	struct rlist on_journal_write;
 };
 
 /* Pointer to the current transaction (if any) */
@@ -140,6 +147,7 @@ txn_init_triggers(struct txn *txn)
 	if (txn->has_triggers == false) {
 		rlist_create(&txn->on_commit);
 		rlist_create(&txn->on_rollback);
+		rlist_create(&txn->on_journal_write);
 		txn->has_triggers = true;
 	}
 }
@@ -158,6 +166,13 @@ txn_on_rollback(struct txn *txn, struct trigger *trigger)
 	trigger_add(&txn->on_rollback, trigger);
 }
 
+static inline void
+txn_on_journal_write(struct txn *txn, struct trigger *trigger)
+{
+	txn_init_triggers(txn);
+	trigger_add(&txn->on_journal_write, trigger);
+}
+
 /**
  * Start a new statement. If no current transaction,
  * start a new transaction with autocommit = true.
@@ -42,9 +42,11 @@
 #include "vy_read_iterator.h"
 #include "vy_quota.h"
 #include "vy_stat.h"
+#include "vy_zdict.h"
 
 #include <small/lsregion.h>
 #include <coio_file.h>
+#include <coio_aio.h>
 
 #include "cfg.h"
 #include "coio_task.h"
@@ -60,6 +62,7 @@
 #include "info.h"
 #include "column_mask.h"
 #include "trigger.h"
+#include <third_party/qsort_arg.h>
 
 #define HEAP_FORWARD_DECLARATION
 #include "salad/heap.h"
@@ -94,16 +97,42 @@ enum vy_status {
 struct vy_conf {
 	/** Path to the data directory. */
 	char *path;
+	/**
+	 * Directories of storage tiers: vinyl_dir followed
+	 * by vinyl_tiers, see vy_run::tier.
+	 */
+	const char **tier_path;
+	/** Number of storage tiers, at least 1. */
+	uint32_t tier_count;
 	/** Max size of the memory level. */
 	uint64_t memory;
 	/** Max size of the tuple cache. */
 	uint64_t cache;
+	/** Max size of the cache of decompressed run pages. */
+	uint64_t page_cache;
+	/** Max number of run pages read in advance by a scan. */
+	int readahead;
+	/** Max size of memory run pages read in advance may use. */
+	uint64_t readahead_memory;
 	/** Max time a transaction may wait for memory. */
 	double timeout;
+	/**
+	 * If set, writers are slowed down smoothly once the
+	 * memory watermark is exceeded instead of being stalled
+	 * when the limit is hit.
+	 */
+	bool throttling;
 	/** Max number of threads used for reading. */
 	int read_threads;
+	/**
+	 * Max number of asynchronous reads in flight,
+	 * 0 if reads are done by the reader threads.
+	 */
+	int aio_queue_depth;
 	/** Max number of threads used for writing. */
 	int write_threads;
+	/** Max number of threads a single range compaction may use. */
+	int compaction_threads;
 };
 
 struct vy_env {
@@ -123,7 +152,7 @@ struct vy_env {
 	struct mempool      cursor_pool;
 	/** Memory quota */
 	struct vy_quota     quota;
-	/** Timer for updating quota watermark. */
+	/** Timer for updating quota watermark and rate limit. */
 	ev_timer            quota_timer;
 	/** Common index environment. */
 	struct vy_index_env index_env;
@@ -288,19 +317,25 @@ struct vy_cursor {
 };
 
 /**
- * Allocate a new run for an index and write the information
- * about it to the metadata log so that we could still find
- * and delete it in case a write error occured. This function
- * is called from dump/compaction task constructor.
+ * Allocate a new run for an index on storage tier @tier and
+ * write the information about it to the metadata log so that
+ * we could still find and delete it in case a write error
+ * occured. This function is called from dump/compaction task
+ * constructor.
  */
 static struct vy_run *
-vy_run_prepare(struct vy_index *index)
+vy_run_prepare(struct vy_index *index, uint32_t tier)
 {
 	struct vy_run *run = vy_run_new(vy_log_next_id());
 	if (run == NULL)
 		return NULL;
+	run->tier = tier;
+	if (index->opts.compression_dict_size > 0 && index->zdict != NULL) {
+		run->info.dict = index->zdict;
+		vy_zdict_ref(run->info.dict);
+	}
 	vy_log_tx_begin();
-	vy_log_prepare_run(index->commit_lsn, run->id);
+	vy_log_prepare_run(index->commit_lsn, run->id, run->tier);
 	if (vy_log_tx_commit() < 0) {
 		vy_run_unref(run);
 		return NULL;
@@ -608,7 +643,42 @@ struct vy_task {
 	 * an index:alter() call.
 	 */
 	double bloom_fpr;
+	bool page_bloom;
 	int64_t page_size;
+	int64_t compression_dict_size;
+	/**
+	 * For dump tasks: zstd dictionary trained on statements
+	 * of the new run, to be used for the next runs of the
+	 * index, or NULL.
+	 */
+	struct vy_zdict *new_zdict;
+	/**
+	 * Compaction of a big range may be split in several
+	 * parts by key, each executed by a separate worker,
+	 * see vy_task_compact_split(). The part covering the
+	 * beginning of the range is the leader: it links all
+	 * parts, including itself, in @parts and is the only
+	 * one passed to ->complete or ->abort once all parts
+	 * have been executed. A task that is not split is its
+	 * own leader and has @parts empty.
+	 */
+	struct vy_task *leader;
+	/** List of parts of a split task, linked by @in_parts. */
+	struct stailq parts;
+	struct stailq_entry in_parts;
+	/** Number of parts of the task, 1 if it is not split. */
+	int part_count;
+	/**
+	 * Number of parts that haven't been executed yet.
+	 * Protected by vy_scheduler::mutex.
+	 */
+	int pending_parts;
+	/** Beginning of the sub-range of a part, NULL for the leader. */
+	struct tuple *split_key;
+	/** Compacted slices cut to the sub-range of a part. */
+	struct rlist part_slices;
+	/** Range replacing the compacted one within the sub-range. */
+	struct vy_range *new_range;
 };
 
 /**
@@ -630,15 +700,29 @@ vy_task_new(struct mempool *pool, struct vy_index *index,
 	memset(task, 0, sizeof(*task));
 	task->ops = ops;
 	task->index = index;
+	task->leader = task;
+	stailq_create(&task->parts);
+	task->part_count = 1;
+	task->pending_parts = 1;
+	rlist_create(&task->part_slices);
 	vy_index_ref(index);
 	diag_create(&task->diag);
 	return task;
 }
 
-/** Free a task allocated with vy_task_new(). */
+/** Free a task allocated with vy_task_new() and all its parts. */
 static void
 vy_task_delete(struct mempool *pool, struct vy_task *task)
 {
+	struct vy_task *part, *next_part;
+	stailq_foreach_entry_safe(part, next_part, &task->parts, in_parts) {
+		if (part != task)
+			vy_task_delete(pool, part);
+	}
+	if (task->split_key != NULL)
+		tuple_unref(task->split_key);
+	if (task->new_zdict != NULL)
+		vy_zdict_unref(task->new_zdict);
 	vy_index_unref(task->index);
 	diag_destroy(&task->diag);
 	TRASH(task);
@@ -649,12 +733,37 @@ static int
 vy_task_dump_execute(struct vy_task *task)
 {
 	struct vy_index *index = task->index;
-
-	return vy_run_write(task->new_run, index->env->path,
-			    index->space_id, index->id, task->wi,
-			    task->page_size, index->cmp_def,
-			    index->key_def, task->max_output_count,
-			    task->bloom_fpr);
+	struct vy_zdict_sampler sampler;
+	struct vy_zdict_sampler *p_sampler = NULL;
+
+	if (task->compression_dict_size > 0) {
+		p_sampler = &sampler;
+		vy_zdict_sampler_create(p_sampler,
+					task->compression_dict_size);
+	}
+	int rc = vy_run_write(task->new_run, index->env->path,
+			      index->space_id, index->id, task->wi,
+			      task->page_size, index->cmp_def,
+			      index->key_def, task->max_output_count,
+			      task->bloom_fpr, task->page_bloom, p_sampler);
+	if (p_sampler == NULL)
+		return rc;
+	/*
+	 * Train a dictionary for the next runs of the index.
+	 * Dictionaries are an optimization, so failing to train
+	 * one must not fail the dump.
+	 */
+	if (rc == 0 && vy_zdict_sampler_is_ready(p_sampler)) {
+		task->new_zdict = vy_zdict_train(p_sampler);
+		if (task->new_zdict == NULL) {
+			say_warn("%s: failed to train compression "
+				 "dictionary: %s", vy_index_name(index),
+				 diag_last_error(diag_get())->errmsg);
+			diag_clear(diag_get());
+		}
+	}
+	vy_zdict_sampler_destroy(p_sampler);
+	return rc;
 }
 
 static int
@@ -672,6 +781,14 @@ vy_task_dump_complete(struct vy_scheduler *scheduler, struct vy_task *task)
 
 	assert(index->is_dumping);
 
+	if (task->new_zdict != NULL) {
+		/* Compress the next runs with the new dictionary. */
+		if (index->zdict != NULL)
+			vy_zdict_unref(index->zdict);
+		index->zdict = task->new_zdict;
+		task->new_zdict = NULL;
+	}
+
 	if (vy_run_is_empty(new_run)) {
 		/*
 		 * In case the run is empty, we can discard the run
@@ -740,7 +857,8 @@ vy_task_dump_complete(struct vy_scheduler *scheduler, struct vy_task *task)
 	 * Log change in metadata.
 	 */
 	vy_log_tx_begin();
-	vy_log_create_run(index->commit_lsn, new_run->id, dump_lsn);
+	vy_log_create_run(index->commit_lsn, new_run->id, dump_lsn,
+			  new_run->tier);
 	for (range = begin_range, i = 0; range != end_range;
 	     range = vy_range_tree_next(index->tree, range), i++) {
 		assert(i < index->range_count);
@@ -935,7 +1053,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_index *index,
 	if (task == NULL)
 		goto err;
 
-	struct vy_run *new_run = vy_run_prepare(index);
+	/* Freshly dumped data always goes to the fastest tier. */
+	struct vy_run *new_run = vy_run_prepare(index, 0);
 	if (new_run == NULL)
 		goto err_run;
 
@@ -960,7 +1079,9 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_index *index,
 	task->wi = wi;
 	task->max_output_count = max_output_count;
 	task->bloom_fpr = index->opts.bloom_fpr;
+	task->page_bloom = index->opts.page_bloom;
 	task->page_size = index->opts.page_size;
+	task->compression_dict_size = index->opts.compression_dict_size;
 
 	index->is_dumping = true;
 	vy_scheduler_update_index(scheduler, index);
@@ -999,12 +1120,259 @@ static int
 vy_task_compact_execute(struct vy_task *task)
 {
 	struct vy_index *index = task->index;
+	struct vy_run *new_run = task->new_run;
 
-	return vy_run_write(task->new_run, index->env->path,
+	/*
+	 * The directory of the index may not exist on the tier
+	 * yet if the tier was added after the index was created.
+	 */
+	if (new_run->tier > 0 &&
+	    vy_index_create_dir(index, new_run->tier) != 0)
+		return -1;
+	const char *dir = index->env->tier_path[new_run->tier];
+	return vy_run_write(new_run, dir,
 			    index->space_id, index->id, task->wi,
 			    task->page_size, index->cmp_def,
 			    index->key_def, task->max_output_count,
-			    task->bloom_fpr);
+			    task->bloom_fpr, task->page_bloom, NULL);
+}
+
+/** Return the beginning of the sub-range compacted by @part. */
+static struct tuple *
+vy_task_compact_part_begin(struct vy_task *part)
+{
+	if (part->split_key != NULL)
+		return part->split_key;
+	return part->leader->range->begin;
+}
+
+/** Return the end of the sub-range compacted by @part. */
+static struct tuple *
+vy_task_compact_part_end(struct vy_task *part)
+{
+	struct stailq_entry *next = stailq_next(&part->in_parts);
+	if (next == NULL)
+		return part->leader->range->end;
+	return stailq_entry(next, struct vy_task, in_parts)->split_key;
+}
+
+/** Free slices cut for a part of a split compaction task. */
+static void
+vy_task_compact_delete_part_slices(struct vy_task *part)
+{
+	struct vy_slice *slice, *next_slice;
+	rlist_foreach_entry_safe(slice, &part->part_slices,
+				 in_range, next_slice)
+		vy_slice_delete(slice);
+	rlist_create(&part->part_slices);
+}
+
+/**
+ * Release resources allocated for a compaction task part.
+ * If @discard_run is set, the run written by the part is
+ * discarded, otherwise it is just unreferenced.
+ */
+static void
+vy_task_compact_cleanup_part(struct vy_task *part, bool discard_run)
+{
+	/* The iterator has been cleaned up in worker. */
+	if (part->wi != NULL) {
+		part->wi->iface->close(part->wi);
+		part->wi = NULL;
+	}
+	vy_task_compact_delete_part_slices(part);
+	if (part->new_range != NULL) {
+		vy_range_delete(part->new_range);
+		part->new_range = NULL;
+	}
+	if (part->new_run != NULL) {
+		if (discard_run)
+			vy_run_discard(part->new_run);
+		else
+			vy_run_unref(part->new_run);
+		part->new_run = NULL;
+	}
+}
+
+/**
+ * Complete a compaction task split in several parts.
+ *
+ * Each part wrote its own run covering a sub-range of the
+ * compacted range, so the range is replaced with new ranges,
+ * one per part. A new range stores the run written by the
+ * part in place of the compacted slices, and slices of runs
+ * that were not compacted (including those added by dumps
+ * completed while the task was in progress) cut to the
+ * sub-range boundaries.
+ */
+static int
+vy_task_compact_complete_parts(struct vy_scheduler *scheduler,
+			       struct vy_task *task)
+{
+	struct vy_index *index = task->index;
+	struct vy_range *range = task->range;
+	struct vy_slice *first_slice = task->first_slice;
+	struct vy_slice *last_slice = task->last_slice;
+	struct vy_slice *slice, *new_slice;
+	struct vy_task *part;
+	struct vy_run *run;
+
+	/*
+	 * Slices cut for parts reference compacted runs,
+	 * so free them before looking for unused runs.
+	 */
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		/* The iterator has been cleaned up in worker. */
+		part->wi->iface->close(part->wi);
+		part->wi = NULL;
+		vy_task_compact_delete_part_slices(part);
+	}
+
+	/*
+	 * Build the list of runs that became unused
+	 * as a result of compaction.
+	 */
+	RLIST_HEAD(unused_runs);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		slice->run->compacted_slice_count++;
+		if (slice == last_slice)
+			break;
+	}
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		run = slice->run;
+		if (run->compacted_slice_count == run->refs)
+			rlist_add_entry(&unused_runs, run, in_unused);
+		slice->run->compacted_slice_count = 0;
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Allocate new ranges. vy_range_add_slice() adds a slice
+	 * to the list head, so to preserve the order of the slices
+	 * list, we have to iterate backward.
+	 */
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		struct vy_range *new_range;
+		new_range = vy_range_new(vy_log_next_id(),
+					 vy_task_compact_part_begin(part),
+					 vy_task_compact_part_end(part),
+					 index->cmp_def);
+		if (new_range == NULL)
+			goto fail;
+		part->new_range = new_range;
+		bool is_compacted = false;
+		rlist_foreach_entry_reverse(slice, &range->slices, in_range) {
+			new_slice = NULL;
+			if (slice == last_slice)
+				is_compacted = true;
+			if (!is_compacted) {
+				if (vy_slice_cut(slice, vy_log_next_id(),
+						 new_range->begin,
+						 new_range->end,
+						 index->cmp_def,
+						 &new_slice) != 0)
+					goto fail;
+			} else if (slice == first_slice) {
+				is_compacted = false;
+				if (!vy_run_is_empty(part->new_run)) {
+					new_slice = vy_slice_new(
+						vy_log_next_id(), part->new_run,
+						NULL, NULL, index->cmp_def);
+					if (new_slice == NULL)
+						goto fail;
+				}
+			}
+			if (new_slice != NULL)
+				vy_range_add_slice(new_range, new_slice);
+		}
+		new_range->n_compactions = range->n_compactions + 1;
+		vy_range_update_compact_priority(new_range, &index->opts);
+	}
+
+	/*
+	 * Log change in metadata.
+	 */
+	vy_log_tx_begin();
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	int64_t gc_lsn = vclock_sum(&scheduler->last_checkpoint);
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_log_drop_run(run->id, gc_lsn);
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		struct vy_range *new_range = part->new_range;
+		if (!vy_run_is_empty(part->new_run))
+			vy_log_create_run(index->commit_lsn, part->new_run->id,
+					  part->new_run->dump_lsn,
+					  part->new_run->tier);
+		vy_log_insert_range(index->commit_lsn, new_range->id,
+				    tuple_data_or_null(new_range->begin),
+				    tuple_data_or_null(new_range->end));
+		rlist_foreach_entry(slice, &new_range->slices, in_range)
+			vy_log_insert_slice(new_range->id, slice->run->id,
+					    slice->id,
+					    tuple_data_or_null(slice->begin),
+					    tuple_data_or_null(slice->end));
+	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
+
+	/*
+	 * Account new runs if they are not empty,
+	 * otherwise discard them.
+	 */
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		struct vy_run *new_run = part->new_run;
+		part->new_run = NULL;
+		if (!vy_run_is_empty(new_run)) {
+			vy_index_add_run(index, new_run);
+			vy_stmt_counter_add_disk(&index->stat.disk.compact.out,
+						 &new_run->count);
+			/* Drop the reference held by the task. */
+			vy_run_unref(new_run);
+		} else
+			vy_run_discard(new_run);
+	}
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		vy_stmt_counter_add_disk(&index->stat.disk.compact.in,
+					 &slice->count);
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Replace the compacted range with the new ones.
+	 * The range was removed from the heap when the task
+	 * was scheduled, put it back to remove it properly.
+	 */
+	vy_index_unacct_range(index, range);
+	vy_range_heap_insert(&index->range_heap, &range->heap_node);
+	vy_index_remove_range(index, range);
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		vy_index_add_range(index, part->new_range);
+		vy_index_acct_range(index, part->new_range);
+		part->new_range = NULL;
+	}
+	index->range_tree_version++;
+	index->stat.disk.compact.count++;
+
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_index_remove_run(index, run);
+
+	say_info("%s: completed compacting range %s in %d parts",
+		 vy_index_name(index), vy_range_str(range), task->part_count);
+
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	task->range = NULL;
+
+	vy_scheduler_update_index(scheduler, index);
+	return 0;
+fail:
+	/* New ranges are freed by vy_task_compact_abort(). */
+	return -1;
 }
 
 static int
@@ -1018,6 +1386,9 @@ vy_task_compact_complete(struct vy_scheduler *scheduler, struct vy_task *task)
 	struct vy_slice *slice, *next_slice, *new_slice = NULL;
 	struct vy_run *run;
 
+	if (task->part_count > 1)
+		return vy_task_compact_complete_parts(scheduler, task);
+
 	/*
 	 * Allocate a slice of the new run.
 	 *
@@ -1065,7 +1436,7 @@ vy_task_compact_complete(struct vy_scheduler *scheduler, struct vy_task *task)
 		vy_log_drop_run(run->id, gc_lsn);
 	if (new_slice != NULL) {
 		vy_log_create_run(index->commit_lsn, new_run->id,
-				  new_run->dump_lsn);
+				  new_run->dump_lsn, new_run->tier);
 		vy_log_insert_slice(range->id, new_run->id, new_slice->id,
 				    tuple_data_or_null(new_slice->begin),
 				    tuple_data_or_null(new_slice->end));
@@ -1146,22 +1517,179 @@ vy_task_compact_abort(struct vy_scheduler *scheduler, struct vy_task *task,
 	struct vy_index *index = task->index;
 	struct vy_range *range = task->range;
 
-	/* The iterator has been cleaned up in worker. */
-	task->wi->iface->close(task->wi);
-
-	if (!in_shutdown && !index->is_dropped) {
+	bool discard_run = !in_shutdown && !index->is_dropped;
+	if (discard_run) {
 		say_error("%s: failed to compact range %s: %s",
 			  vy_index_name(index), vy_range_str(range),
 			  diag_last_error(&task->diag)->errmsg);
-		vy_run_discard(task->new_run);
+	}
+	if (task->part_count > 1) {
+		struct vy_task *part;
+		stailq_foreach_entry(part, &task->parts, in_parts)
+			vy_task_compact_cleanup_part(part, discard_run);
 	} else
-		vy_run_unref(task->new_run);
+		vy_task_compact_cleanup_part(task, discard_run);
 
 	assert(range->heap_node.pos == UINT32_MAX);
 	vy_range_heap_insert(&index->range_heap, &range->heap_node);
 	vy_scheduler_update_index(scheduler, index);
 }
 
+/**
+ * Return the storage tier to write the output of a compaction
+ * task to: the tier following the last tier storing compacted
+ * runs, so that the more times data has been compacted, i.e.
+ * the older it is, the slower and cheaper storage it resides on.
+ */
+static uint32_t
+vy_task_compact_tier(struct vy_task *task)
+{
+	struct vy_index *index = task->index;
+	uint32_t tier = 0;
+	struct vy_slice *slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		tier = MAX(tier, slice->run->tier);
+		if (slice == task->last_slice)
+			break;
+	}
+	return MIN(tier + 1, index->env->tier_count - 1);
+}
+
+/**
+ * Prepare a write iterator and a new run for a compaction
+ * task part. If the task is split, the part reads slices of
+ * compacted runs cut to its sub-range, otherwise it reads the
+ * compacted slices as they are.
+ */
+static int
+vy_task_compact_prepare_part(struct vy_scheduler *scheduler,
+			     struct vy_task *part)
+{
+	struct vy_task *task = part->leader;
+	struct vy_index *index = task->index;
+	struct vy_range *range = task->range;
+	struct tx_manager *xm = scheduler->env->xm;
+
+	part->new_run = vy_run_prepare(index, vy_task_compact_tier(task));
+	if (part->new_run == NULL)
+		return -1;
+
+	bool is_last_level = (range->compact_priority == range->slice_count);
+	part->wi = vy_write_iterator_new(index->cmp_def,
+					 index->surrogate_format,
+					 index->upsert_format, index->id == 0,
+					 is_last_level, &xm->read_views);
+	if (part->wi == NULL)
+		return -1;
+
+	struct tuple *begin = vy_task_compact_part_begin(part);
+	struct tuple *end = vy_task_compact_part_end(part);
+	struct vy_slice *slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		struct vy_slice *src = slice;
+		if (task->part_count > 1) {
+			if (vy_slice_cut(slice, vy_log_next_id(), begin, end,
+					 index->cmp_def, &src) != 0)
+				return -1;
+			if (src != NULL)
+				rlist_add_tail_entry(&part->part_slices,
+						     src, in_range);
+		}
+		if (src != NULL) {
+			if (vy_write_iterator_new_slice(part->wi, src,
+					&scheduler->env->run_env) != 0)
+				return -1;
+			part->max_output_count += src->count.rows;
+		}
+		part->new_run->dump_lsn = MAX(part->new_run->dump_lsn,
+					      slice->run->dump_lsn);
+		if (slice == task->last_slice)
+			break;
+	}
+	assert(part->new_run->dump_lsn >= 0);
+	return 0;
+}
+
+/**
+ * Split compaction of a big range in several parts so that
+ * they can be executed by different workers concurrently.
+ *
+ * The number of parts is limited by vinyl_compaction_threads,
+ * by the number of idle workers, less one reserved for dumps,
+ * and by the range size so that no part is less than
+ * range_size. Parts are separated by min keys of pages of
+ * the oldest compacted run, which is the biggest one and so
+ * gives the best estimate of the key distribution.
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+static int
+vy_task_compact_split(struct vy_scheduler *scheduler, struct vy_task *task)
+{
+	struct vy_index *index = task->index;
+	struct vy_range *range = task->range;
+	struct tuple_format *key_format = index->env->key_format;
+	struct vy_slice *slice;
+
+	uint64_t size = 0;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		size += slice->count.bytes_compressed;
+		if (slice == task->last_slice)
+			break;
+	}
+	int max_parts = scheduler->env->conf->compaction_threads;
+	if (max_parts > scheduler->workers_available - 1)
+		max_parts = scheduler->workers_available - 1;
+	if (max_parts <= 1)
+		return 0;
+	if (index->opts.range_size > 0 &&
+	    (uint64_t)max_parts > size / index->opts.range_size)
+		max_parts = size / index->opts.range_size;
+	if (max_parts <= 1)
+		return 0;
+
+	stailq_add_tail_entry(&task->parts, task, in_parts);
+
+	slice = task->last_slice;
+	uint32_t page_count = slice->last_page_no - slice->first_page_no + 1;
+	const char *prev_key = tuple_data_or_null(range->begin);
+	for (int i = 1; i < max_parts; i++) {
+		struct vy_page_info *page = vy_run_page_info(slice->run,
+				slice->first_page_no +
+				(uint64_t)page_count * i / max_parts);
+		const char *split_key = page->min_key;
+		/* Skip keys that would make a part empty. */
+		if (prev_key != NULL &&
+		    key_compare(split_key, prev_key, index->cmp_def) <= 0)
+			continue;
+		if (range->end != NULL &&
+		    key_compare(split_key, tuple_data(range->end),
+				index->cmp_def) >= 0)
+			break;
+		struct vy_task *part = vy_task_new(&scheduler->task_pool,
+						   index, task->ops);
+		if (part == NULL)
+			return -1;
+		part->leader = task;
+		part->bloom_fpr = task->bloom_fpr;
+		part->page_bloom = task->page_bloom;
+		part->page_size = task->page_size;
+		stailq_add_tail_entry(&task->parts, part, in_parts);
+		task->part_count++;
+		part->split_key = vy_key_from_msgpack(key_format, split_key);
+		if (part->split_key == NULL)
+			return -1;
+		prev_key = split_key;
+	}
+	if (task->part_count == 1)
+		stailq_create(&task->parts);
+	task->pending_parts = task->part_count;
+	return 0;
+}
+
 static int
 vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_index *index,
 		    struct vy_task **p_task)
@@ -1172,7 +1700,6 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_index *index,
 		.abort = vy_task_compact_abort,
 	};
 
-	struct tx_manager *xm = scheduler->env->xm;
 	struct heap_node *range_node;
 	struct vy_range *range;
 
@@ -1194,46 +1721,35 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_index *index,
 	if (task == NULL)
 		goto err_task;
 
-	struct vy_run *new_run = vy_run_prepare(index);
-	if (new_run == NULL)
-		goto err_run;
-
-	struct vy_stmt_stream *wi;
-	bool is_last_level = (range->compact_priority == range->slice_count);
-	wi = vy_write_iterator_new(index->cmp_def, index->surrogate_format,
-				   index->upsert_format, index->id == 0,
-				   is_last_level, &xm->read_views);
-	if (wi == NULL)
-		goto err_wi;
-
+	/* Remember the slices we are compacting. */
 	struct vy_slice *slice;
 	int n = range->compact_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
-						&scheduler->env->run_env) != 0)
-			goto err_wi_sub;
-
-		task->max_output_count += slice->count.rows;
-		new_run->dump_lsn = MAX(new_run->dump_lsn,
-					slice->run->dump_lsn);
-
-		/* Remember the slices we are compacting. */
 		if (task->first_slice == NULL)
 			task->first_slice = slice;
 		task->last_slice = slice;
-
 		if (--n == 0)
 			break;
 	}
 	assert(n == 0);
-	assert(new_run->dump_lsn >= 0);
 
 	task->range = range;
-	task->new_run = new_run;
-	task->wi = wi;
 	task->bloom_fpr = index->opts.bloom_fpr;
+	task->page_bloom = index->opts.page_bloom;
 	task->page_size = index->opts.page_size;
 
+	if (vy_task_compact_split(scheduler, task) != 0)
+		goto err_prepare;
+
+	if (task->part_count > 1) {
+		struct vy_task *part;
+		stailq_foreach_entry(part, &task->parts, in_parts) {
+			if (vy_task_compact_prepare_part(scheduler, part) != 0)
+				goto err_prepare;
+		}
+	} else if (vy_task_compact_prepare_part(scheduler, task) != 0)
+		goto err_prepare;
+
 	/*
 	 * Remove the range we are going to compact from the heap
 	 * so that it doesn't get selected again.
@@ -1242,17 +1758,26 @@ vy_task_compact_new(struct vy_scheduler *scheduler, struct vy_index *index,
 	range_node->pos = UINT32_MAX;
 	vy_scheduler_update_index(scheduler, index);
 
-	say_info("%s: started compacting range %s, runs %d/%d",
-		 vy_index_name(index), vy_range_str(range),
-                 range->compact_priority, range->slice_count);
+	if (task->part_count > 1) {
+		say_info("%s: started compacting range %s, runs %d/%d, "
+			 "parts %d", vy_index_name(index), vy_range_str(range),
+			 range->compact_priority, range->slice_count,
+			 task->part_count);
+	} else {
+		say_info("%s: started compacting range %s, runs %d/%d",
+			 vy_index_name(index), vy_range_str(range),
+			 range->compact_priority, range->slice_count);
+	}
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
-err_wi:
-	vy_run_discard(new_run);
-err_run:
+err_prepare:
+	if (task->part_count > 1) {
+		struct vy_task *part;
+		stailq_foreach_entry(part, &task->parts, in_parts)
+			vy_task_compact_cleanup_part(part, true);
+	} else
+		vy_task_compact_cleanup_part(task, true);
 	vy_task_delete(&scheduler->task_pool, task);
 err_task:
 	say_error("%s: could not start compacting range %s: %s",
@@ -1592,6 +2117,15 @@ vy_scheduler_complete_task(struct vy_scheduler *scheduler,
 		return 0;
 	}
 
+	/* A split task fails if any of its parts fails. */
+	struct vy_task *part;
+	stailq_foreach_entry(part, &task->parts, in_parts) {
+		if (part->status != 0 && task->status == 0) {
+			task->status = part->status;
+			diag_move(&part->diag, &task->diag);
+		}
+	}
+
 	struct diag *diag = &task->diag;
 	if (task->status != 0) {
 		assert(!diag_is_empty(diag));
@@ -1669,8 +2203,8 @@ vy_scheduler_f(va_list va)
 				tasks_failed++;
 			else
 				tasks_done++;
+			scheduler->workers_available += task->part_count;
 			vy_task_delete(&scheduler->task_pool, task);
-			scheduler->workers_available++;
 			assert(scheduler->workers_available <=
 			       scheduler->worker_pool_size);
 		}
@@ -1703,15 +2237,27 @@ vy_scheduler_f(va_list va)
 		if (task == NULL)
 			goto wait;
 
-		/* Queue the task and notify workers if necessary. */
+		/*
+		 * Queue the task, or all its parts if it is split,
+		 * and notify workers if necessary.
+		 */
 		tt_pthread_mutex_lock(&scheduler->mutex);
 		was_empty = stailq_empty(&scheduler->input_queue);
-		stailq_add_tail_entry(&scheduler->input_queue, task, link);
-		if (was_empty)
-			tt_pthread_cond_signal(&scheduler->worker_cond);
+		if (task->part_count > 1) {
+			struct vy_task *part;
+			stailq_foreach_entry(part, &task->parts, in_parts)
+				stailq_add_tail_entry(&scheduler->input_queue,
+						      part, link);
+			tt_pthread_cond_broadcast(&scheduler->worker_cond);
+		} else {
+			stailq_add_tail_entry(&scheduler->input_queue,
+					      task, link);
+			if (was_empty)
+				tt_pthread_cond_signal(&scheduler->worker_cond);
+		}
 		tt_pthread_mutex_unlock(&scheduler->mutex);
 
-		scheduler->workers_available--;
+		scheduler->workers_available -= task->part_count;
 		fiber_reschedule();
 		continue;
 error:
@@ -1778,9 +2324,16 @@ vy_worker_f(va_list va)
 			diag_move(diag, &task->diag);
 		}
 
-		/* Return processed task to scheduler */
+		/*
+		 * Return processed task to scheduler. A part of
+		 * a split task is returned with its leader after
+		 * all parts have been executed.
+		 */
 		tt_pthread_mutex_lock(&scheduler->mutex);
-		stailq_add_tail_entry(&scheduler->output_queue, task, link);
+		struct vy_task *leader = task->leader;
+		if (--leader->pending_parts == 0)
+			stailq_add_tail_entry(&scheduler->output_queue,
+					      leader, link);
 	}
 	tt_pthread_mutex_unlock(&scheduler->mutex);
 	return 0;
@@ -1833,10 +2386,21 @@ vy_scheduler_stop_workers(struct vy_scheduler *scheduler)
 	scheduler->worker_pool = NULL;
 	scheduler->worker_pool_size = 0;
 
-	/* Abort all pending tasks. */
+	/*
+	 * Abort all pending tasks. A task that hasn't been taken
+	 * by a worker is accounted as executed so that a split
+	 * task gets aborted once all its parts are accounted.
+	 */
 	struct vy_task *task, *next;
-	stailq_concat(&task_queue, &scheduler->output_queue);
+	struct stailq abort_queue;
+	stailq_create(&abort_queue);
 	stailq_foreach_entry_safe(task, next, &task_queue, link) {
+		struct vy_task *leader = task->leader;
+		if (--leader->pending_parts == 0)
+			stailq_add_tail_entry(&abort_queue, leader, link);
+	}
+	stailq_concat(&abort_queue, &scheduler->output_queue);
+	stailq_foreach_entry_safe(task, next, &abort_queue, link) {
 		if (task->ops->abort != NULL)
 			task->ops->abort(scheduler, task, true);
 		vy_task_delete(&scheduler->task_pool, task);
@@ -2018,9 +2582,15 @@ vy_conf_new()
 	}
 	conf->memory = cfg_geti64("vinyl_memory");
 	conf->cache = cfg_geti64("vinyl_cache");
+	conf->page_cache = cfg_geti64("vinyl_page_cache");
+	conf->readahead = cfg_geti("vinyl_readahead");
+	conf->readahead_memory = cfg_geti64("vinyl_readahead_memory");
 	conf->timeout = cfg_getd("vinyl_timeout");
+	conf->throttling = cfg_geti("vinyl_throttling");
 	conf->read_threads = cfg_geti("vinyl_read_threads");
+	conf->aio_queue_depth = cfg_geti("vinyl_aio_queue_depth");
 	conf->write_threads = cfg_geti("vinyl_write_threads");
+	conf->compaction_threads = cfg_geti("vinyl_compaction_threads");
 
 	conf->path = strdup(cfg_gets("vinyl_dir"));
 	if (conf->path == NULL) {
@@ -2033,8 +2603,38 @@ vy_conf_new()
 			 "directory does not exist");
 		goto error_2;
 	}
+
+	uint32_t tier_count = cfg_getarr_size("vinyl_tiers") + 1;
+	conf->tier_path = calloc(tier_count, sizeof(*conf->tier_path));
+	if (conf->tier_path == NULL) {
+		diag_set(OutOfMemory, tier_count * sizeof(*conf->tier_path),
+			 "calloc", "tier paths");
+		goto error_2;
+	}
+	conf->tier_path[0] = conf->path;
+	conf->tier_count = 1;
+	for (uint32_t i = 1; i < tier_count; i++) {
+		const char *path = cfg_getarr_elem("vinyl_tiers", i - 1);
+		if (path == NULL || !path_exists(path)) {
+			diag_set(ClientError, ER_CFG, "vinyl_tiers",
+				 tt_sprintf("directory '%s' does not exist",
+					    path != NULL ? path : ""));
+			goto error_3;
+		}
+		conf->tier_path[i] = strdup(path);
+		if (conf->tier_path[i] == NULL) {
+			diag_set(OutOfMemory, strlen(path) + 1,
+				 "strdup", "tier path");
+			goto error_3;
+		}
+		conf->tier_count++;
+	}
 	return conf;
 
+error_3:
+	for (uint32_t i = 1; i < conf->tier_count; i++)
+		free((char *)conf->tier_path[i]);
+	free(conf->tier_path);
 error_2:
 	free(conf->path);
 error_1:
@@ -2044,6 +2644,9 @@ error_1:
 
 static void vy_conf_delete(struct vy_conf *c)
 {
+	for (uint32_t i = 1; i < c->tier_count; i++)
+		free((char *)c->tier_path[i]);
+	free(c->tier_path);
 	free(c->path);
 	free(c);
 }
@@ -2053,6 +2656,13 @@ vy_update_options(struct vy_env *env)
 {
 	struct vy_conf *conf = env->conf;
 	conf->timeout = cfg_getd("vinyl_timeout");
+	conf->throttling = cfg_geti("vinyl_throttling");
+	conf->page_cache = cfg_geti64("vinyl_page_cache");
+	vy_run_env_set_page_cache_quota(&env->run_env, conf->page_cache);
+	conf->readahead = cfg_geti("vinyl_readahead");
+	conf->readahead_memory = cfg_geti64("vinyl_readahead_memory");
+	vy_run_env_set_readahead(&env->run_env, conf->readahead,
+				 conf->readahead_memory);
 	return 0;
 }
 
@@ -2103,6 +2713,11 @@ vy_info_append_performance(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "read_view", mstats.objcount);
 
 	info_append_int(h, "dump_bandwidth", vy_stat_dump_bandwidth(stat));
+	info_append_int(h, "tx_write_rate", vy_stat_tx_write_rate(stat));
+	/* 0 means that writers are not throttled. */
+	size_t rate_limit = env->quota.rate_limit;
+	info_append_int(h, "tx_rate_limit",
+			rate_limit != SIZE_MAX ? rate_limit : 0);
 
 	struct vy_cache_env *ce = &env->cache_env;
 	info_table_begin(h, "cache");
@@ -2110,6 +2725,33 @@ vy_info_append_performance(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "used", ce->mem_used);
 	info_table_end(h);
 
+	struct vy_page_cache *pc = &env->run_env.page_cache;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "count", pc->page_count);
+	info_append_int(h, "used", pc->mem_used);
+	info_append_int(h, "limit", pc->mem_quota);
+	info_append_int(h, "hit", pc->hit);
+	info_append_int(h, "miss", pc->miss);
+	info_append_int(h, "evict", pc->evict);
+	info_table_end(h);
+
+	struct vy_readahead *ra = &env->run_env.readahead;
+	info_table_begin(h, "readahead");
+	info_append_int(h, "read", ra->read);
+	info_append_int(h, "hit", ra->hit);
+	info_append_int(h, "used", ra->mem_used);
+	info_append_int(h, "limit", ra->mem_quota);
+	info_table_end(h);
+
+	struct coio_aio *aio = env->run_env.aio;
+	info_table_begin(h, "aio");
+	info_append_str(h, "backend", coio_aio_backend_strs[
+			aio != NULL ? aio->backend : COIO_AIO_NONE]);
+	info_append_int(h, "reads", aio != NULL ? aio->read_count : 0);
+	info_append_int(h, "submits", aio != NULL ? aio->submit_count : 0);
+	info_append_int(h, "inflight", aio != NULL ? aio->inflight : 0);
+	info_table_end(h);
+
 	info_table_end(h);
 }
 
@@ -2238,6 +2880,23 @@ vy_index_info(struct vy_index *index, struct info_handler *h)
 	info_append_int(h, "run_avg", index->run_count / index->range_count);
 	histogram_snprint(buf, sizeof(buf), index->run_hist);
 	info_append_str(h, "run_histogram", buf);
+	info_append_int(h, "dict_size",
+			index->zdict != NULL ? index->zdict->size : 0);
+
+	info_append_str(h, "compaction",
+			index_compaction_policy_strs[index->opts.compaction]);
+	/*
+	 * Write amplification is the number of bytes written to
+	 * disk by dumps and compactions per each byte dumped.
+	 * Read amplification is the average number of runs
+	 * a lookup has to check.
+	 */
+	int64_t dumped = stat->disk.dump.out.bytes;
+	int64_t written = dumped + stat->disk.compact.out.bytes;
+	info_append_double(h, "write_amplification",
+			   dumped > 0 ? (double)written / dumped : 0);
+	info_append_double(h, "read_amplification",
+			   (double)index->run_count / index->range_count);
 
 	info_end(h);
 }
@@ -3823,9 +4482,183 @@ vy_get(struct vy_env *env, struct vy_tx *tx, struct vy_index *index,
 	return 0;
 }
 
+/**
+ * Max number of fibers looking up keys of a vy_get_many()
+ * call, including the caller.
+ */
+enum { VY_GET_MANY_FIBERS = 16 };
+
+struct vy_get_many_ctx {
+	struct vy_env *env;
+	struct vy_tx *tx;
+	struct vy_index *index;
+	const char **keys;
+	struct tuple **result;
+	/** Positions of @keys sorted by key. */
+	uint32_t *order;
+	uint32_t key_count;
+	/** Next position in @order to look up. */
+	uint32_t next;
+	/** Set if a lookup failed, stops other fibers. */
+	bool is_failed;
+};
+
+static int
+vy_get_many_key_cmp(const void *a, const void *b, void *arg)
+{
+	struct vy_get_many_ctx *ctx = arg;
+	return key_compare(ctx->keys[*(const uint32_t *)a],
+			   ctx->keys[*(const uint32_t *)b],
+			   ctx->index->key_def);
+}
+
+/**
+ * Look up keys of a vy_get_many() call one by one until
+ * all keys are processed. Run by several fibers at once.
+ */
+static int
+vy_get_many_lookup(struct vy_get_many_ctx *ctx)
+{
+	while (!ctx->is_failed && ctx->next < ctx->key_count) {
+		uint32_t i = ctx->order[ctx->next++];
+		const char *key = ctx->keys[i];
+		uint32_t part_count = mp_decode_array(&key);
+		if (vy_index_full_by_key(ctx->env, ctx->tx, ctx->index,
+					 key, part_count,
+					 &ctx->result[i]) != 0) {
+			ctx->is_failed = true;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int
+vy_get_many_f(va_list ap)
+{
+	struct vy_get_many_ctx *ctx = va_arg(ap, struct vy_get_many_ctx *);
+	return vy_get_many_lookup(ctx);
+}
+
+int
+vy_get_many(struct vy_env *env, struct vy_tx *tx, struct vy_index *index,
+	    const char **keys, uint32_t key_count, struct tuple **result)
+{
+	assert(tx == NULL || tx->state == VINYL_TX_READY);
+	memset(result, 0, key_count * sizeof(*result));
+	if (key_count == 0)
+		return 0;
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t *order = region_alloc(region, key_count * sizeof(*order));
+	if (order == NULL) {
+		diag_set(OutOfMemory, key_count * sizeof(*order),
+			 "region", "order");
+		return -1;
+	}
+	struct vy_get_many_ctx ctx;
+	ctx.env = env;
+	ctx.tx = tx;
+	ctx.index = index;
+	ctx.keys = keys;
+	ctx.result = result;
+	ctx.order = order;
+	ctx.key_count = key_count;
+	ctx.next = 0;
+	ctx.is_failed = false;
+
+	/*
+	 * Look the keys up in the key order, so that lookups
+	 * of neighbouring keys go to the same range and page
+	 * one after another and hit the page cache.
+	 */
+	for (uint32_t i = 0; i < key_count; i++)
+		order[i] = i;
+	qsort_arg(order, key_count, sizeof(*order),
+		  vy_get_many_key_cmp, &ctx);
+
+	/*
+	 * Start helper fibers, so that while a fiber waits for
+	 * a reader thread to read a page, others can dispatch
+	 * their reads. If a fiber can't be created, the keys
+	 * are looked up by fewer fibers.
+	 */
+	struct fiber *helpers[VY_GET_MANY_FIBERS - 1];
+	int helper_count = 0;
+	int max_helpers = MIN(key_count, VY_GET_MANY_FIBERS) - 1;
+	while (helper_count < max_helpers) {
+		struct fiber *f = fiber_new("vinyl.get_many", vy_get_many_f);
+		if (f == NULL) {
+			diag_clear(diag_get());
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fiber_start(f, &ctx);
+		helpers[helper_count++] = f;
+	}
+	int rc = 0;
+	struct diag diag;
+	diag_create(&diag);
+	if (vy_get_many_lookup(&ctx) != 0) {
+		diag_move(diag_get(), &diag);
+		rc = -1;
+	}
+	for (int i = 0; i < helper_count; i++) {
+		if (fiber_join(helpers[i]) != 0) {
+			if (rc == 0)
+				diag_move(diag_get(), &diag);
+			rc = -1;
+		}
+	}
+	region_truncate(region, region_svp);
+	if (rc != 0) {
+		diag_move(&diag, diag_get());
+		for (uint32_t i = 0; i < key_count; i++) {
+			if (result[i] != NULL) {
+				tuple_unref(result[i]);
+				result[i] = NULL;
+			}
+		}
+	}
+	diag_destroy(&diag);
+	return rc;
+}
+
 
 /** {{{ Environment */
 
+/** How often the quota watermark and rate limit are updated. */
+static const double VY_QUOTA_UPDATE_INTERVAL = 0.1;
+
+/**
+ * Return the rate at which transactions may consume memory
+ * so that the hard limit is not hit before the memory is
+ * dumped, or SIZE_MAX if writers needn't be throttled.
+ */
+static size_t
+vy_env_tx_rate_limit(struct vy_env *e, int64_t dump_bandwidth)
+{
+	struct vy_quota *q = &e->quota;
+	if (!e->conf->throttling || q->limit == SIZE_MAX ||
+	    q->used <= q->watermark)
+		return SIZE_MAX;
+	if (q->used >= q->limit)
+		return 0;
+	/*
+	 * It takes used / dump_bandwidth seconds to dump all
+	 * in-memory data, during which transactions must fit
+	 * in the remaining limit - used bytes:
+	 *
+	 *   rate_limit = dump_bandwidth * (limit - used) / used
+	 *
+	 * When used == watermark this equals tx_write_rate (see
+	 * vy_env_quota_timer_cb()), so throttling kicks in
+	 * smoothly and gets stricter as used approaches limit.
+	 */
+	return (double)dump_bandwidth * (q->limit - q->used) / q->used;
+}
+
 static void
 vy_env_quota_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 {
@@ -3852,6 +4685,9 @@ vy_env_quota_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 			    (dump_bandwidth + tx_write_rate + 1));
 
 	vy_quota_set_watermark(&e->quota, watermark);
+	vy_quota_update_rate(&e->quota,
+			     vy_env_tx_rate_limit(e, dump_bandwidth),
+			     VY_QUOTA_UPDATE_INTERVAL);
 }
 
 static struct vy_squash_queue *
@@ -3891,8 +4727,8 @@ vy_env_new(void)
 	vy_stmt_env_create(&e->stmt_env, e->conf->memory,
 			   cfg_geti("vinyl_max_tuple_size"));
 
-	if (vy_index_env_create(&e->index_env, e->conf->path,
-				&e->stmt_env.allocator,
+	if (vy_index_env_create(&e->index_env, e->conf->tier_path,
+				e->conf->tier_count, &e->stmt_env.allocator,
 				&e->scheduler->generation, vy_squash_schedule,
 				e) != 0)
 		goto error_index_env;
@@ -3903,11 +4739,15 @@ vy_env_new(void)
 	vy_quota_init(&e->quota, vy_scheduler_quota_exceeded_cb,
 		                 vy_scheduler_quota_throttled_cb,
 				 vy_scheduler_quota_released_cb);
-	ev_timer_init(&e->quota_timer, vy_env_quota_timer_cb, 0, 1.);
+	ev_timer_init(&e->quota_timer, vy_env_quota_timer_cb, 0,
+		      VY_QUOTA_UPDATE_INTERVAL);
 	e->quota_timer.data = e;
 	ev_timer_start(loop(), &e->quota_timer);
 	vy_cache_env_create(&e->cache_env, slab_cache, e->conf->cache);
 	vy_run_env_create(&e->run_env);
+	vy_run_env_set_page_cache_quota(&e->run_env, e->conf->page_cache);
+	vy_run_env_set_readahead(&e->run_env, e->conf->readahead,
+				 e->conf->readahead_memory);
 	vy_log_init(e->conf->path);
 	return e;
 error_index_env:
@@ -3958,7 +4798,8 @@ vy_bootstrap(struct vy_env *e)
 	if (vy_log_bootstrap() != 0)
 		return -1;
 	vy_quota_set_limit(&e->quota, e->conf->memory);
-	vy_run_env_enable_coio(&e->run_env, e->conf->read_threads);
+	vy_run_env_enable_coio(&e->run_env, e->conf->read_threads,
+			       e->conf->aio_queue_depth);
 	e->status = VINYL_ONLINE;
 	return 0;
 }
@@ -4026,7 +4867,8 @@ vy_end_recovery(struct vy_env *e)
 	default:
 		unreachable();
 	}
-	vy_run_env_enable_coio(&e->run_env, e->conf->read_threads);
+	vy_run_env_enable_coio(&e->run_env, e->conf->read_threads,
+			       e->conf->aio_queue_depth);
 	e->status = VINYL_ONLINE;
 	return 0;
 }
@@ -4202,8 +5044,11 @@ vy_join_cb(const struct vy_log_record *record, void *arg)
 	/*
 	 * We are only interested in the primary index.
 	 * Secondary keys will be rebuilt on the destination.
+	 * Don't bother reading runs of a space the replica
+	 * receives over another connection.
 	 */
-	if (ctx->index_id != 0)
+	if (ctx->index_id != 0 ||
+	    !xstream_accepts_space(ctx->stream, ctx->space_id))
 		return 0;
 
 	if (record->type == VY_LOG_INSERT_SLICE) {
@@ -4214,8 +5059,12 @@ vy_join_cb(const struct vy_log_record *record, void *arg)
 		struct vy_run *run = vy_run_new(record->run_id);
 		if (run == NULL)
 			goto done_slice;
-		if (vy_run_recover(run, ctx->env->conf->path,
-				   ctx->space_id, ctx->index_id) != 0)
+		run->tier = record->tier;
+		const char *dir = vy_index_env_tier_path(&ctx->env->index_env,
+							 run->tier);
+		if (dir == NULL ||
+		    vy_run_recover(run, dir, ctx->space_id,
+				   ctx->index_id) != 0)
 			goto done_slice;
 
 		if (record->begin != NULL) {
@@ -4265,9 +5114,15 @@ vy_join_f(va_list ap)
 
 	cbus_loop(&endpoint);
 
+	/*
+	 * The stream may buffer rows in memory of this thread,
+	 * so it must be flushed before the thread exits.
+	 */
+	int rc = xstream_flush(ctx->stream);
+
 	cbus_endpoint_destroy(&endpoint, cbus_process);
 	cpipe_destroy(&ctx->tx_pipe);
-	return 0;
+	return rc;
 }
 
 int
@@ -4389,11 +5244,21 @@ vy_gc_cb(const struct vy_log_record *record, void *cb_arg)
 		     {say_error("error injection: vinyl run %lld not deleted",
 				(long long)record->run_id); goto out;});
 
+	const char *dir = vy_index_env_tier_path(&arg->env->index_env,
+						 record->tier);
+	if (dir == NULL) {
+		/* Keep the run until the tier is configured back. */
+		say_warn("failed to delete vinyl run %lld: %s",
+			 (long long)record->run_id,
+			 diag_last_error(diag_get())->errmsg);
+		goto out;
+	}
+
 	/* Try to delete files. */
 	bool forget = true;
 	char path[PATH_MAX];
 	for (int type = 0; type < vy_file_MAX; type++) {
-		vy_run_snprint_path(path, sizeof(path), arg->env->conf->path,
+		vy_run_snprint_path(path, sizeof(path), dir,
 				    arg->space_id, arg->index_id,
 				    record->run_id, type);
 		if (coio_unlink(path) < 0 && errno != ENOENT) {
@@ -4486,9 +5351,14 @@ vy_backup_cb(const struct vy_log_record *record, void *cb_arg)
 	if (record->type != VY_LOG_CREATE_RUN || record->is_dropped)
 		goto out;
 
+	const char *dir = vy_index_env_tier_path(&arg->env->index_env,
+						 record->tier);
+	if (dir == NULL)
+		return -1;
+
 	char path[PATH_MAX];
 	for (int type = 0; type < vy_file_MAX; type++) {
-		vy_run_snprint_path(path, sizeof(path), arg->env->conf->path,
+		vy_run_snprint_path(path, sizeof(path), dir,
 				    arg->space_id, arg->index_id,
 				    record->run_id, type);
 		if (arg->cb(path, arg->cb_arg) != 0)
@@ -138,6 +138,27 @@ int
 vy_get(struct vy_env *env, struct vy_tx *tx, struct vy_index *index,
        const char *key, uint32_t part_count, struct tuple **result);
 
+/**
+ * Get tuples from the vinyl index by several full keys.
+ * The keys are looked up in the key order by a few fibers
+ * at once, so that their disk reads are served by reader
+ * threads concurrently.
+ * @param env         Vinyl environment.
+ * @param tx          Current transaction.
+ * @param index       Vinyl index.
+ * @param keys        MessagePack'ed keys, the arrays with headers.
+ * @param key_count   Number of keys.
+ * @param[out] result Is set to the the found tuples in the order
+ *                    of @keys, NULL for missing keys. The tuples
+ *                    must be unreferenced after usage.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory or read error, @result is cleared.
+ */
+int
+vy_get_many(struct vy_env *env, struct vy_tx *tx, struct vy_index *index,
+	    const char **keys, uint32_t key_count, struct tuple **result);
+
 /**
  * Execute REPLACE in a vinyl space.
  * @param env     Vinyl environment.
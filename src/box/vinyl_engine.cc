@@ -61,6 +61,7 @@ VinylEngine::VinylEngine()
 	:Engine("vinyl", &vy_tuple_format_vtab)
 {
 	env = NULL;
+	join_lsn = 0;
 }
 
 VinylEngine::~VinylEngine()
@@ -63,6 +63,8 @@ struct VinylEngine: public Engine {
 	virtual void checkSpaceDef(struct space_def *def) override;
 public:
 	struct vy_env *env;
+	/** LSN assigned to the last row applied on initial join. */
+	int64_t join_lsn;
 };
 
 #endif /* TARANTOOL_BOX_VINYL_ENGINE_H_INCLUDED */
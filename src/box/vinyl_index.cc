@@ -109,6 +109,16 @@ VinylIndex::findByKey(const char *key, uint32_t part_count) const
 	return tuple;
 }
 
+void
+VinylIndex::findByKeys(const char **keys, uint32_t key_count,
+		       struct tuple **result) const
+{
+	struct vy_tx *transaction = in_txn() ?
+		(struct vy_tx *) in_txn()->engine_tx : NULL;
+	if (vy_get_many(env, transaction, db, keys, key_count, result) != 0)
+		diag_raise();
+}
+
 size_t
 VinylIndex::bsize() const
 {
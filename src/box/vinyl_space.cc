@@ -51,14 +51,13 @@ void
 VinylSpace::applyInitialJoinRow(struct space *space, struct request *request)
 {
 	assert(request->header != NULL);
-	struct vy_env *env = ((VinylEngine *)space->handler->engine)->env;
+	VinylEngine *engine = (VinylEngine *)space->handler->engine;
+	struct vy_env *env = engine->env;
 
 	struct vy_tx *tx = vy_begin(env);
 	if (tx == NULL)
 		diag_raise();
 
-	int64_t signature = request->header->lsn;
-
 	struct txn_stmt stmt;
 	memset(&stmt, 0, sizeof(stmt));
 
@@ -89,7 +88,14 @@ VinylSpace::applyInitialJoinRow(struct space *space, struct request *request)
 		vy_rollback(env, tx);
 		diag_raise();
 	}
-	vy_commit(env, tx, signature);
+	/*
+	 * Initial data may be received over several connections
+	 * and applied by several fibers, and vy_prepare() may
+	 * yield. Assign LSN only now so that it grows with each
+	 * commit as the lsregion allocator expects, rather than
+	 * use the one sent by the master, see vy_join_ctx::lsn.
+	 */
+	vy_commit(env, tx, ++engine->join_lsn);
 }
 
 /*
@@ -62,17 +62,21 @@
 #include "vy_upsert.h"
 
 int
-vy_index_env_create(struct vy_index_env *env, const char *path,
-		    struct lsregion *allocator, int64_t *p_generation,
+vy_index_env_create(struct vy_index_env *env, const char **tier_path,
+		    uint32_t tier_count, struct lsregion *allocator,
+		    int64_t *p_generation,
 		    vy_upsert_thresh_cb upsert_thresh_cb,
 		    void *upsert_thresh_arg)
 {
+	assert(tier_count > 0);
 	env->key_format = tuple_format_new(&vy_tuple_format_vtab,
 					   NULL, 0, 0);
 	if (env->key_format == NULL)
 		return -1;
 	tuple_format_ref(env->key_format, 1);
-	env->path = path;
+	env->path = tier_path[0];
+	env->tier_path = tier_path;
+	env->tier_count = tier_count;
 	env->allocator = allocator;
 	env->p_generation = p_generation;
 	env->upsert_thresh_cb = upsert_thresh_cb;
@@ -86,6 +90,18 @@ vy_index_env_destroy(struct vy_index_env *env)
 	tuple_format_ref(env->key_format, -1);
 }
 
+const char *
+vy_index_env_tier_path(struct vy_index_env *env, uint32_t tier)
+{
+	if (tier >= env->tier_count) {
+		diag_set(ClientError, ER_CFG, "vinyl_tiers",
+			 tt_sprintf("storage tier %u is not configured",
+				    (unsigned)tier));
+		return NULL;
+	}
+	return env->tier_path[tier];
+}
+
 const char *
 vy_index_name(struct vy_index *index)
 {
@@ -281,6 +297,8 @@ vy_index_delete(struct vy_index *index)
 		free(index->cmp_def);
 	free(index->key_def);
 	histogram_delete(index->run_hist);
+	if (index->zdict != NULL)
+		vy_zdict_unref(index->zdict);
 	vy_index_stat_destroy(&index->stat);
 	vy_cache_destroy(&index->cache);
 	tuple_format_ref(index->space_format, -1);
@@ -320,12 +338,14 @@ vy_index_init_range_tree(struct vy_index *index)
 }
 
 int
-vy_index_create(struct vy_index *index)
+vy_index_create_dir(struct vy_index *index, uint32_t tier)
 {
-	/* Make index directory. */
+	const char *dir = vy_index_env_tier_path(index->env, tier);
+	if (dir == NULL)
+		return -1;
 	int rc;
 	char path[PATH_MAX];
-	vy_index_snprint_path(path, sizeof(path), index->env->path,
+	vy_index_snprint_path(path, sizeof(path), dir,
 			      index->space_id, index->id);
 	char *path_sep = path;
 	while (*path_sep == '/') {
@@ -351,6 +371,15 @@ vy_index_create(struct vy_index *index)
 			 path);
 		return -1;
 	}
+	return 0;
+}
+
+int
+vy_index_create(struct vy_index *index)
+{
+	/* Make index directory. */
+	if (vy_index_create_dir(index, 0) != 0)
+		return -1;
 
 	/* Allocate initial range. */
 	return vy_index_init_range_tree(index);
@@ -435,8 +464,12 @@ vy_index_recovery_cb(const struct vy_log_record *record, void *cb_arg)
 		if (run == NULL)
 			goto out;
 		run->dump_lsn = record->dump_lsn;
-		if (vy_run_recover(run, index->env->path,
-				   index->space_id, index->id) != 0) {
+		run->tier = record->tier;
+		const char *dir = vy_index_env_tier_path(index->env,
+							 run->tier);
+		if (dir == NULL ||
+		    vy_run_recover(run, dir, index->space_id,
+				   index->id) != 0) {
 			vy_run_unref(run);
 			goto out;
 		}
@@ -521,10 +554,23 @@ vy_index_recover(struct vy_index *index, struct vy_recovery *recovery,
 					vy_index_recovery_cb, &arg);
 
 	mh_int_t k;
+	int64_t zdict_lsn = -1;
 	mh_foreach(arg.run_hash, k) {
 		struct vy_run *run = mh_i64ptr_node(arg.run_hash, k)->val;
 		if (run->refs > 1)
 			vy_index_add_run(index, run);
+		/*
+		 * Keep compressing new runs with the dictionary
+		 * of the most recently dumped run.
+		 */
+		if (run->refs > 1 && run->info.dict != NULL &&
+		    run->dump_lsn > zdict_lsn) {
+			if (index->zdict != NULL)
+				vy_zdict_unref(index->zdict);
+			index->zdict = run->info.dict;
+			vy_zdict_ref(index->zdict);
+			zdict_lsn = run->dump_lsn;
+		}
 		if (run->refs == 1 && rc == 0) {
 			diag_set(ClientError, ER_INVALID_VYLOG_FILE,
 				 tt_sprintf("Unused run %lld in index %lld",
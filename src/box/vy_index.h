@@ -58,6 +58,7 @@ struct vy_index;
 struct vy_mem;
 struct vy_recovery;
 struct vy_run;
+struct vy_zdict;
 
 typedef void
 (*vy_upsert_thresh_cb)(struct vy_index *index, struct tuple *stmt, void *arg);
@@ -66,6 +67,13 @@ typedef void
 struct vy_index_env {
 	/** Path to the data directory. */
 	const char *path;
+	/**
+	 * Directories of storage tiers, see vy_run::tier.
+	 * The first one is always @path.
+	 */
+	const char **tier_path;
+	/** Number of storage tiers, at least 1. */
+	uint32_t tier_count;
 	/** Memory allocator. */
 	struct lsregion *allocator;
 	/** Memory generation counter. */
@@ -83,11 +91,20 @@ struct vy_index_env {
 
 /** Create a common index environment. */
 int
-vy_index_env_create(struct vy_index_env *env, const char *path,
-		    struct lsregion *allocator, int64_t *p_generation,
+vy_index_env_create(struct vy_index_env *env, const char **tier_path,
+		    uint32_t tier_count, struct lsregion *allocator,
+		    int64_t *p_generation,
 		    vy_upsert_thresh_cb upsert_thresh_cb,
 		    void *upsert_thresh_arg);
 
+/**
+ * Return the directory runs of storage tier @tier are stored
+ * in. Set diag and return NULL if there's no such tier, e.g.
+ * it was removed from the configuration.
+ */
+const char *
+vy_index_env_tier_path(struct vy_index_env *env, uint32_t tier);
+
 /** Destroy a common index environment. */
 void
 vy_index_env_destroy(struct vy_index_env *env);
@@ -204,6 +221,12 @@ struct vy_index {
 	 * have a particular number of runs.
 	 */
 	struct histogram *run_hist;
+	/**
+	 * zstd dictionary to compress pages of new runs with
+	 * or NULL. Trained on each dump if the index option
+	 * compression_dict_size is set, see vy_zdict.h.
+	 */
+	struct vy_zdict *zdict;
 	/**
 	 * Incremented for each change of the mem list,
 	 * to invalidate iterators.
@@ -324,6 +347,13 @@ vy_index_swap(struct vy_index *old_index, struct vy_index *new_index);
 int
 vy_index_init_range_tree(struct vy_index *index);
 
+/**
+ * Make the directory of an index on storage tier @tier
+ * unless it already exists.
+ */
+int
+vy_index_create_dir(struct vy_index *index, uint32_t tier);
+
 /**
  * Create a new vinyl index.
  *
@@ -80,6 +80,7 @@ enum vy_log_key {
 	VY_LOG_KEY_DUMP_LSN		= 9,
 	VY_LOG_KEY_GC_LSN		= 10,
 	VY_LOG_KEY_TRUNCATE_COUNT	= 11,
+	VY_LOG_KEY_TIER			= 12,
 };
 
 /** vy_log_key -> human readable name. */
@@ -96,6 +97,7 @@ static const char *vy_log_key_name[] = {
 	[VY_LOG_KEY_DUMP_LSN]		= "dump_lsn",
 	[VY_LOG_KEY_GC_LSN]		= "gc_lsn",
 	[VY_LOG_KEY_TRUNCATE_COUNT]	= "truncate_count",
+	[VY_LOG_KEY_TIER]		= "tier",
 };
 
 /** vy_log_type -> human readable name. */
@@ -247,6 +249,8 @@ struct vy_run_recovery_info {
 	 * that uses this run.
 	 */
 	int64_t gc_lsn;
+	/** Storage tier the run files are stored on. */
+	uint32_t tier;
 	/**
 	 * True if the run was not committed (there's
 	 * VY_LOG_PREPARE_RUN, but no VY_LOG_CREATE_RUN).
@@ -350,6 +354,9 @@ vy_log_record_snprint(char *buf, int size, const struct vy_log_record *record)
 		SNPRINT(total, snprintf, buf, size, "%s=%"PRIi64", ",
 			vy_log_key_name[VY_LOG_KEY_TRUNCATE_COUNT],
 			record->truncate_count);
+	if (record->tier > 0)
+		SNPRINT(total, snprintf, buf, size, "%s=%"PRIu32", ",
+			vy_log_key_name[VY_LOG_KEY_TIER], record->tier);
 	SNPRINT(total, snprintf, buf, size, "}");
 	return total;
 }
@@ -460,6 +467,11 @@ vy_log_record_encode(const struct vy_log_record *record,
 		size += mp_sizeof_uint(record->truncate_count);
 		n_keys++;
 	}
+	if (record->tier > 0) {
+		size += mp_sizeof_uint(VY_LOG_KEY_TIER);
+		size += mp_sizeof_uint(record->tier);
+		n_keys++;
+	}
 	size += mp_sizeof_map(n_keys);
 
 	/*
@@ -529,6 +541,10 @@ vy_log_record_encode(const struct vy_log_record *record,
 		pos = mp_encode_uint(pos, VY_LOG_KEY_TRUNCATE_COUNT);
 		pos = mp_encode_uint(pos, record->truncate_count);
 	}
+	if (record->tier > 0) {
+		pos = mp_encode_uint(pos, VY_LOG_KEY_TIER);
+		pos = mp_encode_uint(pos, record->tier);
+	}
 	assert(pos == tuple + size);
 
 	/*
@@ -647,6 +663,9 @@ vy_log_record_decode(struct vy_log_record *record,
 		case VY_LOG_KEY_TRUNCATE_COUNT:
 			record->truncate_count = mp_decode_uint(&pos);
 			break;
+		case VY_LOG_KEY_TIER:
+			record->tier = mp_decode_uint(&pos);
+			break;
 		default:
 			diag_set(ClientError, ER_INVALID_VYLOG_FILE,
 				 tt_sprintf("Bad record: unknown key %u",
@@ -1527,6 +1546,7 @@ vy_recovery_do_create_run(struct vy_recovery *recovery, int64_t run_id)
 	run->id = run_id;
 	run->dump_lsn = -1;
 	run->gc_lsn = -1;
+	run->tier = 0;
 	run->is_incomplete = false;
 	run->is_dropped = false;
 	rlist_create(&run->in_index);
@@ -1544,7 +1564,7 @@ vy_recovery_do_create_run(struct vy_recovery *recovery, int64_t run_id)
  */
 static int
 vy_recovery_prepare_run(struct vy_recovery *recovery, int64_t index_lsn,
-			int64_t run_id)
+			int64_t run_id, uint32_t tier)
 {
 	struct vy_index_recovery_info *index;
 	index = vy_recovery_lookup_index_by_lsn(recovery, index_lsn);
@@ -1565,6 +1585,7 @@ vy_recovery_prepare_run(struct vy_recovery *recovery, int64_t index_lsn,
 	run = vy_recovery_do_create_run(recovery, run_id);
 	if (run == NULL)
 		return -1;
+	run->tier = tier;
 	run->is_incomplete = true;
 	rlist_add_entry(&index->runs, run, in_index);
 	return 0;
@@ -1580,7 +1601,7 @@ vy_recovery_prepare_run(struct vy_recovery *recovery, int64_t index_lsn,
  */
 static int
 vy_recovery_create_run(struct vy_recovery *recovery, int64_t index_lsn,
-		       int64_t run_id, int64_t dump_lsn)
+		       int64_t run_id, int64_t dump_lsn, uint32_t tier)
 {
 	struct vy_index_recovery_info *index;
 	index = vy_recovery_lookup_index_by_lsn(recovery, index_lsn);
@@ -1612,6 +1633,7 @@ vy_recovery_create_run(struct vy_recovery *recovery, int64_t index_lsn,
 			return -1;
 	}
 	run->dump_lsn = dump_lsn;
+	run->tier = tier;
 	run->is_incomplete = false;
 	rlist_move_entry(&index->runs, run, in_index);
 	return 0;
@@ -1918,11 +1940,12 @@ vy_recovery_process_record(struct vy_recovery *recovery,
 		break;
 	case VY_LOG_PREPARE_RUN:
 		rc = vy_recovery_prepare_run(recovery, record->index_lsn,
-					     record->run_id);
+					     record->run_id, record->tier);
 		break;
 	case VY_LOG_CREATE_RUN:
 		rc = vy_recovery_create_run(recovery, record->index_lsn,
-					    record->run_id, record->dump_lsn);
+					    record->run_id, record->dump_lsn,
+					    record->tier);
 		break;
 	case VY_LOG_DROP_RUN:
 		rc = vy_recovery_drop_run(recovery, record->run_id,
@@ -2152,6 +2175,7 @@ vy_recovery_iterate_index(struct vy_index_recovery_info *index,
 		}
 		record.index_lsn = index->index_lsn;
 		record.run_id = run->id;
+		record.tier = run->tier;
 		record.is_dropped = run->is_dropped;
 		if (vy_recovery_cb_call(cb, cb_arg, &record) != 0)
 			return -1;
@@ -2163,6 +2187,7 @@ vy_recovery_iterate_index(struct vy_index_recovery_info *index,
 		record.type = VY_LOG_DROP_RUN;
 		record.run_id = run->id;
 		record.gc_lsn = run->gc_lsn;
+		record.tier = run->tier;
 		if (vy_recovery_cb_call(cb, cb_arg, &record) != 0)
 			return -1;
 	}
@@ -2187,6 +2212,7 @@ vy_recovery_iterate_index(struct vy_index_recovery_info *index,
 			record.range_id = range->id;
 			record.slice_id = slice->id;
 			record.run_id = slice->run->id;
+			record.tier = slice->run->tier;
 			record.begin = slice->begin;
 			record.end = slice->end;
 			if (vy_recovery_cb_call(cb, cb_arg, &record) != 0)
@@ -85,7 +85,7 @@ enum vy_log_record_type {
 	VY_LOG_DELETE_RANGE		= 3,
 	/**
 	 * Prepare a vinyl run file.
-	 * Requires vy_log_record::index_lsn, run_id.
+	 * Requires vy_log_record::index_lsn, run_id, tier.
 	 *
 	 * Record of this type is written before creating a run file.
 	 * It is needed to keep track of unfinished due to errors run
@@ -94,7 +94,7 @@ enum vy_log_record_type {
 	VY_LOG_PREPARE_RUN		= 4,
 	/**
 	 * Commit a vinyl run file creation.
-	 * Requires vy_log_record::index_lsn, run_id, dump_lsn.
+	 * Requires vy_log_record::index_lsn, run_id, dump_lsn, tier.
 	 *
 	 * Written after a run file was successfully created.
 	 */
@@ -204,6 +204,14 @@ struct vy_log_record {
 	int64_t gc_lsn;
 	/** Index truncate count. */
 	int64_t truncate_count;
+	/**
+	 * Storage tier the run files are stored on, see
+	 * vy_run::tier. Also set for VY_LOG_DROP_RUN and
+	 * VY_LOG_INSERT_SLICE records returned by
+	 * vy_recovery_iterate() so that run files can be
+	 * found without looking up the run.
+	 */
+	uint32_t tier;
 	/** Link in vy_log::tx. */
 	struct stailq_entry in_tx;
 };
@@ -486,19 +494,21 @@ vy_log_delete_range(int64_t range_id)
 
 /** Helper to log a vinyl run file creation. */
 static inline void
-vy_log_prepare_run(int64_t index_lsn, int64_t run_id)
+vy_log_prepare_run(int64_t index_lsn, int64_t run_id, uint32_t tier)
 {
 	struct vy_log_record record;
 	vy_log_record_init(&record);
 	record.type = VY_LOG_PREPARE_RUN;
 	record.index_lsn = index_lsn;
 	record.run_id = run_id;
+	record.tier = tier;
 	vy_log_write(&record);
 }
 
 /** Helper to log a vinyl run creation. */
 static inline void
-vy_log_create_run(int64_t index_lsn, int64_t run_id, int64_t dump_lsn)
+vy_log_create_run(int64_t index_lsn, int64_t run_id, int64_t dump_lsn,
+		  uint32_t tier)
 {
 	struct vy_log_record record;
 	vy_log_record_init(&record);
@@ -506,6 +516,7 @@ vy_log_create_run(int64_t index_lsn, int64_t run_id, int64_t dump_lsn)
 	record.index_lsn = index_lsn;
 	record.run_id = run_id;
 	record.dump_lsn = dump_lsn;
+	record.tier = tier;
 	vy_log_write(&record);
 }
 
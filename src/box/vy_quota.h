@@ -32,6 +32,7 @@
  */
 
 #include <stddef.h>
+#include <sys/types.h> /* ssize_t */
 
 #include <tarantool_ev.h> /* ev_tstamp */
 
@@ -49,9 +50,10 @@ typedef void
 (*vy_quota_exceeded_f)(struct vy_quota *quota);
 
 /**
- * Called when quota is consumed if used >= limit.
- * It is supposed to put the current fiber to sleep
- * until enough memory is freed. @timeout sepcifies
+ * Called when quota is consumed if used >= limit or
+ * the rate limit budget is exhausted. It is supposed
+ * to put the current fiber to sleep until enough memory
+ * is freed or the budget is refilled. @timeout sepcifies
  * the maximal time to wait. The function should
  * return the time left or 0 on timeout.
  */
@@ -59,7 +61,8 @@ typedef ev_tstamp
 (*vy_quota_throttled_f)(struct vy_quota *quota, ev_tstamp timeout);
 
 /**
- * Called when quota is released if used < limit.
+ * Called when quota is released if used < limit or
+ * when the rate limit budget is refilled.
  * It is supposed to wake up all throttled fibers.
  */
 typedef void
@@ -83,6 +86,21 @@ struct vy_quota {
 	size_t watermark;
 	/** Current memory consumption. */
 	size_t used;
+	/**
+	 * Max rate at which memory may be consumed, in bytes
+	 * per second, or SIZE_MAX if not limited. Used to
+	 * slow down writers smoothly before the hard limit
+	 * is hit, see vy_quota_update_rate().
+	 */
+	size_t rate_limit;
+	/**
+	 * Number of bytes that may be consumed before the
+	 * rate limit is hit. A writer is let in as long as
+	 * the budget is not negative, and is charged for
+	 * its size afterwards so that a big transaction
+	 * can't be stalled forever.
+	 */
+	ssize_t rate_budget;
 	/** Used-defined callbacks. */
 	vy_quota_exceeded_f quota_exceeded_cb;
 	vy_quota_throttled_f quota_throttled_cb;
@@ -98,6 +116,8 @@ vy_quota_init(struct vy_quota *q,
 	q->limit = SIZE_MAX;
 	q->watermark = SIZE_MAX;
 	q->used = 0;
+	q->rate_limit = SIZE_MAX;
+	q->rate_budget = 0;
 	q->quota_exceeded_cb = quota_exceeded_cb;
 	q->quota_throttled_cb = quota_throttled_cb;
 	q->quota_released_cb = quota_released_cb;
@@ -136,6 +156,30 @@ vy_quota_set_watermark(struct vy_quota *q, size_t watermark)
 		q->quota_exceeded_cb(q);
 }
 
+/**
+ * Set the rate limit and refill the budget for @interval
+ * seconds passed since the previous call. The budget is
+ * not accumulated beyond one interval so that writers
+ * idle for a while can't produce a burst. Wake up
+ * throttled fibers if the budget allows.
+ */
+static inline void
+vy_quota_update_rate(struct vy_quota *q, size_t rate_limit,
+		     double interval)
+{
+	q->rate_limit = rate_limit;
+	if (rate_limit == SIZE_MAX) {
+		q->rate_budget = 0;
+	} else {
+		ssize_t refill = (double)rate_limit * interval;
+		q->rate_budget += refill;
+		if (q->rate_budget > refill)
+			q->rate_budget = refill;
+	}
+	if (q->rate_budget >= 0 && q->used < q->limit)
+		q->quota_released_cb(q);
+}
+
 /**
  * Consume @size bytes of memory. In contrast to vy_quota_use()
  * this function does not throttle the caller.
@@ -162,12 +206,17 @@ vy_quota_release(struct vy_quota *q, size_t size)
 
 /**
  * Try to consume @size bytes of memory, throttle the caller
- * if the limit is exceeded. @timeout specifies the maximal
- * time to wait. Return 0 on success, -1 on timeout.
+ * if the limit or the rate limit is exceeded. @timeout
+ * specifies the maximal time to wait. Return 0 on success,
+ * -1 on timeout.
  */
 static inline int
 vy_quota_use(struct vy_quota *q, size_t size, ev_tstamp timeout)
 {
+	while (q->rate_budget < 0 && timeout > 0)
+		timeout = q->quota_throttled_cb(q, timeout);
+	if (q->rate_budget < 0)
+		return -1;
 	vy_quota_force_use(q, size);
 	while (q->used >= q->limit && timeout > 0)
 		timeout = q->quota_throttled_cb(q, timeout);
@@ -175,6 +224,13 @@ vy_quota_use(struct vy_quota *q, size_t size, ev_tstamp timeout)
 		vy_quota_release(q, size);
 		return -1;
 	}
+	/*
+	 * Charge the rate budget only once the memory is
+	 * actually consumed so that a writer that timed out
+	 * doesn't throttle the others for nothing.
+	 */
+	if (q->rate_limit != SIZE_MAX)
+		q->rate_budget -= size;
 	return 0;
 }
 
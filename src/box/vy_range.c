@@ -286,15 +286,10 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * to be compacted and sets @compact_priority to the number of runs in
  * this level and all preceding levels.
  */
-void
-vy_range_update_compact_priority(struct vy_range *range,
-				 const struct index_opts *opts)
+static void
+vy_range_update_compact_priority_tiered(struct vy_range *range,
+					const struct index_opts *opts)
 {
-	assert(opts->run_count_per_level > 0);
-	assert(opts->run_size_ratio > 1);
-
-	range->compact_priority = 0;
-
 	/* Total number of checked runs. */
 	uint32_t total_run_count = 0;
 	/* The total size of runs checked so far. */
@@ -365,6 +360,64 @@ vy_range_update_compact_priority(struct vy_range *range,
 	}
 }
 
+/**
+ * Leveled compaction trades write amplification for read
+ * amplification: it keeps at most one run per level, each
+ * run_size_ratio times larger than all newer runs together,
+ * so that a lookup has to check as few runs as possible.
+ * The only exception is the first level, which may have up
+ * to run_count_per_level runs so as not to rewrite the whole
+ * range on each dump.
+ *
+ * Given a range, this function finds the oldest run that is
+ * not large enough compared to the runs above it and sets
+ * @compact_priority to the number of runs down to that one,
+ * i.e. all newer runs are merged into it.
+ */
+static void
+vy_range_update_compact_priority_leveled(struct vy_range *range,
+					 const struct index_opts *opts)
+{
+	/* Total number of checked runs. */
+	uint32_t total_run_count = 0;
+	/*
+	 * The total size of runs checked so far, which is also
+	 * the estimated size of the run produced by compaction
+	 * of those runs, so a compaction scheduled at an upper
+	 * level cascades to lower levels right away if needed.
+	 */
+	uint64_t total_size = 0;
+
+	struct vy_slice *slice;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		uint64_t size = slice->count.bytes_compressed;
+		total_run_count++;
+		if (total_run_count > (uint32_t)opts->run_count_per_level &&
+		    size < total_size * opts->run_size_ratio)
+			range->compact_priority = total_run_count;
+		total_size += size;
+	}
+}
+
+void
+vy_range_update_compact_priority(struct vy_range *range,
+				 const struct index_opts *opts)
+{
+	assert(opts->run_count_per_level > 0);
+	assert(opts->run_size_ratio > 1);
+
+	range->compact_priority = 0;
+
+	switch (opts->compaction) {
+	case INDEX_COMPACTION_LEVELED:
+		vy_range_update_compact_priority_leveled(range, opts);
+		break;
+	default:
+		vy_range_update_compact_priority_tiered(range, opts);
+		break;
+	}
+}
+
 /**
  * Return true and set split_key accordingly if the range needs to be
  * split in two.
@@ -30,12 +30,14 @@
  */
 #include "vy_run.h"
 
+#include <fcntl.h>
 #include <zstd.h>
 
 #include "fiber.h"
 #include "fiber_cond.h"
 #include "fio.h"
 #include "cbus.h"
+#include "coio_aio.h"
 #include "memory.h"
 
 #include "replication.h"
@@ -58,6 +60,28 @@ static const uint64_t vy_run_info_key_map = (1 << VY_RUN_INFO_MIN_KEY) |
 
 enum { VY_BLOOM_VERSION = 0 };
 
+/**
+ * Alignment of buffers, offsets and sizes of reads from files
+ * opened with O_DIRECT. Large enough for any block device.
+ */
+enum { VY_DIRECT_IO_ALIGN = 4096 };
+
+static int
+vy_run_bloom_decode(struct bloom *bloom, const char **buffer,
+		    const char *filename);
+
+static size_t
+vy_run_bloom_encode_size(const struct bloom *bloom);
+
+char *
+vy_run_bloom_encode(const struct bloom *bloom, char *buffer);
+
+static void
+vy_page_cache_evict_all(struct vy_page_cache *cache);
+
+static void
+vy_run_evict_cached_pages(struct vy_run *run);
+
 /** xlog meta type for .run files */
 #define XLOG_META_TYPE_RUN "RUN"
 
@@ -171,6 +195,7 @@ vy_run_env_create(struct vy_run_env *env)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	rlist_create(&env->page_cache.lru);
 }
 
 /**
@@ -181,6 +206,11 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	if (env->aio != NULL) {
+		coio_aio_destroy(env->aio);
+		free(env->aio);
+	}
+	vy_page_cache_evict_all(&env->page_cache);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
@@ -189,8 +219,24 @@ vy_run_env_destroy(struct vy_run_env *env)
  * Enable coio reads for a vinyl run environment.
  */
 void
-vy_run_env_enable_coio(struct vy_run_env *env, int threads)
+vy_run_env_enable_coio(struct vy_run_env *env, int threads, int aio_depth)
 {
+	assert(env->aio == NULL);
+	if (aio_depth > 0) {
+		env->aio = malloc(sizeof(*env->aio));
+		if (env->aio == NULL)
+			panic("failed to allocate vinyl aio context");
+		if (coio_aio_create(env->aio, aio_depth) == 0) {
+			say_info("vinyl: reading run files using %s",
+				 coio_aio_backend_strs[env->aio->backend]);
+			return;
+		}
+		say_warn("vinyl: asynchronous I/O is not available, "
+			 "falling back on reader threads: %s",
+			 diag_last_error(diag_get())->errmsg);
+		free(env->aio);
+		env->aio = NULL;
+	}
 	vy_run_env_start_readers(env, threads);
 }
 
@@ -226,6 +272,8 @@ vy_page_info_destroy(struct vy_page_info *page_info)
 {
 	if (page_info->min_key != NULL)
 		free(page_info->min_key);
+	if (page_info->has_bloom)
+		bloom_destroy(&page_info->bloom, runtime.quota);
 }
 
 struct vy_run *
@@ -240,6 +288,7 @@ vy_run_new(int64_t id)
 	run->id = id;
 	run->dump_lsn = -1;
 	run->fd = -1;
+	run->direct_fd = -1;
 	run->refs = 1;
 	rlist_create(&run->in_index);
 	rlist_create(&run->in_unused);
@@ -253,14 +302,19 @@ vy_run_delete(struct vy_run *run)
 	assert(run->refs == 0);
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
+	if (run->direct_fd >= 0 && close(run->direct_fd) < 0)
+		say_syserror("close failed");
 	if (run->page_info != NULL) {
 		uint32_t page_no;
 		for (page_no = 0; page_no < run->info.page_count; ++page_no)
 			vy_page_info_destroy(run->page_info + page_no);
 		free(run->page_info);
 	}
+	vy_run_evict_cached_pages(run);
 	if (run->info.has_bloom)
 		bloom_destroy(&run->info.bloom, runtime.quota);
+	if (run->info.dict != NULL)
+		vy_zdict_unref(run->info.dict);
 	free(run->info.min_key);
 	free(run->info.max_key);
 	TRASH(run);
@@ -493,7 +547,7 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 			mp_next(&pos);
 			page->min_key = vy_key_dup(key_beg);
 			if (page->min_key == NULL)
-				return -1;
+				goto fail;
 			break;
 		case VY_PAGE_INFO_UNPACKED_SIZE:
 			page->unpacked_size = mp_decode_uint(&pos);
@@ -501,11 +555,17 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 		case VY_PAGE_INFO_ROW_INDEX_OFFSET:
 			page->row_index_offset = mp_decode_uint(&pos);
 			break;
+		case VY_PAGE_INFO_BLOOM:
+			if (vy_run_bloom_decode(&page->bloom, &pos,
+						filename) != 0)
+				goto fail;
+			page->has_bloom = true;
+			break;
 		default:
 			diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
 				 tt_sprintf("Can't decode page info: "
 					    "unknown key %u", (unsigned)key));
-			return -1;
+			goto fail;
 		}
 	}
 	if (key_map) {
@@ -514,10 +574,14 @@ vy_page_info_decode(struct vy_page_info *page, const struct xrow_header *xrow,
 			 tt_sprintf("Can't decode page info: "
 				    "missing mandatory key %s",
 				    vy_page_info_key_name(key)));
-		return -1;
+		goto fail;
 	}
 
 	return 0;
+fail:
+	vy_page_info_destroy(page);
+	memset(page, 0, sizeof(*page));
+	return -1;
 }
 
 /**
@@ -567,6 +631,40 @@ vy_run_bloom_decode(struct bloom *bloom, const char **buffer,
 	return 0;
 }
 
+/**
+ * Decode a zstd dictionary from the run info.
+ * The dictionary is stored as [id, data].
+ */
+static int
+vy_run_dict_decode(struct vy_zdict **dict, const char **pos,
+		   const char *filename)
+{
+	uint32_t array_size = mp_decode_array(pos);
+	if (array_size != 2) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 tt_sprintf("Can't decode dictionary: "
+				    "wrong array size (expected %d, got %u)",
+				    2, (unsigned)array_size));
+		return -1;
+	}
+	uint32_t id = mp_decode_uint(pos);
+	uint32_t size;
+	const char *data = mp_decode_bin(pos, &size);
+	*dict = vy_zdict_new(data, size);
+	if (*dict == NULL)
+		return -1;
+	if ((*dict)->id != id) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+			 tt_sprintf("Can't decode dictionary: "
+				    "wrong id (expected %u, got %u)",
+				    (unsigned)id, (unsigned)(*dict)->id));
+		vy_zdict_unref(*dict);
+		*dict = NULL;
+		return -1;
+	}
+	return 0;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -625,6 +723,11 @@ vy_run_info_decode(struct vy_run_info *run_info,
 			else
 				return -1;
 			break;
+		case VY_RUN_INFO_DICT:
+			if (vy_run_dict_decode(&run_info->dict, &pos,
+					       filename) != 0)
+				return -1;
+			break;
 		default:
 			diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
 				"Can't decode run info: unknown key %u",
@@ -652,6 +755,9 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->refs = 1;
+	page->run = NULL;
+	rlist_create(&page->in_lru);
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
@@ -676,6 +782,7 @@ vy_page_new(const struct vy_page_info *page_info)
 static void
 vy_page_delete(struct vy_page *page)
 {
+	assert(page->run == NULL);
 	uint32_t *row_index = page->row_index;
 	char *data = page->data;
 #if !defined(NDEBUG)
@@ -688,6 +795,155 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** {{{ vy_page_cache */
+
+/** Size of memory occupied by a page. */
+static inline size_t
+vy_page_mem_size(const struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(uint32_t);
+}
+
+/**
+ * Remove a page from the cache and drop the reference
+ * the cache holds.
+ */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache, struct vy_page *page)
+{
+	struct vy_run *run = page->run;
+	assert(run != NULL && run->page_cache == cache);
+	assert(run->cached_pages[page->page_no] == page);
+	run->cached_pages[page->page_no] = NULL;
+	page->run = NULL;
+	rlist_del_entry(page, in_lru);
+	cache->mem_used -= vy_page_mem_size(page);
+	cache->page_count--;
+	vy_page_unref(page);
+}
+
+/** Evict the oldest pages until the cache fits in its quota. */
+static void
+vy_page_cache_trim(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->mem_quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page,
+							in_lru);
+		vy_page_cache_evict(cache, page);
+		cache->evict++;
+	}
+}
+
+static void
+vy_page_cache_evict_all(struct vy_page_cache *cache)
+{
+	while (!rlist_empty(&cache->lru)) {
+		struct vy_page *page = rlist_first_entry(&cache->lru,
+							 struct vy_page,
+							 in_lru);
+		vy_page_cache_evict(cache, page);
+	}
+}
+
+/** Drop all pages of a run that is about to be deleted. */
+static void
+vy_run_evict_cached_pages(struct vy_run *run)
+{
+	if (run->cached_pages == NULL)
+		return;
+	for (uint32_t page_no = 0; page_no < run->info.page_count; page_no++) {
+		struct vy_page *page = run->cached_pages[page_no];
+		if (page != NULL)
+			vy_page_cache_evict(run->page_cache, page);
+	}
+	free(run->cached_pages);
+	run->cached_pages = NULL;
+}
+
+/**
+ * Look up a page in the cache. The caller must reference
+ * the returned page to keep it after yielding.
+ * @retval page if found
+ * @retval NULL otherwise
+ */
+static struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, struct vy_run *run,
+		  uint32_t page_no)
+{
+	if (cache->mem_quota == 0)
+		return NULL;
+	struct vy_page *page = NULL;
+	if (run->cached_pages != NULL)
+		page = run->cached_pages[page_no];
+	if (page == NULL) {
+		cache->miss++;
+		return NULL;
+	}
+	cache->hit++;
+	rlist_move_entry(&cache->lru, page, in_lru);
+	return page;
+}
+
+/**
+ * Add a page just read from disk to the cache.
+ * Failures are ignored, since the cache is optional.
+ */
+static void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_run *run,
+		  struct vy_page *page)
+{
+	size_t size = vy_page_mem_size(page);
+	if (size > cache->mem_quota)
+		return;
+	if (run->cached_pages == NULL) {
+		run->cached_pages = calloc(run->info.page_count,
+					   sizeof(*run->cached_pages));
+		if (run->cached_pages == NULL)
+			return;
+		run->page_cache = cache;
+	}
+	assert(run->page_cache == cache);
+	assert(page->page_no < run->info.page_count);
+	if (run->cached_pages[page->page_no] != NULL) {
+		/* Another fiber read the page while we were waiting. */
+		return;
+	}
+	run->cached_pages[page->page_no] = page;
+	page->run = run;
+	vy_page_ref(page);
+	rlist_add_entry(&cache->lru, page, in_lru);
+	cache->mem_used += size;
+	cache->page_count++;
+	vy_page_cache_trim(cache);
+}
+
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	struct vy_page_cache *cache = &env->page_cache;
+	cache->mem_quota = quota;
+	vy_page_cache_trim(cache);
+}
+
+/** }}} vy_page_cache */
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -772,7 +1028,7 @@ vy_run_iterator_cache_put(struct vy_run_iterator *itr, struct vy_page *page,
 			  uint32_t page_no)
 {
 	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
+		vy_page_unref(itr->prev_page);
 	itr->prev_page = itr->curr_page;
 	itr->curr_page = page;
 	page->page_no = page_no;
@@ -790,9 +1046,9 @@ vy_run_iterator_cache_clean(struct vy_run_iterator *itr)
 		itr->curr_stmt_pos.page_no = UINT32_MAX;
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -831,65 +1087,86 @@ vy_row_index_decode(uint32_t *row_index, uint32_t row_count,
 }
 
 /**
- * Read a page requests from vinyl xlog data file.
+ * Check the outcome of reading a page from vinyl xlog data
+ * file and decode the page.
+ * @data points to the page tx, @readen is the number of bytes
+ * read there or -1 if the read failed, with errno set.
  *
  * @retval 0 on success
  * @retval -1 on error, check diag
  */
 static int
-vy_page_read(struct vy_page *page, const struct vy_page_info *page_info, int fd,
-	     ZSTD_DStream *zdctx)
+vy_page_decode(struct vy_page *page, const struct vy_page_info *page_info,
+	       const char *data, ssize_t readen, ZSTD_DStream *zdctx,
+	       const struct vy_zdict *dict)
 {
-	/* read xlog tx from xlog file */
-	size_t region_svp = region_used(&fiber()->gc);
-	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
-	if (data == NULL) {
-		diag_set(OutOfMemory, page_info->size, "region gc", "page");
-		return -1;
-	}
-	ssize_t readen = fio_pread(fd, data, page_info->size,
-				   page_info->offset);
 	if (readen < 0) {
 		/* TODO: report filename */
 		diag_set(SystemError, "failed to read from file");
-		goto error;
+		return -1;
 	}
-	if (readen != (ssize_t)page_info->size) {
+	if (readen < (ssize_t)page_info->size) {
 		/* TODO: replace with XlogError, report filename */
 		diag_set(ClientError, ER_INVALID_RUN_FILE,
 			 "Unexpected end of file");
-		goto error;
+		return -1;
 	}
-	ERROR_INJECT(ERRINJ_VY_READ_PAGE_TIMEOUT, {usleep(50000);});
-
 	/* decode xlog tx */
 	const char *data_pos = data;
-	const char *data_end = data + readen;
+	const char *data_end = data + page_info->size;
 	char *rows = page->data;
 	char *rows_end = rows + page_info->unpacked_size;
-	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx) != 0)
-		goto error;
+	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx,
+			   dict != NULL ? dict->ddict : NULL) != 0)
+		return -1;
 
 	struct xrow_header xrow;
 	data_pos = page->data + page_info->row_index_offset;
 	data_end = page->data + page_info->unpacked_size;
 	if (xrow_header_decode(&xrow, &data_pos, data_end) == -1)
-		goto error;
+		return -1;
 	if (xrow.type != VY_RUN_ROW_INDEX) {
 		/* TODO: report filename */
 		diag_set(ClientError, ER_INVALID_RUN_FILE,
 			 tt_sprintf("Wrong row index type "
 				    "(expected %d, got %u)",
 				    VY_RUN_ROW_INDEX, (unsigned)xrow.type));
-		goto error;
+		return -1;
 	}
 	if (vy_row_index_decode(page->row_index, page->row_count, &xrow) != 0)
-		goto error;
-	region_truncate(&fiber()->gc, region_svp);
+		return -1;
 	ERROR_INJECT(ERRINJ_VY_READ_PAGE, {
 		diag_set(ClientError, ER_INJECTION, "vinyl page read");
 		return -1;});
 	return 0;
+}
+
+/**
+ * Read a page requests from vinyl xlog data file.
+ *
+ * @retval 0 on success
+ * @retval -1 on error, check diag
+ */
+static int
+vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
+	     struct vy_run *run, ZSTD_DStream *zdctx)
+{
+	/* read xlog tx from xlog file */
+	size_t region_svp = region_used(&fiber()->gc);
+	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, page_info->size, "region gc", "page");
+		return -1;
+	}
+	ssize_t readen = fio_pread(run->fd, data, page_info->size,
+				   page_info->offset);
+	ERROR_INJECT(ERRINJ_VY_READ_PAGE_TIMEOUT, {usleep(50000);});
+
+	if (vy_page_decode(page, page_info, data, readen, zdctx,
+			   run->info.dict) != 0)
+		goto error;
+	region_truncate(&fiber()->gc, region_svp);
+	return 0;
 	error:
 	region_truncate(&fiber()->gc, region_svp);
 	return -1;
@@ -925,7 +1202,7 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	if (zdctx == NULL)
 		return -1;
 	return vy_page_read(task->page, &task->page_info,
-			    task->slice->run->fd, zdctx);
+			    task->slice->run, zdctx);
 }
 
 /**
@@ -942,32 +1219,138 @@ vy_page_read_cb_free(struct cbus_call_msg *base)
 }
 
 /**
- * Get a page by the given number the cache or load it from the disk.
+ * Return a descriptor of the run data file opened with O_DIRECT,
+ * opening it on the first call.
+ */
+static int
+vy_run_direct_fd(struct vy_run *run)
+{
+#if defined(O_DIRECT)
+	if (run->direct_fd < 0) {
+		/* Reopen the data file bypassing the OS page cache. */
+		run->direct_fd = open(tt_sprintf("/proc/self/fd/%d", run->fd),
+				      O_RDONLY | O_DIRECT);
+		if (run->direct_fd < 0) {
+			diag_set(SystemError, "failed to reopen run file "
+				 "with O_DIRECT");
+			return -1;
+		}
+	}
+	return run->direct_fd;
+#else
+	return run->fd;
+#endif
+}
+
+/**
+ * Read @count consecutive pages of a run slice starting from
+ * @page_no to @pages using asynchronous I/O. All reads are passed
+ * to the kernel in one submission and decompressed in the calling
+ * thread upon completion.
+ *
+ * @retval 0 on success
+ * @retval -1 on error, check diag
+ */
+static int
+vy_page_read_aio(struct vy_run_env *env, struct vy_slice *slice,
+		 uint32_t page_no, struct vy_page **pages, int count)
+{
+	struct vy_run *run = slice->run;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(env);
+	if (zdctx == NULL)
+		return -1;
+	int fd = run->fd;
+	uint64_t align = 1;
+	if (coio_aio_needs_direct_io(env->aio)) {
+		fd = vy_run_direct_fd(run);
+		if (fd < 0)
+			return -1;
+		align = VY_DIRECT_IO_ALIGN;
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct coio_aio_req *reqs = region_alloc(region,
+						 count * sizeof(*reqs));
+	if (reqs == NULL) {
+		diag_set(OutOfMemory, count * sizeof(*reqs),
+			 "region", "struct coio_aio_req");
+		return -1;
+	}
+	for (int i = 0; i < count; i++) {
+		struct vy_page_info *page_info =
+			vy_run_page_info(run, page_no + i);
+		uint64_t begin = page_info->offset / align * align;
+		uint64_t end = page_info->offset + page_info->size;
+		end = (end + align - 1) / align * align;
+		void *buf = region_aligned_alloc(region, end - begin, align);
+		if (buf == NULL) {
+			diag_set(OutOfMemory, end - begin, "region", "page");
+			goto error;
+		}
+		reqs[i].fd = fd;
+		reqs[i].buf = buf;
+		reqs[i].size = end - begin;
+		reqs[i].offset = begin;
+	}
+	/*
+	 * Make sure the run file descriptor won't be closed
+	 * (even worse, reopened) while the kernel is reading it.
+	 */
+	vy_slice_pin(slice);
+	int rc = coio_aio_read(env->aio, reqs, count);
+	vy_slice_unpin(slice);
+	if (rc != 0)
+		goto error;
+	ERROR_INJECT(ERRINJ_VY_READ_PAGE_TIMEOUT, {fiber_sleep(0.05);});
+	for (int i = 0; i < count; i++) {
+		struct vy_page_info *page_info =
+			vy_run_page_info(run, page_no + i);
+		/* The page may start in the middle of the buffer. */
+		ssize_t skip = page_info->offset - reqs[i].offset;
+		ssize_t readen = reqs[i].result;
+		if (readen < 0) {
+			errno = -readen;
+			readen = -1;
+		} else {
+			readen = MAX(readen - skip, 0);
+		}
+		if (vy_page_decode(pages[i], page_info,
+				   (char *)reqs[i].buf + skip, readen,
+				   zdctx, run->info.dict) != 0)
+			goto error;
+	}
+	region_truncate(region, region_svp);
+	return 0;
+error:
+	region_truncate(region, region_svp);
+	return -1;
+}
+
+/**
+ * Read a page of a run slice from the disk.
  *
  * @retval 0 success
  * @retval -1 critical error
  */
 static NODISCARD int
-vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
-			  struct vy_page **result)
+vy_run_read_page(struct vy_run_env *env, struct vy_slice *slice,
+		 uint32_t page_no, struct vy_page **result)
 {
-	struct vy_run_env *env = itr->run_env;
-	struct vy_slice *slice = itr->slice;
-
-	/* Check cache */
-	*result = vy_run_iterator_cache_get(itr, page_no);
-	if (*result != NULL)
-		return 0;
-
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	struct vy_page *page = vy_page_new(page_info);
 	if (page == NULL)
 		return -1;
+	page->page_no = page_no;
 
 	/* Read page data from the disk */
 	int rc;
-	if (env->reader_pool != NULL) {
+	if (env->aio != NULL) {
+		if (vy_page_read_aio(env, slice, page_no, &page, 1) != 0) {
+			vy_page_delete(page);
+			return -1;
+		}
+	} else if (env->reader_pool != NULL) {
 		/* Allocate a cbus task. */
 		struct vy_page_read_task *task;
 		task = mempool_alloc(&env->read_task_pool);
@@ -1020,24 +1403,393 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 			vy_page_delete(page);
 			return -1;
 		}
-		if (vy_page_read(page, page_info, slice->run->fd, zdctx) != 0) {
+		if (vy_page_read(page, page_info, slice->run, zdctx) != 0) {
 			vy_page_delete(page);
 			return -1;
 		}
 	}
+	*result = page;
+	return 0;
+}
+
+/**
+ * Read @count consecutive pages of a run slice starting from
+ * @page_no to @pages, which must be zeroed. With asynchronous
+ * I/O all pages are read with one submission, otherwise they
+ * are read one by one.
+ *
+ * @retval 0 success
+ * @retval -1 critical error
+ */
+static NODISCARD int
+vy_run_read_pages(struct vy_run_env *env, struct vy_slice *slice,
+		  uint32_t page_no, struct vy_page **pages, int count)
+{
+	if (env->aio == NULL) {
+		for (int i = 0; i < count; i++) {
+			if (vy_run_read_page(env, slice, page_no + i,
+					     &pages[i]) != 0)
+				goto error;
+		}
+		return 0;
+	}
+	for (int i = 0; i < count; i++) {
+		struct vy_page_info *page_info =
+			vy_run_page_info(slice->run, page_no + i);
+		pages[i] = vy_page_new(page_info);
+		if (pages[i] == NULL)
+			goto error;
+		pages[i]->page_no = page_no + i;
+	}
+	if (vy_page_read_aio(env, slice, page_no, pages, count) != 0)
+		goto error;
+	return 0;
+error:
+	for (int i = 0; i < count; i++) {
+		if (pages[i] != NULL)
+			vy_page_delete(pages[i]);
+		pages[i] = NULL;
+	}
+	return -1;
+}
+
+/** {{{ Read-ahead */
+
+/**
+ * Number of pages a run iterator must load one after another
+ * in the iteration order before it starts reading ahead.
+ */
+enum { VY_READAHEAD_MIN_SEQ_PAGES = 2 };
+
+/**
+ * Pages of a run slice read in advance by a run iterator.
+ * The read is done by a background fiber. If the iterator
+ * is closed before the read completes, the fiber frees
+ * the pages.
+ */
+struct vy_readahead_task {
+	/**
+	 * Next task in vy_run_iterator::readahead. Not an rlist,
+	 * because run iterators may be moved in memory.
+	 */
+	struct vy_readahead_task *next;
+	/** Run environment. */
+	struct vy_run_env *env;
+	/** Slice to read, pinned until the read completes. */
+	struct vy_slice *slice;
+	/** Number of the first page to read. */
+	uint32_t page_no;
+	/** Number of pages to read. */
+	int page_count;
+	/** Number of pages not taken by the iterator yet. */
+	int pages_left;
+	/** Memory reserved for the pages in the read-ahead budget. */
+	size_t mem_used;
+	/** Set when the read is complete. */
+	bool done;
+	/** Set if the read failed. */
+	bool failed;
+	/** Set if the iterator doesn't need the pages any more. */
+	bool orphaned;
+	/** Signaled when the read is complete. */
+	struct fiber_cond done_cond;
+	/** Pages read, a page is NULL once taken by the iterator. */
+	struct vy_page *pages[0];
+};
+
+/** Size of memory needed to load a page. */
+static inline size_t
+vy_page_info_mem_size(const struct vy_page_info *page_info)
+{
+	return sizeof(struct vy_page) + page_info->unpacked_size +
+	       page_info->row_count * sizeof(uint32_t);
+}
+
+static void
+vy_readahead_task_delete(struct vy_readahead_task *task)
+{
+	assert(task->done);
+	struct vy_readahead *ra = &task->env->readahead;
+	for (int i = 0; i < task->page_count; i++) {
+		if (task->pages[i] != NULL)
+			vy_page_delete(task->pages[i]);
+	}
+	assert(ra->mem_used >= task->mem_used);
+	ra->mem_used -= task->mem_used;
+	fiber_cond_destroy(&task->done_cond);
+	free(task);
+}
+
+static int
+vy_readahead_f(va_list ap)
+{
+	struct vy_readahead_task *task =
+		va_arg(ap, struct vy_readahead_task *);
+	/*
+	 * Errors are ignored: the iterator will read the page
+	 * itself and report the error if it is not transient.
+	 */
+	if (vy_run_read_pages(task->env, task->slice, task->page_no,
+			      task->pages, task->page_count) != 0)
+		task->failed = true;
+	else
+		task->env->readahead.read += task->page_count;
+	task->done = true;
+	vy_slice_unpin(task->slice);
+	if (task->orphaned)
+		vy_readahead_task_delete(task);
+	else
+		fiber_cond_broadcast(&task->done_cond);
+	return 0;
+}
+
+/**
+ * Start reading @count pages of the slice starting from @page_no
+ * in the background. Failures are ignored, since read-ahead is
+ * optional.
+ */
+static void
+vy_run_iterator_readahead_start(struct vy_run_iterator *itr,
+				uint32_t page_no, int count, size_t mem_used)
+{
+	struct vy_run_env *env = itr->run_env;
+	struct vy_readahead_task *task;
+	size_t size = sizeof(*task) + count * sizeof(task->pages[0]);
+	task = calloc(1, size);
+	if (task == NULL)
+		return;
+	struct fiber *f = fiber_new("vinyl.readahead", vy_readahead_f);
+	if (f == NULL) {
+		free(task);
+		return;
+	}
+	task->env = env;
+	task->slice = itr->slice;
+	task->page_no = page_no;
+	task->page_count = count;
+	task->pages_left = count;
+	task->mem_used = mem_used;
+	fiber_cond_create(&task->done_cond);
+	task->next = itr->readahead;
+	itr->readahead = task;
+	env->readahead.mem_used += mem_used;
+	vy_slice_pin(itr->slice);
+	fiber_start(f, task);
+}
+
+/**
+ * Forget all pages read in advance. Called when the iterator
+ * stops scanning sequentially.
+ */
+static void
+vy_run_iterator_readahead_drop(struct vy_run_iterator *itr)
+{
+	struct vy_readahead_task *task = itr->readahead;
+	while (task != NULL) {
+		struct vy_readahead_task *next = task->next;
+		if (task->done)
+			vy_readahead_task_delete(task);
+		else
+			task->orphaned = true;
+		task = next;
+	}
+	itr->readahead = NULL;
+	itr->readahead_begin = itr->readahead_end = 0;
+}
+
+/**
+ * Take a page read in advance, waiting for the read to complete
+ * if it is still in progress. Return NULL if the page hasn't been
+ * read in advance or the read failed.
+ */
+static struct vy_page *
+vy_run_iterator_readahead_get(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_readahead_task **prev = &itr->readahead;
+	struct vy_readahead_task *task = itr->readahead;
+	while (task != NULL && (page_no < task->page_no ||
+				page_no >= task->page_no + task->page_count)) {
+		prev = &task->next;
+		task = task->next;
+	}
+	if (task == NULL)
+		return NULL;
+	while (!task->done)
+		fiber_cond_wait(&task->done_cond);
+	struct vy_page *page = task->pages[page_no - task->page_no];
+	task->pages[page_no - task->page_no] = NULL;
+	if (page != NULL) {
+		struct vy_readahead *ra = &itr->run_env->readahead;
+		size_t size = vy_page_mem_size(page);
+		assert(task->mem_used >= size);
+		task->mem_used -= size;
+		ra->mem_used -= size;
+		ra->hit++;
+		task->pages_left--;
+	}
+	if (task->failed || task->pages_left == 0) {
+		*prev = task->next;
+		vy_readahead_task_delete(task);
+	}
+	return page;
+}
+
+/**
+ * Read pages following @page_no in the iteration order in the
+ * background if the iterator scans the slice sequentially.
+ * The number of pages read in advance is limited by the window
+ * size and the memory budget shared by all iterators.
+ */
+static void
+vy_run_iterator_readahead(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_run_env *env = itr->run_env;
+	struct vy_readahead *ra = &env->readahead;
+	struct vy_slice *slice = itr->slice;
+	struct vy_run *run = slice->run;
+
+	bool reverse = iterator_direction(itr->iterator_type) < 0;
+	if (itr->last_page_no != UINT32_MAX &&
+	    page_no == (reverse ? itr->last_page_no - 1 :
+				  itr->last_page_no + 1)) {
+		itr->seq_page_count++;
+	} else {
+		itr->seq_page_count = 1;
+		vy_run_iterator_readahead_drop(itr);
+	}
+	itr->last_page_no = page_no;
+
+	if (ra->max_pages == 0 ||
+	    itr->seq_page_count < VY_READAHEAD_MIN_SEQ_PAGES)
+		return;
+	/* Reading ahead doesn't make sense with blocking reads. */
+	if (env->aio == NULL && env->reader_pool == NULL)
+		return;
+	/*
+	 * Pages within [readahead_begin, readahead_end) have
+	 * already been read or are being read. Extend the range
+	 * in the iteration order up to the window size.
+	 */
+	if (itr->readahead_begin == itr->readahead_end)
+		itr->readahead_begin = itr->readahead_end = reverse ?
+							    page_no : page_no + 1;
+	int64_t next, stop;
+	int step = reverse ? -1 : 1;
+	if (!reverse) {
+		next = MAX(itr->readahead_end, page_no + 1);
+		stop = MIN((int64_t)page_no + ra->max_pages,
+			   (int64_t)slice->last_page_no) + 1;
+	} else {
+		next = (int64_t)MIN(itr->readahead_begin, page_no) - 1;
+		stop = MAX((int64_t)page_no - ra->max_pages,
+			   (int64_t)slice->first_page_no) - 1;
+	}
+	/*
+	 * With asynchronous I/O consecutive pages are read with
+	 * one submission, otherwise each page is read by its own
+	 * fiber so that reader threads can read them in parallel.
+	 */
+	int max_batch = env->aio != NULL ? ra->max_pages : 1;
+	int64_t batch_begin = next;
+	int batch_count = 0;
+	size_t batch_mem = 0;
+	for (; reverse ? next > stop : next < stop; next += step) {
+		struct vy_page_info *page_info = vy_run_page_info(run, next);
+		size_t size = vy_page_info_mem_size(page_info);
+		if (ra->mem_used + batch_mem + size > ra->mem_quota)
+			break;
+		bool cached = env->page_cache.mem_quota > 0 &&
+			      run->cached_pages != NULL &&
+			      run->cached_pages[next] != NULL;
+		if (!cached) {
+			if (batch_count == 0)
+				batch_begin = next;
+			batch_count++;
+			batch_mem += size;
+		}
+		if (batch_count > 0 &&
+		    (cached || batch_count == max_batch)) {
+			vy_run_iterator_readahead_start(itr,
+				reverse ? next + (cached ? 1 : 0) :
+					  batch_begin,
+				batch_count, batch_mem);
+			batch_count = 0;
+			batch_mem = 0;
+		}
+	}
+	if (batch_count > 0) {
+		vy_run_iterator_readahead_start(itr,
+			reverse ? next + 1 : batch_begin,
+			batch_count, batch_mem);
+	}
+	if (!reverse)
+		itr->readahead_end = next;
+	else
+		itr->readahead_begin = next + 1;
+}
+
+void
+vy_run_env_set_readahead(struct vy_run_env *env, uint32_t max_pages,
+			 size_t mem_quota)
+{
+	env->readahead.max_pages = max_pages;
+	env->readahead.mem_quota = mem_quota;
+}
+
+/** }}} Read-ahead */
+
+/**
+ * Get a page by the given number the cache or load it from the disk.
+ *
+ * @retval 0 success
+ * @retval -1 critical error
+ */
+static NODISCARD int
+vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_page **result)
+{
+	struct vy_run_env *env = itr->run_env;
+	struct vy_slice *slice = itr->slice;
+
+	/* Check cache */
+	*result = vy_run_iterator_cache_get(itr, page_no);
+	if (*result != NULL)
+		return 0;
+
+	/* Check the page cache shared by all iterators */
+	struct vy_page *page = vy_page_cache_get(&env->page_cache,
+						 slice->run, page_no);
+	if (page != NULL) {
+		vy_page_ref(page);
+		vy_run_iterator_cache_put(itr, page, page_no);
+		vy_run_iterator_readahead(itr, page_no);
+		*result = page;
+		return 0;
+	}
+
+	/* Check pages read in advance, otherwise read the page */
+	page = vy_run_iterator_readahead_get(itr, page_no);
+	if (page == NULL &&
+	    vy_run_read_page(env, slice, page_no, &page) != 0)
+		return -1;
 
 	/* Iterator is never used from multiple fibers */
 	assert(vy_run_iterator_cache_get(itr, page_no) == NULL);
 
 	/* Update cache */
 	vy_run_iterator_cache_put(itr, page, page_no);
+	vy_page_cache_put(&env->page_cache, slice->run, page);
 
 	/* Update read statistics. */
+	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	itr->stat->read.rows += page_info->row_count;
 	itr->stat->read.bytes += page_info->unpacked_size;
 	itr->stat->read.bytes_compressed += page_info->size;
 	itr->stat->read.pages++;
 
+	/* Read the following pages in advance if needed */
+	vy_run_iterator_readahead(itr, page_no);
+
 	*result = page;
 	return 0;
 }
@@ -1298,6 +2050,35 @@ vy_run_iterator_find_lsn(struct vy_run_iterator *itr,
 	return 0;
 }
 
+/**
+ * Check if a page bloom filter proves that a run has no
+ * statements matching a full key, so that a point lookup
+ * doesn't need to read any pages.
+ *
+ * Pages are sorted by min_key, so the key can only be stored
+ * in the last page whose min_key is <= the key. If that page
+ * starts with the key, it definitely has it.
+ */
+static bool
+vy_run_page_bloom_miss(struct vy_run *run, const struct tuple *key,
+		       uint32_t hash, const struct key_def *cmp_def)
+{
+	if (run->info.page_count == 0)
+		return false;
+	bool equal_key;
+	uint32_t page_no = vy_page_index_find_page(run, key, cmp_def,
+						   ITER_LE, &equal_key);
+	if (page_no >= run->info.page_count)
+		return false;
+	struct vy_page_info *page_info = vy_run_page_info(run, page_no);
+	if (!page_info->has_bloom)
+		return false;
+	if (vy_stmt_compare_with_raw_key(key, page_info->min_key,
+					 cmp_def) == 0)
+		return false;
+	return !bloom_possible_has(&page_info->bloom, hash);
+}
+
 /*
  * FIXME: vy_run_iterator_next_key() calls vy_run_iterator_start() which
  * recursivly calls vy_run_iterator_next_key().
@@ -1334,7 +2115,8 @@ vy_run_iterator_start_from(struct vy_run_iterator *itr,
 		} else {
 			hash = tuple_hash(key, key_def);
 		}
-		if (!bloom_possible_has(&run->info.bloom, hash)) {
+		if (!bloom_possible_has(&run->info.bloom, hash) ||
+		    vy_run_page_bloom_miss(run, key, hash, itr->cmp_def)) {
 			itr->search_ended = true;
 			itr->stat->bloom_hit++;
 			return 0;
@@ -1526,6 +2308,11 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
 
+	itr->readahead = NULL;
+	itr->readahead_begin = itr->readahead_end = 0;
+	itr->last_page_no = UINT32_MAX;
+	itr->seq_page_count = 0;
+
 	itr->search_started = false;
 	itr->search_ended = false;
 }
@@ -1816,6 +2603,7 @@ vy_run_iterator_cleanup(struct vy_stmt_iterator *vitr)
 {
 	assert(vitr->iface->cleanup == vy_run_iterator_cleanup);
 	vy_run_iterator_cache_clean((struct vy_run_iterator *) vitr);
+	vy_run_iterator_readahead_drop((struct vy_run_iterator *) vitr);
 }
 
 /**
@@ -1829,6 +2617,7 @@ vy_run_iterator_close(struct vy_stmt_iterator *vitr)
 	struct vy_run_iterator *itr = (struct vy_run_iterator *) vitr;
 	/* cleanup() must be called before */
 	assert(itr->curr_stmt == NULL && itr->curr_page == NULL);
+	assert(itr->readahead == NULL);
 	TRASH(itr);
 	(void) itr;
 }
@@ -2043,6 +2832,8 @@ static int
 vy_run_write_page(struct vy_run *run, struct xlog *data_xlog,
 		  struct vy_stmt_stream *wi, struct tuple **curr_stmt,
 		  uint64_t page_size, struct bloom_spectrum *bs,
+		  double bloom_fpr, bool page_bloom,
+		  struct vy_zdict_sampler *sampler,
 		  const struct key_def *cmp_def,
 		  const struct key_def *key_def, bool is_primary,
 		  uint32_t *page_info_capacity)
@@ -2059,6 +2850,9 @@ vy_run_write_page(struct vy_run *run, struct xlog *data_xlog,
 	/* row offsets accumulator */
 	struct ibuf row_index_buf;
 	ibuf_create(&row_index_buf, &cord()->slabc, sizeof(uint32_t) * 4096);
+	/* key hash accumulator for the page bloom filter */
+	struct ibuf hash_buf;
+	ibuf_create(&hash_buf, &cord()->slabc, sizeof(uint32_t) * 4096);
 
 	if (run->info.page_count >= *page_info_capacity) {
 		uint32_t cap = *page_info_capacity > 0 ?
@@ -2104,7 +2898,23 @@ vy_run_write_page(struct vy_run *run, struct xlog *data_xlog,
 				     cmp_def, is_primary) != 0)
 			goto error_rollback;
 
-		bloom_spectrum_add(bs, tuple_hash(*curr_stmt, key_def));
+		uint32_t hash = tuple_hash(*curr_stmt, key_def);
+		bloom_spectrum_add(bs, hash);
+		if (page_bloom) {
+			uint32_t *h = (uint32_t *) ibuf_alloc(&hash_buf,
+							      sizeof(uint32_t));
+			if (h == NULL) {
+				diag_set(OutOfMemory, sizeof(uint32_t),
+					 "ibuf", "page bloom");
+				goto error_rollback;
+			}
+			*h = hash;
+		}
+		if (sampler != NULL) {
+			uint32_t size;
+			const char *data = tuple_data_range(*curr_stmt, &size);
+			vy_zdict_sampler_add(sampler, data, size);
+		}
 
 		int64_t lsn = vy_stmt_lsn(*curr_stmt);
 		run->info.min_lsn = MIN(run->info.min_lsn, lsn);
@@ -2145,6 +2955,19 @@ vy_run_write_page(struct vy_run *run, struct xlog *data_xlog,
 	vy_stmt_unref_if_possible(last_stmt);
 	last_stmt = NULL;
 
+	if (page_bloom) {
+		if (bloom_create_compact(&page->bloom, page->row_count,
+					 bloom_fpr, runtime.quota) != 0) {
+			diag_set(OutOfMemory, 0, "bloom_create_compact",
+				 "bloom");
+			goto error_rollback;
+		}
+		page->has_bloom = true;
+		const uint32_t *h = (const uint32_t *) hash_buf.rpos;
+		for (uint32_t i = 0; i < page->row_count; i++)
+			bloom_add(&page->bloom, h[i]);
+	}
+
 	/* Save offset to row index  */
 	page->row_index_offset = page->unpacked_size;
 
@@ -2175,12 +2998,16 @@ vy_run_write_page(struct vy_run *run, struct xlog *data_xlog,
 	vy_run_acct_page(run, page);
 
 	ibuf_destroy(&row_index_buf);
+	ibuf_destroy(&hash_buf);
 	return !end_of_run ? 0: 1;
 
 error_rollback:
 	xlog_tx_rollback(data_xlog);
 error_row_index:
+	if (page != NULL)
+		vy_page_info_destroy(page);
 	ibuf_destroy(&row_index_buf);
+	ibuf_destroy(&hash_buf);
 	if (last_stmt != NULL)
 		vy_stmt_unref_if_possible(last_stmt);
 	return -1;
@@ -2198,7 +3025,8 @@ vy_run_write_data(struct vy_run *run, const char *dirpath,
 		  struct vy_stmt_stream *wi, uint64_t page_size,
 		  const struct key_def *cmp_def,
 		  const struct key_def *key_def,
-		  size_t max_output_count, double bloom_fpr)
+		  size_t max_output_count, double bloom_fpr,
+		  bool page_bloom, struct vy_zdict_sampler *sampler)
 {
 	struct tuple *stmt;
 
@@ -2230,6 +3058,8 @@ vy_run_write_data(struct vy_run *run, const char *dirpath,
 	};
 	if (xlog_create(&data_xlog, path, &meta) < 0)
 		goto err_free_bloom;
+	if (run->info.dict != NULL)
+		data_xlog.zdict = run->info.dict->cdict;
 
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
@@ -2239,8 +3069,9 @@ vy_run_write_data(struct vy_run *run, const char *dirpath,
 	int rc;
 	do {
 		rc = vy_run_write_page(run, &data_xlog, wi, &stmt,
-				       page_size, &bs, cmp_def, key_def,
-				       iid == 0, &page_info_capacity);
+				       page_size, &bs, bloom_fpr, page_bloom,
+				       sampler, cmp_def, key_def, iid == 0,
+				       &page_info_capacity);
 		if (rc < 0)
 			goto err_close_xlog;
 		fiber_gc();
@@ -2296,10 +3127,12 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	mp_next(&tmp);
 	min_key_size = tmp - page_info->min_key;
 
+	uint32_t map_size = page_info->has_bloom ? 7 : 6;
+
 	/* calc tuple size */
 	uint32_t size;
 	/* 3 items: page offset, size, and map */
-	size = mp_sizeof_map(6) +
+	size = mp_sizeof_map(map_size) +
 	       mp_sizeof_uint(VY_PAGE_INFO_OFFSET) +
 	       mp_sizeof_uint(page_info->offset) +
 	       mp_sizeof_uint(VY_PAGE_INFO_SIZE) +
@@ -2312,6 +3145,9 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	       mp_sizeof_uint(page_info->unpacked_size) +
 	       mp_sizeof_uint(VY_PAGE_INFO_ROW_INDEX_OFFSET) +
 	       mp_sizeof_uint(page_info->row_index_offset);
+	if (page_info->has_bloom)
+		size += mp_sizeof_uint(VY_PAGE_INFO_BLOOM) +
+			vy_run_bloom_encode_size(&page_info->bloom);
 
 	char *pos = region_alloc(region, size);
 	if (pos == NULL) {
@@ -2322,7 +3158,7 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	memset(xrow, 0, sizeof(*xrow));
 	/* encode page */
 	xrow->body->iov_base = pos;
-	pos = mp_encode_map(pos, 6);
+	pos = mp_encode_map(pos, map_size);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_OFFSET);
 	pos = mp_encode_uint(pos, page_info->offset);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_SIZE);
@@ -2336,6 +3172,10 @@ vy_page_info_encode(const struct vy_page_info *page_info,
 	pos = mp_encode_uint(pos, page_info->unpacked_size);
 	pos = mp_encode_uint(pos, VY_PAGE_INFO_ROW_INDEX_OFFSET);
 	pos = mp_encode_uint(pos, page_info->row_index_offset);
+	if (page_info->has_bloom) {
+		pos = mp_encode_uint(pos, VY_PAGE_INFO_BLOOM);
+		pos = vy_run_bloom_encode(&page_info->bloom, pos);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 
@@ -2406,7 +3246,9 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	size_t max_key_size = tmp - run_info->max_key;
 
 	assert(run_info->has_bloom);
-	size_t size = mp_sizeof_map(6);
+	const struct vy_zdict *dict = run_info->dict;
+	uint32_t key_count = dict != NULL ? 7 : 6;
+	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
 	size += mp_sizeof_uint(VY_RUN_INFO_MAX_KEY) + max_key_size;
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_LSN) +
@@ -2417,6 +3259,11 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 		mp_sizeof_uint(run_info->page_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_BLOOM) +
 		vy_run_bloom_encode_size(&run_info->bloom);
+	if (dict != NULL) {
+		size += mp_sizeof_uint(VY_RUN_INFO_DICT) +
+			mp_sizeof_array(2) + mp_sizeof_uint(dict->id) +
+			mp_sizeof_bin(dict->size);
+	}
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2426,7 +3273,7 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	memset(xrow, 0, sizeof(*xrow));
 	xrow->body->iov_base = pos;
 	/* encode values */
-	pos = mp_encode_map(pos, 6);
+	pos = mp_encode_map(pos, key_count);
 	pos = mp_encode_uint(pos, VY_RUN_INFO_MIN_KEY);
 	memcpy(pos, run_info->min_key, min_key_size);
 	pos += min_key_size;
@@ -2441,6 +3288,12 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	pos = mp_encode_uint(pos, run_info->page_count);
 	pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM);
 	pos = vy_run_bloom_encode(&run_info->bloom, pos);
+	if (dict != NULL) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_DICT);
+		pos = mp_encode_array(pos, 2);
+		pos = mp_encode_uint(pos, dict->id);
+		pos = mp_encode_bin(pos, dict->data, dict->size);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2509,7 +3362,8 @@ vy_run_write(struct vy_run *run, const char *dirpath,
 	     struct vy_stmt_stream *wi, uint64_t page_size,
 	     const struct key_def *cmp_def,
 	     const struct key_def *key_def,
-	     size_t max_output_count, double bloom_fpr)
+	     size_t max_output_count, double bloom_fpr,
+	     bool page_bloom, struct vy_zdict_sampler *sampler)
 {
 	ERROR_INJECT(ERRINJ_VY_RUN_WRITE,
 		     {diag_set(ClientError, ER_INJECTION,
@@ -2521,7 +3375,8 @@ vy_run_write(struct vy_run *run, const char *dirpath,
 
 	if (vy_run_write_data(run, dirpath, space_id, iid,
 			      wi, page_size, cmp_def, key_def,
-			      max_output_count, bloom_fpr) != 0)
+			      max_output_count, bloom_fpr, page_bloom,
+			      sampler) != 0)
 		return -1;
 
 	if (vy_run_is_empty(run))
@@ -2554,7 +3409,7 @@ vy_slice_stream_read_page(struct vy_slice_stream *stream)
 		return -1;
 
 	if (vy_page_read(stream->page, page_info,
-			 stream->slice->run->fd, zdctx) != 0) {
+			 stream->slice->run, zdctx) != 0) {
 		vy_page_delete(stream->page);
 		stream->page = NULL;
 		return -1;
@@ -39,6 +39,7 @@
 #include "vy_stmt.h" /* for comparators */
 #include "vy_stmt_iterator.h" /* struct vy_stmt_iterator */
 #include "vy_stat.h"
+#include "vy_zdict.h"
 
 #include "small/mempool.h"
 #include "salad/bloom.h"
@@ -48,6 +49,51 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct vy_run_reader;
+struct vy_page;
+struct vy_readahead_task;
+struct coio_aio;
+
+/**
+ * Engine-wide LRU cache of decompressed run pages, shared by
+ * all run iterators. Pages are looked up and added in the tx
+ * thread only, reader threads just fill the pages in.
+ */
+struct vy_page_cache {
+	/** LRU list of cached pages. The first element is the newest. */
+	struct rlist lru;
+	/** Size of memory occupied by cached pages. */
+	size_t mem_used;
+	/** Max memory size that can be used for cache, 0 disables it. */
+	size_t mem_quota;
+	/** Number of cached pages. */
+	int64_t page_count;
+	/** Number of lookups that found the page in the cache. */
+	int64_t hit;
+	/** Number of lookups that had to read the page from disk. */
+	int64_t miss;
+	/** Number of pages evicted from the cache. */
+	int64_t evict;
+};
+
+/**
+ * Settings and accounting of reading run pages in advance,
+ * shared by all run iterators.
+ */
+struct vy_readahead {
+	/**
+	 * Max number of pages a run iterator scanning a run
+	 * sequentially may read in advance, 0 disables it.
+	 */
+	uint32_t max_pages;
+	/** Max size of memory pages read in advance may use. */
+	size_t mem_quota;
+	/** Size of memory used by pages read in advance. */
+	size_t mem_used;
+	/** Number of pages read in advance. */
+	int64_t read;
+	/** Number of pages read in advance and then used. */
+	int64_t hit;
+};
 
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
@@ -64,6 +110,15 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/**
+	 * Asynchronous I/O context used for reading run files
+	 * instead of the reader threads if available.
+	 */
+	struct coio_aio *aio;
+	/** Cache of decompressed pages. */
+	struct vy_page_cache page_cache;
+	/** Read-ahead of pages for sequential scans. */
+	struct vy_readahead readahead;
 };
 
 /**
@@ -84,6 +139,11 @@ struct vy_run_info {
 	bool has_bloom;
 	/** Bloom filter of all tuples in run */
 	struct bloom bloom;
+	/**
+	 * zstd dictionary pages of the run are compressed
+	 * with or NULL if pages are compressed without one.
+	 */
+	struct vy_zdict *dict;
 };
 
 /**
@@ -102,6 +162,14 @@ struct vy_page_info {
 	char *min_key;
 	/** Offset of the row index in the page. */
 	uint32_t row_index_offset;
+	/** Set iff the page has its own bloom filter. */
+	bool has_bloom;
+	/**
+	 * Bloom filter of all tuples in the page. Lets a point
+	 * lookup skip a page that passed the run bloom filter
+	 * only because some other page has the key.
+	 */
+	struct bloom bloom;
 };
 
 /**
@@ -114,12 +182,24 @@ struct vy_run {
 	struct vy_page_info *page_info;
 	/** Run data file. */
 	int fd;
+	/**
+	 * Run data file opened with O_DIRECT, used for native
+	 * AIO reads. Opened on demand, -1 if not opened.
+	 */
+	int direct_fd;
 	/** Unique ID of this run. */
 	int64_t id;
 	/** Number of statements in this run. */
 	struct vy_disk_stmt_counter count;
 	/** Max LSN stored on disk. */
 	int64_t dump_lsn;
+	/**
+	 * Storage tier the run files are stored on. Tier 0 is
+	 * vinyl_dir, tier N > 0 is the N-th directory listed in
+	 * vinyl_tiers. Dumped runs are written to tier 0 and
+	 * each compaction moves its output one tier down.
+	 */
+	uint32_t tier;
 	/**
 	 * Run reference counter, the run is deleted once it hits 0.
 	 * A new run is created with the reference counter set to 1.
@@ -139,6 +219,13 @@ struct vy_run {
 	struct rlist in_unused;
 	/** Link in vy_index::runs list. */
 	struct rlist in_index;
+	/**
+	 * Pages of this run stored in the page cache, indexed
+	 * by page number, allocated on the first insertion.
+	 */
+	struct vy_page **cached_pages;
+	/** Page cache that stores @cached_pages. */
+	struct vy_page_cache *page_cache;
 };
 
 /**
@@ -253,6 +340,21 @@ struct vy_run_iterator {
 	/** LRU cache of two active pages (two pages is enough). */
 	struct vy_page *curr_page;
 	struct vy_page *prev_page;
+	/** Pages read in advance, linked by vy_readahead_task::next. */
+	struct vy_readahead_task *readahead;
+	/**
+	 * Pages in [readahead_begin, readahead_end) have been or
+	 * are being read in advance.
+	 */
+	uint32_t readahead_begin;
+	uint32_t readahead_end;
+	/** Number of the page loaded last, UINT32_MAX if none. */
+	uint32_t last_page_no;
+	/**
+	 * Number of pages loaded one after another in the
+	 * iteration order, used to detect sequential scans.
+	 */
+	uint32_t seq_page_count;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
 	/** Search is finished, you will not get more values from iterator */
@@ -263,6 +365,15 @@ struct vy_run_iterator {
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/**
+	 * Reference counter. A page is referenced by each run
+	 * iterator and the page cache it is stored in.
+	 */
+	int refs;
+	/** Run this page belongs to, set if the page is cached. */
+	struct vy_run *run;
+	/** Link in vy_page_cache::lru. */
+	struct rlist in_lru;
 	/** Page position in the run file. */
 	uint32_t page_no;
 	/** Size of page data in memory, i.e. unpacked. */
@@ -290,12 +401,17 @@ vy_run_env_destroy(struct vy_run_env *env);
 /**
  * Enable coio reads for a vinyl run environment.
  *
- * This functions starts @threads reader threads and makes
- * the run iterator hand disk reads over to them rather than
- * read run files directly blocking the current fiber.
+ * If @aio_depth is positive, this function tries to set up
+ * asynchronous I/O with up to @aio_depth reads in flight and
+ * makes the run iterator submit disk reads to the kernel and
+ * decompress pages upon completion. If asynchronous I/O is
+ * unavailable or @aio_depth is 0, it starts @threads reader
+ * threads and makes the run iterator hand disk reads over to
+ * them. Either way, run files are not read directly blocking
+ * the current fiber.
  */
 void
-vy_run_env_enable_coio(struct vy_run_env *env, int threads);
+vy_run_env_enable_coio(struct vy_run_env *env, int threads, int aio_depth);
 
 /**
  * Disable coio reads for a vinyl run environment.
@@ -304,6 +420,24 @@ vy_run_env_enable_coio(struct vy_run_env *env, int threads);
 void
 vy_run_env_disable_coio(struct vy_run_env *env);
 
+/**
+ * Set the max size of memory the page cache of a vinyl run
+ * environment may use. Evicts pages if it is exceeded, zero
+ * disables the cache.
+ */
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota);
+
+/**
+ * Configure read-ahead of a vinyl run environment: a run
+ * iterator scanning a run sequentially reads up to @max_pages
+ * following pages in advance, while all pages read in advance
+ * may use up to @mem_quota bytes of memory.
+ */
+void
+vy_run_env_set_readahead(struct vy_run_env *env, uint32_t max_pages,
+			 size_t mem_quota);
+
 static inline struct vy_page_info *
 vy_run_page_info(struct vy_run *run, uint32_t pos)
 {
@@ -385,7 +519,8 @@ vy_run_write(struct vy_run *run, const char *dirpath,
 	     struct vy_stmt_stream *wi, uint64_t page_size,
 	     const struct key_def *cmp_def,
 	     const struct key_def *key_def,
-	     size_t max_output_count, double bloom_fpr);
+	     size_t max_output_count, double bloom_fpr,
+	     bool page_bloom, struct vy_zdict_sampler *sampler);
 
 /**
  * Allocate a new run slice.
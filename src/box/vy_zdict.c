@@ -0,0 +1,153 @@
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "vy_zdict.h"
+
+#include <assert.h>
+#include <string.h>
+#include <zdict.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "errcode.h"
+#include "trivia/util.h"
+
+/**
+ * Total size of samples to collect relative to the size of the
+ * dictionary. The zstd manual recommends about 100 times as much
+ * sample data as the dictionary size.
+ */
+enum { VY_ZDICT_SAMPLE_RATIO = 100 };
+
+/**
+ * Don't bother training a dictionary on less sample data than
+ * this many times the dictionary size: it would be overfitted
+ * to a handful of statements.
+ */
+enum { VY_ZDICT_MIN_SAMPLE_RATIO = 10 };
+
+struct vy_zdict *
+vy_zdict_new(const void *data, size_t size)
+{
+	struct vy_zdict *dict = malloc(sizeof(*dict) + size);
+	if (dict == NULL) {
+		diag_set(OutOfMemory, sizeof(*dict) + size,
+			 "malloc", "struct vy_zdict");
+		return NULL;
+	}
+	dict->refs = 1;
+	dict->id = ZDICT_getDictID(data, size);
+	dict->size = size;
+	memcpy(dict->data, data, size);
+	/* 3 is compression level, see xlog_tx_encode_zstd(). */
+	dict->cdict = ZSTD_createCDict(dict->data, size, 3);
+	dict->ddict = ZSTD_createDDict(dict->data, size);
+	if (dict->cdict == NULL || dict->ddict == NULL) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 "failed to digest dictionary");
+		vy_zdict_delete(dict);
+		return NULL;
+	}
+	return dict;
+}
+
+void
+vy_zdict_delete(struct vy_zdict *dict)
+{
+	ZSTD_freeCDict(dict->cdict);
+	ZSTD_freeDDict(dict->ddict);
+	free(dict);
+}
+
+void
+vy_zdict_sampler_create(struct vy_zdict_sampler *sampler, size_t dict_size)
+{
+	sampler->dict_size = MIN(dict_size, (size_t)VY_ZDICT_SIZE_MAX);
+	sampler->max_size = sampler->dict_size * VY_ZDICT_SAMPLE_RATIO;
+	ibuf_create(&sampler->data, &cord()->slabc, 64 * 1024);
+	ibuf_create(&sampler->sizes, &cord()->slabc, 4096);
+}
+
+void
+vy_zdict_sampler_destroy(struct vy_zdict_sampler *sampler)
+{
+	ibuf_destroy(&sampler->data);
+	ibuf_destroy(&sampler->sizes);
+}
+
+void
+vy_zdict_sampler_add(struct vy_zdict_sampler *sampler,
+		     const char *data, size_t size)
+{
+	if (ibuf_used(&sampler->data) + size > sampler->max_size)
+		return;
+	if (ibuf_reserve(&sampler->data, size) == NULL ||
+	    ibuf_reserve(&sampler->sizes, sizeof(size_t)) == NULL)
+		return;
+	memcpy(ibuf_alloc(&sampler->data, size), data, size);
+	*(size_t *)ibuf_alloc(&sampler->sizes, sizeof(size_t)) = size;
+}
+
+bool
+vy_zdict_sampler_is_ready(const struct vy_zdict_sampler *sampler)
+{
+	return sampler->dict_size > 0 &&
+	       ibuf_used(&sampler->data) >=
+	       sampler->dict_size * VY_ZDICT_MIN_SAMPLE_RATIO;
+}
+
+struct vy_zdict *
+vy_zdict_train(struct vy_zdict_sampler *sampler)
+{
+	assert(vy_zdict_sampler_is_ready(sampler));
+	unsigned sample_count = ibuf_used(&sampler->sizes) / sizeof(size_t);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	void *buf = region_alloc(region, sampler->dict_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, sampler->dict_size,
+			 "region", "dictionary");
+		return NULL;
+	}
+	struct vy_zdict *dict = NULL;
+	size_t size = ZDICT_trainFromBuffer(buf, sampler->dict_size,
+					    sampler->data.rpos,
+					    (const size_t *)sampler->sizes.rpos,
+					    sample_count);
+	if (ZDICT_isError(size)) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZDICT_getErrorName(size));
+		goto out;
+	}
+	dict = vy_zdict_new(buf, size);
+out:
+	region_truncate(region, region_svp);
+	return dict;
+}
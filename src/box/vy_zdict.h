@@ -0,0 +1,160 @@
+#ifndef INCLUDES_TARANTOOL_BOX_VY_ZDICT_H
+#define INCLUDES_TARANTOOL_BOX_VY_ZDICT_H
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY AUTHORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * AUTHORS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <small/ibuf.h>
+#include <zstd.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Max size of a zstd dictionary trained for a vinyl index.
+ * Bigger dictionaries hardly improve the compression ratio
+ * of small pages while making the training much slower.
+ */
+enum { VY_ZDICT_SIZE_MAX = 128 * 1024 };
+
+/**
+ * zstd dictionary used to compress pages of vinyl runs.
+ *
+ * A dictionary is trained on statements sampled while an index
+ * is dumped and used for all runs written by the index after
+ * that. Each run stores the dictionary its pages were compressed
+ * with in its .index file so that it can be read independently
+ * of the index.
+ *
+ * Dictionaries are reference counted, because many runs of the
+ * same index may share one. References must only be taken and
+ * dropped in the tx thread.
+ *
+ * Digesting a dictionary is expensive, so it is done once, when
+ * the dictionary is created, rather than for each page. Digested
+ * dictionaries are read-only and so may be used by many threads
+ * at the same time.
+ */
+struct vy_zdict {
+	/** Reference counter. */
+	int refs;
+	/** Dictionary ID, as stored in zstd frames. */
+	uint32_t id;
+	/** Digested dictionary for compression. */
+	ZSTD_CDict *cdict;
+	/** Digested dictionary for decompression. */
+	ZSTD_DDict *ddict;
+	/** Size of @data. */
+	size_t size;
+	/** Dictionary content. */
+	char data[0];
+};
+
+/**
+ * Allocate a dictionary with the given content.
+ * Returns NULL on failure, diag is set.
+ */
+struct vy_zdict *
+vy_zdict_new(const void *data, size_t size);
+
+/** Free a dictionary, called when the last reference is dropped. */
+void
+vy_zdict_delete(struct vy_zdict *dict);
+
+static inline void
+vy_zdict_ref(struct vy_zdict *dict)
+{
+	dict->refs++;
+}
+
+static inline void
+vy_zdict_unref(struct vy_zdict *dict)
+{
+	if (--dict->refs == 0)
+		vy_zdict_delete(dict);
+}
+
+/**
+ * Statements collected for training a dictionary.
+ * Filled and used in a worker thread while a run is written.
+ */
+struct vy_zdict_sampler {
+	/** Size of the dictionary to train. */
+	size_t dict_size;
+	/** Max total size of samples. */
+	size_t max_size;
+	/** Sampled statements, one after another. */
+	struct ibuf data;
+	/** Sizes of the sampled statements, size_t each. */
+	struct ibuf sizes;
+};
+
+/** Create a sampler for a dictionary of size @dict_size. */
+void
+vy_zdict_sampler_create(struct vy_zdict_sampler *sampler, size_t dict_size);
+
+void
+vy_zdict_sampler_destroy(struct vy_zdict_sampler *sampler);
+
+/**
+ * Add a statement to the samples. The statement is silently
+ * skipped if there are enough samples already or there is
+ * no memory to store it: sampling is best effort.
+ */
+void
+vy_zdict_sampler_add(struct vy_zdict_sampler *sampler,
+		     const char *data, size_t size);
+
+/**
+ * Return true if enough samples have been collected to
+ * train a dictionary.
+ */
+bool
+vy_zdict_sampler_is_ready(const struct vy_zdict_sampler *sampler);
+
+/**
+ * Train a dictionary on the collected samples.
+ *
+ * @retval not NULL the new dictionary
+ * @retval NULL training failed, diag is set
+ */
+struct vy_zdict *
+vy_zdict_train(struct vy_zdict_sampler *sampler);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* INCLUDES_TARANTOOL_BOX_VY_ZDICT_H */
@@ -119,6 +119,39 @@ struct wal_writer
 	struct rlist watchers;
 	/** The lock protecting the watchers list. */
 	pthread_mutex_t watchers_mutex;
+	/**
+	 * Group commit settings: for how long to hold written
+	 * transactions waiting for more before the group is
+	 * flushed and synced with a single call, and how many
+	 * transactions or bytes make the group complete earlier.
+	 * Group commit is off if the delay is zero.
+	 */
+	double commit_delay;
+	int64_t commit_max_txns;
+	int64_t commit_max_size;
+	/**
+	 * Batches which are written to the WAL buffer but not
+	 * flushed and synced yet, linked by cmsg::fifo.
+	 */
+	struct stailq group;
+	/** Number of transactions in the current group. */
+	int64_t group_txns;
+	/** WAL offset and row count at the start of the group. */
+	off_t group_offset;
+	int64_t group_rows;
+	/** Completes the group when the commit delay expires. */
+	struct ev_timer group_timer;
+	/** Group commit statistics, updated in the WAL thread. */
+	struct wal_stat stat;
+	/** Whether to preallocate WAL files - wal_preallocate. */
+	bool wal_preallocate;
+	/**
+	 * Average size of a row in the last closed WAL, used
+	 * to estimate the size of the next one.
+	 */
+	int64_t avg_row_size;
+	/** A fiber creating a spare WAL file in background. */
+	struct fiber *spare_fiber;
 };
 
 struct wal_msg: public cmsg {
@@ -152,6 +185,9 @@ wal_mode()
 static void
 wal_write_to_disk(struct cmsg *msg);
 
+static void
+wal_write_to_group(struct cmsg *msg);
+
 static void
 tx_schedule_commit(struct cmsg *msg);
 
@@ -160,10 +196,21 @@ static struct cmsg_hop wal_request_route[] = {
 	{tx_schedule_commit, NULL},
 };
 
+/**
+ * The route used with group commit. A batch is held in
+ * the WAL thread until its group is synced, so it is
+ * sent back to tx explicitly, see wal_msg_complete().
+ */
+static struct cmsg_hop wal_group_route[] = {
+	{wal_write_to_group, NULL},
+	{tx_schedule_commit, NULL},
+};
+
 static void
 wal_msg_create(struct wal_msg *batch)
 {
-	cmsg_init(batch, wal_request_route);
+	cmsg_init(batch, wal_writer_singleton.commit_delay > 0 ?
+		  wal_group_route : wal_request_route);
 	stailq_create(&batch->commit);
 	stailq_create(&batch->rollback);
 }
@@ -171,7 +218,18 @@ wal_msg_create(struct wal_msg *batch)
 static struct wal_msg *
 wal_msg(struct cmsg *msg)
 {
-	return msg->route == wal_request_route ? (struct wal_msg *) msg : NULL;
+	return msg->route == wal_request_route ||
+	       msg->route == wal_group_route ? (struct wal_msg *) msg : NULL;
+}
+
+/** Return a batch held in the WAL thread back to tx. */
+static void
+wal_msg_complete(struct wal_msg *batch)
+{
+	assert(batch->route == wal_group_route);
+	/* See cmsg_dispatch(): advance the hop before the push. */
+	batch->hop++;
+	cpipe_push(&wal_thread.tx_pipe, batch);
 }
 
 /** Write a request to a log in a single transaction. */
@@ -196,6 +254,24 @@ xlog_write_entry(struct xlog *l, struct journal_entry *entry)
 	return xlog_tx_commit(l);
 }
 
+/**
+ * Add the rows of a request to the xlog transaction of the
+ * current group. Unlike xlog_write_entry(), never writes
+ * anything to the file: the group is written on commit.
+ */
+static int
+wal_write_group_entry(struct xlog *l, struct journal_entry *entry)
+{
+	assert(!l->is_autocommit);
+	struct xrow_header **row = entry->rows;
+	for (; row < entry->rows + entry->n_rows; row++) {
+		(*row)->tm = ev_now(loop());
+		if (xlog_write_row(l, *row) < 0)
+			return -1;
+	}
+	return 0;
+}
+
 /**
  * Invoke fibers waiting for their journal_entry's to be
  * completed. The fibers are invoked in strict fifo order:
@@ -261,11 +337,26 @@ tx_schedule_rollback(struct cmsg *msg)
  * encapsulate the details just in case we may use
  * more writers in the future.
  */
+static void
+wal_group_timer_cb(ev_loop *loop, ev_timer *timer, int events);
+
+enum {
+	/**
+	 * Row size to estimate the size of the first WAL
+	 * file to preallocate.
+	 */
+	WAL_AVG_ROW_SIZE_DEFAULT = 256,
+	/** WAL files are preallocated in chunks of this size. */
+	WAL_PREALLOC_ALIGN = 1024 * 1024,
+};
+
 static void
 wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 		  const char *wal_dirname, const struct tt_uuid *instance_uuid,
 		  struct vclock *vclock, int64_t wal_max_rows,
-		  int64_t wal_max_size)
+		  int64_t wal_max_size, double commit_delay,
+		  int64_t commit_max_txns, int64_t commit_max_size,
+		  bool wal_preallocate)
 {
 	writer->wal_mode = wal_mode;
 	writer->wal_max_rows = wal_max_rows;
@@ -275,9 +366,27 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
+	/*
+	 * With group commit the WAL is synced explicitly,
+	 * once per group, rather than on every write.
+	 */
+	if (wal_mode == WAL_FSYNC && commit_delay == 0)
 		writer->wal_dir.open_wflags |= O_SYNC;
 
+	writer->commit_delay = commit_delay;
+	writer->commit_max_txns = commit_max_txns;
+	writer->commit_max_size = commit_max_size;
+	stailq_create(&writer->group);
+	writer->group_txns = 0;
+	writer->group_offset = 0;
+	writer->group_rows = 0;
+	ev_timer_init(&writer->group_timer, wal_group_timer_cb, 0, 0);
+	memset(&writer->stat, 0, sizeof(writer->stat));
+
+	writer->wal_preallocate = wal_preallocate;
+	writer->avg_row_size = WAL_AVG_ROW_SIZE_DEFAULT;
+	writer->spare_fiber = NULL;
+
 	stailq_create(&writer->rollback);
 	cmsg_init(&writer->in_rollback, NULL);
 
@@ -323,14 +432,18 @@ wal_thread_start()
 void
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
 	 const struct tt_uuid *instance_uuid, struct vclock *vclock,
-	 int64_t wal_max_rows, int64_t wal_max_size)
+	 int64_t wal_max_rows, int64_t wal_max_size,
+	 double commit_delay, int64_t commit_max_txns,
+	 int64_t commit_max_size, bool wal_preallocate)
 {
 	assert(wal_max_rows > 1);
+	assert(commit_delay >= 0);
 
 	struct wal_writer *writer = &wal_writer_singleton;
 
 	wal_writer_create(writer, wal_mode, wal_dirname, instance_uuid,
-			  vclock, wal_max_rows, wal_max_size);
+			  vclock, wal_max_rows, wal_max_size, commit_delay,
+			  commit_max_txns, commit_max_size, wal_preallocate);
 
 	xdir_scan_xc(&writer->wal_dir);
 
@@ -355,6 +468,9 @@ wal_thread_stop()
 		wal_writer_destroy(&wal_writer_singleton);
 }
 
+static void
+wal_commit_group(struct wal_writer *writer);
+
 struct wal_checkpoint: public cmsg
 {
 	struct vclock *vclock;
@@ -368,6 +484,8 @@ wal_checkpoint_f(struct cmsg *data)
 {
 	struct wal_checkpoint *msg = (struct wal_checkpoint *) data;
 	struct wal_writer *writer = &wal_writer_singleton;
+	/* The checkpoint must include all pending writes. */
+	wal_commit_group(writer);
 	if (writer->in_rollback.route != NULL) {
 		/* We're rolling back a failed write. */
 		msg->res = -1;
@@ -462,6 +580,95 @@ wal_collect_garbage(int64_t lsn)
 	fiber_set_cancellable(cancellable);
 }
 
+struct wal_stat_msg: public cbus_call_msg
+{
+	struct wal_stat *stat;
+};
+
+static int
+wal_get_stat_f(struct cbus_call_msg *data)
+{
+	struct wal_stat_msg *msg = (struct wal_stat_msg *) data;
+	*msg->stat = wal_writer_singleton.stat;
+	return 0;
+}
+
+void
+wal_get_stat(struct wal_stat *stat)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	memset(stat, 0, sizeof(*stat));
+	if (!journal_is_initialized(&writer->base) ||
+	    writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_stat_msg msg;
+	msg.stat = stat;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&wal_thread.wal_pipe, &wal_thread.tx_pipe, &msg,
+		  wal_get_stat_f, NULL, TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
+/**
+ * Estimate the size of the next WAL file from rows_per_wal
+ * and the average row size, capped by wal_max_size.
+ */
+static off_t
+wal_prealloc_size(struct wal_writer *writer)
+{
+	int64_t size = writer->wal_max_rows * writer->avg_row_size;
+	if (size > writer->wal_max_size)
+		size = writer->wal_max_size;
+	return (size + WAL_PREALLOC_ALIGN - 1) /
+	       WAL_PREALLOC_ALIGN * WAL_PREALLOC_ALIGN;
+}
+
+static ssize_t
+wal_create_spare_cb(va_list ap)
+{
+	struct xdir *dir = va_arg(ap, struct xdir *);
+	off_t size = va_arg(ap, off_t);
+	return xdir_create_spare(dir, size);
+}
+
+static int
+wal_spare_f(va_list ap)
+{
+	struct wal_writer *writer = va_arg(ap, struct wal_writer *);
+	off_t size = wal_prealloc_size(writer);
+	if (coio_call(wal_create_spare_cb, &writer->wal_dir, size) == 0)
+		writer->wal_dir.has_spare = true;
+	return 0;
+}
+
+/**
+ * Start preparing a spare preallocated WAL file in
+ * background, so that the next rotation doesn't have
+ * to wait for the file to be created and allocated.
+ */
+static void
+wal_start_spare(struct wal_writer *writer)
+{
+	if (writer->spare_fiber != NULL) {
+		if (!fiber_is_dead(writer->spare_fiber))
+			return;
+		fiber_join(writer->spare_fiber);
+		writer->spare_fiber = NULL;
+	}
+	if (writer->wal_dir.has_spare)
+		return;
+	struct fiber *f = fiber_new("wal_spare", wal_spare_f);
+	if (f == NULL) {
+		/* Not fatal, the next WAL will be created in place. */
+		error_log(diag_last_error(diag_get()));
+		diag_clear(diag_get());
+		return;
+	}
+	fiber_set_joinable(f, true);
+	writer->spare_fiber = f;
+	fiber_start(f, writer);
+}
+
 /**
  * If there is no current WAL, try to open it, and close the
  * previous WAL. We close the previous WAL only after opening
@@ -486,6 +693,10 @@ wal_opt_rotate(struct wal_writer *writer)
 	if (xlog_is_open(&writer->current_wal) &&
 	    (writer->current_wal.rows >= writer->wal_max_rows ||
 	     writer->current_wal.offset >= writer->wal_max_size)) {
+		if (writer->current_wal.rows > 0) {
+			writer->avg_row_size = writer->current_wal.offset /
+					       writer->current_wal.rows;
+		}
 		/*
 		 * We can not handle xlog_close()
 		 * failure in any reasonable way.
@@ -497,6 +708,11 @@ wal_opt_rotate(struct wal_writer *writer)
 	if (xlog_is_open(&writer->current_wal))
 		return 0;
 
+	if (writer->wal_preallocate) {
+		writer->wal_dir.prealloc_size =
+			wal_prealloc_size(writer);
+	}
+
 	struct vclock *vclock = (struct vclock *)malloc(sizeof(*vclock));
 	if (vclock == NULL) {
 		diag_set(OutOfMemory, sizeof(*vclock),
@@ -514,6 +730,8 @@ wal_opt_rotate(struct wal_writer *writer)
 	}
 	xdir_add_vclock(&writer->wal_dir, vclock);
 
+	if (writer->wal_preallocate)
+		wal_start_spare(writer);
 	return 0;
 }
 
@@ -628,6 +846,7 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 
 	struct xlog *l = &writer->current_wal;
+	off_t offset = l->offset;
 
 	/*
 	 * Iterate over requests (transactions)
@@ -679,10 +898,190 @@ done:
 			      &wal_msg->rollback);
 		wal_writer_begin_rollback(writer);
 	}
+	if (last_commit_entry != NULL) {
+		/* Without group commit every batch is a group. */
+		writer->stat.groups++;
+		stailq_foreach_entry(entry, &wal_msg->commit, fifo)
+			writer->stat.txns++;
+		writer->stat.bytes += l->offset - offset;
+	}
 	fiber_gc();
 	wal_notify_watchers(writer);
 }
 
+/**
+ * Roll back all transactions of the current group after
+ * a failed write, flush or sync: drop the buffered rows,
+ * cut whatever reached the file off the WAL and send all
+ * batches of the group back to tx for rollback. Nothing
+ * of the group is written before it is committed, so the
+ * cut bytes are never visible to relays.
+ */
+static void
+wal_rollback_group(struct wal_writer *writer)
+{
+	struct xlog *l = &writer->current_wal;
+	ev_timer_stop(loop(), &writer->group_timer);
+	/* Drop the rows buffered but not written yet. */
+	xlog_tx_rollback(l);
+	if (lseek(l->fd, writer->group_offset, SEEK_SET) < 0 ||
+	    ftruncate(l->fd, writer->group_offset) != 0)
+		panic_syserror("failed to truncate xlog after write error");
+	l->offset = writer->group_offset;
+	l->rows = writer->group_rows;
+	if (l->synced_size > (uint64_t) l->offset)
+		l->synced_size = l->offset;
+
+	wal_writer_begin_rollback(writer);
+
+	struct stailq group;
+	stailq_create(&group);
+	stailq_concat(&group, &writer->group);
+	writer->group_txns = 0;
+	struct cmsg *msg, *tmp;
+	stailq_foreach_entry_safe(msg, tmp, &group, fifo) {
+		struct wal_msg *batch = (struct wal_msg *) msg;
+		struct journal_entry *entry;
+		stailq_foreach_entry(entry, &batch->commit, fifo)
+			entry->res = -1;
+		stailq_concat(&batch->rollback, &batch->commit);
+		wal_msg_complete(batch);
+	}
+}
+
+/**
+ * Sync the WAL data to disk. Unlike xlog_sync(), never
+ * hands the sync over to a background thread: the group
+ * can't be acknowledged before the sync is complete.
+ */
+static int
+wal_sync(struct xlog *l)
+{
+	if (fdatasync(l->fd) < 0) {
+		diag_set(SystemError, "failed to sync file '%s'",
+			 l->filename);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Flush and, in fsync mode, sync the current group with
+ * a single call, then send all its batches back to tx.
+ */
+static void
+wal_commit_group(struct wal_writer *writer)
+{
+	if (stailq_empty(&writer->group))
+		return;
+	ev_timer_stop(loop(), &writer->group_timer);
+
+	struct xlog *l = &writer->current_wal;
+	if (xlog_tx_commit(l) < 0 || xlog_flush(l) < 0 ||
+	    (writer->wal_mode == WAL_FSYNC && wal_sync(l) < 0)) {
+		struct error *error = diag_last_error(diag_get());
+		if (error != NULL) {
+			error_log(error);
+			diag_clear(diag_get());
+		}
+		return wal_rollback_group(writer);
+	}
+
+	writer->stat.groups++;
+	writer->stat.txns += writer->group_txns;
+	writer->stat.bytes += l->offset - writer->group_offset;
+
+	struct stailq group;
+	stailq_create(&group);
+	stailq_concat(&group, &writer->group);
+	writer->group_txns = 0;
+	struct cmsg *msg, *tmp;
+	stailq_foreach_entry_safe(msg, tmp, &group, fifo)
+		wal_msg_complete((struct wal_msg *) msg);
+
+	wal_notify_watchers(writer);
+}
+
+static void
+wal_group_timer_cb(ev_loop *loop, ev_timer *timer, int events)
+{
+	(void) loop;
+	(void) timer;
+	(void) events;
+	wal_commit_group(&wal_writer_singleton);
+}
+
+/**
+ * Group commit counterpart of wal_write_to_disk(): write
+ * the batch to the WAL buffer and hold it in the WAL thread
+ * until the group is complete, i.e. the commit delay expires
+ * or the group reaches the configured size. All batches of
+ * a group are then flushed and synced at once, which saves
+ * a disk sync per batch when there are many concurrent
+ * writers.
+ */
+static void
+wal_write_to_group(struct cmsg *msg)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_msg *wal_msg = (struct wal_msg *) msg;
+
+	struct errinj *inj = errinj(ERRINJ_WAL_DELAY, ERRINJ_BOOL);
+	while (inj != NULL && inj->bparam)
+		usleep(10);
+
+	if (writer->in_rollback.route != NULL) {
+		/* We're rolling back a failed write. */
+		assert(stailq_empty(&writer->group));
+		stailq_concat(&wal_msg->rollback, &wal_msg->commit);
+		return wal_msg_complete(wal_msg);
+	}
+
+	/* Xlog is only rotated between groups. */
+	struct xlog *l = &writer->current_wal;
+	if (stailq_empty(&writer->group)) {
+		if (wal_opt_rotate(writer) != 0) {
+			stailq_concat(&wal_msg->rollback, &wal_msg->commit);
+			wal_writer_begin_rollback(writer);
+			return wal_msg_complete(wal_msg);
+		}
+		writer->group_offset = l->offset;
+		writer->group_rows = l->rows;
+		/*
+		 * Keep the whole group in the xlog buffer until
+		 * it is committed: otherwise the buffer would be
+		 * written out on threshold and relays could send
+		 * the rows before the group is known to be good.
+		 */
+		xlog_tx_begin(l);
+	}
+	stailq_add_tail_entry(&writer->group, msg, fifo);
+
+	struct journal_entry *entry;
+	stailq_foreach_entry(entry, &wal_msg->commit, fifo) {
+		wal_assign_lsn(writer, entry->rows, entry->rows + entry->n_rows);
+		entry->res = vclock_sum(&writer->vclock);
+		if (wal_write_group_entry(l, entry) < 0) {
+			/* Until we can pass the error to tx, log it and clear. */
+			error_log(diag_last_error(diag_get()));
+			diag_clear(diag_get());
+			fiber_gc();
+			return wal_rollback_group(writer);
+		}
+		writer->group_txns++;
+	}
+	fiber_gc();
+
+	off_t size = l->offset + obuf_size(&l->obuf) - writer->group_offset;
+	if (writer->group_txns >= writer->commit_max_txns ||
+	    size >= writer->commit_max_size) {
+		wal_commit_group(writer);
+	} else if (!ev_is_active(&writer->group_timer)) {
+		ev_timer_set(&writer->group_timer, writer->commit_delay, 0);
+		ev_timer_start(loop(), &writer->group_timer);
+	}
+}
+
 /** WAL thread main loop.  */
 static int
 wal_thread_f(va_list ap)
@@ -705,6 +1104,12 @@ wal_thread_f(va_list ap)
 
 	struct wal_writer *writer = &wal_writer_singleton;
 
+	/* Don't leave the last group unwritten. */
+	wal_commit_group(writer);
+
+	if (writer->spare_fiber != NULL)
+		fiber_join(writer->spare_fiber);
+
 	if (xlog_is_open(&writer->current_wal))
 		xlog_close(&writer->current_wal, false);
 
@@ -54,7 +54,9 @@ wal_thread_start();
 void
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
 	 const struct tt_uuid *instance_uuid, struct vclock *vclock,
-	 int64_t wal_max_rows, int64_t wal_max_size);
+	 int64_t wal_max_rows, int64_t wal_max_size,
+	 double commit_delay, int64_t commit_max_txns,
+	 int64_t commit_max_size, bool wal_preallocate);
 
 enum wal_mode
 wal_mode();
@@ -86,6 +88,23 @@ wal_atfork();
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+/** WAL group commit statistics. */
+struct wal_stat {
+	/** Number of groups written and synced as a whole. */
+	int64_t groups;
+	/** Number of transactions committed in these groups. */
+	int64_t txns;
+	/** Number of bytes written in these groups. */
+	int64_t bytes;
+};
+
+/**
+ * Get WAL group commit statistics. Returns zeros
+ * if the WAL writer is not initialized or WAL is off.
+ */
+void
+wal_get_stat(struct wal_stat *stat);
+
 /**
  * Wait till all pending changes to the WAL are flushed.
  * Rotates the WAL.
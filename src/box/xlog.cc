@@ -133,6 +133,7 @@ enum {
 #define INSTANCE_UUID_KEY_V12 "Server"
 #define VCLOCK_KEY "VClock"
 #define VERSION_KEY "Version"
+#define PREALLOCATED_KEY "Preallocated"
 
 static const char v13[] = "0.13";
 static const char v12[] = "0.12";
@@ -161,8 +162,10 @@ xlog_meta_format(const struct xlog_meta *meta, char *buf, int size)
 		"%s\n"
 		VERSION_KEY ": %s\n"
 		INSTANCE_UUID_KEY ": %s\n"
-		VCLOCK_KEY ": %s\n\n",
-		meta->filetype, v13, PACKAGE_VERSION, instance_uuid, vstr);
+		VCLOCK_KEY ": %s\n"
+		"%s\n",
+		meta->filetype, v13, PACKAGE_VERSION, instance_uuid, vstr,
+		meta->is_preallocated ? PREALLOCATED_KEY ": true\n" : "");
 	assert(total > 0);
 	free(vstr);
 	return total;
@@ -278,6 +281,12 @@ xlog_meta_parse(struct xlog_meta *meta, const char **data,
 			}
 		} else if (memcmp(key, VERSION_KEY, key_end - key) == 0) {
 			/* Ignore Version: for now */
+		} else if (memcmp(key, PREALLOCATED_KEY, key_end - key) == 0) {
+			/*
+			 * Preallocated: true
+			 */
+			meta->is_preallocated = val_end - val == 4 &&
+						memcmp(val, "true", 4) == 0;
 		} else {
 			/*
 			 * Unknown key
@@ -722,9 +731,78 @@ xlog_destroy(struct xlog *xlog)
 	xlog->fd = -1;
 }
 
+/**
+ * Allocate disk space for the first @size bytes of a file.
+ * The file size is set to @size, and the allocated space
+ * reads as zeros.
+ */
+static int
+xlog_preallocate(int fd, off_t size)
+{
+#ifdef HAVE_FALLOCATE
+	if (fallocate(fd, 0, 0, size) == 0)
+		return 0;
+	if (errno != EOPNOTSUPP)
+		return -1;
+#endif /* HAVE_FALLOCATE */
+	/*
+	 * The file system can't allocate space in advance.
+	 * At least make sure appends don't change the file
+	 * size.
+	 */
+	return ftruncate(fd, size);
+}
+
+/**
+ * Format the name of the spare file of a directory,
+ * see xdir_create_spare().
+ */
+static void
+xdir_format_spare_filename(const struct xdir *dir, char *buf, size_t size)
+{
+	snprintf(buf, size, "%s/spare%s%s", dir->dirname,
+		 dir->filename_ext, inprogress_suffix);
+}
+
 int
-xlog_create(struct xlog *xlog, const char *name,
-	    const struct xlog_meta *meta)
+xdir_create_spare(const struct xdir *dir, off_t size)
+{
+	char filename[PATH_MAX];
+	xdir_format_spare_filename(dir, filename, sizeof(filename));
+	/* Remove a spare left from the previous run, if any. */
+	if (unlink(filename) != 0 && errno != ENOENT) {
+		say_syserror("%s: failed to remove", filename);
+		return -1;
+	}
+	int fd = open(filename, O_RDWR | O_CREAT | O_EXCL, dir->mode);
+	if (fd < 0) {
+		say_syserror("%s: failed to create", filename);
+		return -1;
+	}
+	/*
+	 * Sync the file to persist the allocation, so that
+	 * syncing appends to it doesn't have to.
+	 */
+	if (xlog_preallocate(fd, size) != 0 || fsync(fd) != 0) {
+		say_syserror("%s: failed to preallocate", filename);
+		close(fd);
+		unlink(filename);
+		return -1;
+	}
+	close(fd);
+	return 0;
+}
+
+/**
+ * Create a new xlog file. If @spare is not NULL, rename the
+ * given preallocated file instead of creating a new one.
+ * Otherwise, if @prealloc_size is not 0, preallocate the new
+ * file to this size.
+ */
+static int
+xlog_create_impl(struct xlog *xlog, const char *name,
+		 const struct xlog_meta *meta, const char *spare,
+		 off_t prealloc_size)
 {
 	char meta_buf[XLOG_META_LEN_MAX];
 	int meta_len;
@@ -755,14 +833,38 @@ xlog_create(struct xlog *xlog, const char *name,
 	 * may think that this is a corrupt file and stop
 	 * replication.
 	 */
-	xlog->fd = open(xlog->filename, O_RDWR | O_CREAT | O_EXCL, 0644);
+	xlog->fd = -1;
+	if (spare != NULL) {
+		if (rename(spare, xlog->filename) == 0)
+			xlog->fd = open(xlog->filename, O_RDWR);
+		if (xlog->fd >= 0) {
+			xlog->is_preallocated = true;
+		} else {
+			/* Not fatal, create a new file instead. */
+			say_syserror("failed to use spare file %s", spare);
+			unlink(xlog->filename);
+		}
+	}
 	if (xlog->fd < 0) {
-		say_syserror("open, [%s]", name);
-		diag_set(SystemError, "failed to create file '%s'", name);
-		goto err_open;
+		xlog->fd = open(xlog->filename,
+				O_RDWR | O_CREAT | O_EXCL, 0644);
+		if (xlog->fd < 0) {
+			say_syserror("open, [%s]", name);
+			diag_set(SystemError, "failed to create file '%s'",
+				 name);
+			goto err_open;
+		}
+		if (prealloc_size > 0) {
+			if (xlog_preallocate(xlog->fd, prealloc_size) == 0)
+				xlog->is_preallocated = true;
+			else
+				say_syserror("%s: failed to preallocate",
+					     xlog->filename);
+		}
 	}
 
 	/* Format metadata */
+	xlog->meta.is_preallocated = xlog->is_preallocated;
 	meta_len = xlog_meta_format(&xlog->meta, meta_buf, sizeof(meta_buf));
 	if (meta_len < 0)
 		goto err_write;
@@ -786,6 +888,13 @@ err:
 	return -1;
 }
 
+int
+xlog_create(struct xlog *xlog, const char *name,
+	    const struct xlog_meta *meta)
+{
+	return xlog_create_impl(xlog, name, meta, NULL, 0);
+}
+
 int
 xlog_open(struct xlog *xlog, const char *name)
 {
@@ -898,7 +1007,15 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 	meta.instance_uuid = *dir->instance_uuid;
 	vclock_copy(&meta.vclock, vclock);
 
-	if (xlog_create(xlog, filename, &meta) != 0)
+	char spare[PATH_MAX];
+	const char *spare_name = NULL;
+	if (dir->has_spare) {
+		xdir_format_spare_filename(dir, spare, sizeof(spare));
+		spare_name = spare;
+		dir->has_spare = false;
+	}
+	if (xlog_create_impl(xlog, filename, &meta, spare_name,
+			     dir->prealloc_size) != 0)
 		return -1;
 
 	/* set sync interval from xdir settings */
@@ -919,31 +1036,81 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 }
 
 /**
- * Write a sequence of uncompressed xrow objects.
+ * Encode an xrow object and append it to a tx output buffer.
+ * Automatically reserve space for a fixheader when adding
+ * the first row to the buffer. The fixheader is populated
+ * at write. @sa xlog_tx_write().
  *
- * @retval -1 error
- * @retval >= 0 the number of bytes written
+ * @retval  -1 error, check diag.
+ * @retval >=0 the number of bytes appended to the buffer.
+ */
+static ssize_t
+xlog_tx_encode_row(struct obuf *obuf, const struct xrow_header *packet)
+{
+	if (obuf_size(obuf) == 0) {
+		if (!obuf_alloc(obuf, XLOG_FIXHEADER_SIZE)) {
+			tnt_error(OutOfMemory, XLOG_FIXHEADER_SIZE,
+				  "runtime arena", "xlog tx output buffer");
+			return -1;
+		}
+	}
+
+	struct obuf_svp svp = obuf_create_svp(obuf);
+	size_t page_offset = obuf_size(obuf);
+	/** encode row into iovec */
+	struct iovec iov[XROW_IOVMAX];
+	/** don't write sync to the disk */
+	int iovcnt = xrow_header_encode(packet, 0, iov, 0);
+	if (iovcnt < 0) {
+		obuf_rollback_to_svp(obuf, &svp);
+		return -1;
+	}
+	for (int i = 0; i < iovcnt; ++i) {
+		struct errinj *inj = errinj(ERRINJ_WAL_WRITE_PARTIAL,
+					    ERRINJ_INT);
+		if (inj != NULL && inj->iparam >= 0 &&
+		    obuf_size(obuf) > (size_t)inj->iparam) {
+			diag_set(ClientError, ER_INJECTION,
+				 "xlog write injection");
+			obuf_rollback_to_svp(obuf, &svp);
+			return -1;
+		};
+		if (obuf_dup(obuf, iov[i].iov_base, iov[i].iov_len) <
+		    iov[i].iov_len) {
+			tnt_error(OutOfMemory, XLOG_FIXHEADER_SIZE,
+				  "runtime arena", "xlog tx output buffer");
+			obuf_rollback_to_svp(obuf, &svp);
+			return -1;
+		}
+	}
+	assert(iovcnt <= XROW_IOVMAX);
+	return obuf_size(obuf) - page_offset;
+}
+
+/**
+ * Populate the fixheader of a sequence of uncompressed
+ * xrow objects.
  */
-static off_t
-xlog_tx_write_plain(struct xlog *log)
+static void
+xlog_tx_encode_plain(struct obuf *obuf)
 {
 	/**
 	 * We created an obuf savepoint at start of xlog_tx,
 	 * now populate it with data.
 	 */
-	char *fixheader = (char *)log->obuf.iov[0].iov_base;
+	char *fixheader = (char *)obuf->iov[0].iov_base;
 	*(log_magic_t *)fixheader = row_marker;
 	char *data = fixheader + sizeof(log_magic_t);
 
 	data = mp_encode_uint(data,
-			      obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE);
+			      obuf_size(obuf) - XLOG_FIXHEADER_SIZE);
 	/* Encode crc32 for previous row */
 	data = mp_encode_uint(data, 0);
 	/* Encode crc32 for current row */
 	uint32_t crc32c = 0;
 	struct iovec *iov;
 	size_t offset = XLOG_FIXHEADER_SIZE;
-	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
+	for (iov = obuf->iov; iov->iov_len; ++iov) {
 		crc32c = crc32_calc(crc32c,
 				    (char *)iov->iov_base + offset,
 				    iov->iov_len - offset);
@@ -962,46 +1129,52 @@ xlog_tx_write_plain(struct xlog *log)
 			data += padding - 1;
 		}
 	}
-
-	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
-		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		return -1;
-	});
-
-	ssize_t written = fio_writevn(log->fd, log->obuf.iov, log->obuf.pos + 1);
-	if (written < 0) {
-		diag_set(SystemError, "failed to write to '%s' file",
-			 log->filename);
-		return -1;
-	}
-	return obuf_size(&log->obuf);
 }
 
 /**
- * Write a compressed block of xrow objects.
+ * Compress a sequence of xrow objects from @a obuf into
+ * a single block in @a zbuf.
  * @retval -1  error
- * @retval >= 0 the number of bytes written
+ * @retval  0  success
  */
-static off_t
-xlog_tx_write_zstd(struct xlog *log)
+static int
+xlog_tx_encode_zstd(struct obuf *obuf, struct obuf *zbuf, ZSTD_CCtx *zctx,
+		    const ZSTD_CDict *zdict)
 {
-	char *fixheader = (char *)obuf_alloc(&log->zbuf,
-					     XLOG_FIXHEADER_SIZE);
+	char *fixheader = (char *)obuf_alloc(zbuf, XLOG_FIXHEADER_SIZE);
+	if (fixheader == NULL) {
+		tnt_error(OutOfMemory, XLOG_FIXHEADER_SIZE, "runtime arena",
+			  "compression buffer");
+		return -1;
+	}
 
 	uint32_t crc32c = 0;
 	struct iovec *iov;
 	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	size_t rc;
+	if (zdict != NULL) {
+		/* The level is set when the dictionary is digested. */
+#if ZSTD_VERSION_NUMBER >= 10300
+		rc = ZSTD_compressBegin_usingCDict(zctx, zdict);
+#else
+		rc = ZSTD_compressBegin_usingCDict(zctx, zdict, 0);
+#endif
+	} else
+		rc = ZSTD_compressBegin(zctx, 3);
+	if (ZSTD_isError(rc)) {
+		diag_set(ClientError, ER_COMPRESSION, ZSTD_getErrorName(rc));
+		return -1;
+	}
 	size_t offset = XLOG_FIXHEADER_SIZE;
-	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
+	for (iov = obuf->iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
 		size_t zmax_size = ZSTD_compressBound(iov->iov_len - offset);
 		/* Allocate a destination buffer. */
-		void *zdst = obuf_reserve(&log->zbuf, zmax_size);
+		void *zdst = obuf_reserve(zbuf, zmax_size);
 		if (!zdst) {
 			tnt_error(OutOfMemory, zmax_size, "runtime arena",
 				  "compression buffer");
-			goto error;
+			return -1;
 		}
 		size_t (*fcompress)(ZSTD_CCtx *, void *, size_t,
 				    const void *, size_t);
@@ -1009,22 +1182,22 @@ xlog_tx_write_zstd(struct xlog *log)
 		 * If it's the last iov or the last
 		 * log has 0 bytes, end the stream.
 		 */
-		if (iov == log->obuf.iov + log->obuf.pos ||
+		if (iov == obuf->iov + obuf->pos ||
 		    !(iov + 1)->iov_len) {
 			fcompress = ZSTD_compressEnd;
 		} else {
 			fcompress = ZSTD_compressContinue;
 		}
-		size_t zsize = fcompress(log->zctx, zdst, zmax_size,
+		size_t zsize = fcompress(zctx, zdst, zmax_size,
 					 (char *)iov->iov_base + offset,
 					 iov->iov_len - offset);
 		if (ZSTD_isError(zsize)) {
 			diag_set(ClientError, ER_COMPRESSION,
 				 ZSTD_getErrorName(zsize));
-			goto error;
+			return -1;
 		}
 		/* Advance output buffer to the end of compressed data. */
-		obuf_alloc(&log->zbuf, zsize);
+		obuf_alloc(zbuf, zsize);
 		/* Update crc32c */
 		crc32c = crc32_calc(crc32c, (char *)zdst, zsize);
 		/* Discount fixheader size for all iovs after first. */
@@ -1035,7 +1208,7 @@ xlog_tx_write_zstd(struct xlog *log)
 	char *data;
 	data = fixheader + sizeof(log_magic_t);
 	data = mp_encode_uint(data,
-			      obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE);
+			      obuf_size(zbuf) - XLOG_FIXHEADER_SIZE);
 	/* Encode crc32 for previous row */
 	data = mp_encode_uint(data, 0);
 	/* Encode crc32 for current row */
@@ -1050,26 +1223,31 @@ xlog_tx_write_zstd(struct xlog *log)
 			data += padding - 1;
 		}
 	}
+	return 0;
+}
 
-	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
-		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		obuf_reset(&log->zbuf);
-		goto error;
-	});
-
-	ssize_t written;
-	written = fio_writevn(log->fd, log->zbuf.iov,
-			      log->zbuf.pos + 1);
-	if (written < 0) {
-		diag_set(SystemError, "failed to write to '%s' file",
-			 log->filename);
-		goto error;
+/**
+ * Turn buffered rows into a self-contained xlog tx: fill in
+ * the fixheader and compress the rows if there are enough
+ * of them.
+ *
+ * @retval NULL error
+ * @retval the buffer with the encoded tx, either @a obuf
+ *         or @a zbuf
+ */
+static struct obuf *
+xlog_tx_encode(struct obuf *obuf, struct obuf *zbuf, ZSTD_CCtx *zctx,
+	       const ZSTD_CDict *zdict)
+{
+	if (obuf_size(obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
+		if (xlog_tx_encode_zstd(obuf, zbuf, zctx, zdict) != 0) {
+			obuf_reset(zbuf);
+			return NULL;
+		}
+		return zbuf;
 	}
-	obuf_reset(&log->zbuf);
-	return written;
-error:
-	obuf_reset(&log->zbuf);
-	return -1;
+	xlog_tx_encode_plain(obuf);
+	return obuf;
 }
 
 /* file syncing and posix_fadvise() should be rounded by a page boundary */
@@ -1078,26 +1256,32 @@ error:
 #define SYNC_ROUND_UP(size)	(SYNC_ROUND_DOWN(size + SYNC_MASK))
 
 /**
- * Writes xlog batch to file
+ * Write an encoded xlog tx to file, account the written
+ * rows and sync the file if necessary.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
  */
 static ssize_t
-xlog_tx_write(struct xlog *log)
+xlog_write_encoded_tx(struct xlog *log, struct obuf *data, int64_t rows)
 {
-	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
-		return 0;
 	ssize_t written;
-
-	if (obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
-		written = xlog_tx_write_zstd(log);
-	} else {
-		written = xlog_tx_write_plain(log);
+	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		written = -1;
+		goto done;
+	});
+	written = fio_writevn(log->fd, data->iov, data->pos + 1);
+	if (written < 0) {
+		diag_set(SystemError, "failed to write to '%s' file",
+			 log->filename);
 	}
+done:
 	ERROR_INJECT(ERRINJ_WAL_WRITE, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
 		written = -1;
 	});
 
-	obuf_reset(&log->obuf);
 	/*
 	 * Simplify recovery after a temporary write failure:
 	 * truncate the file to the best known good write
@@ -1110,8 +1294,7 @@ xlog_tx_write(struct xlog *log)
 		return -1;
 	}
 	log->offset += written;
-	log->rows += log->tx_rows;
-	log->tx_rows = 0;
+	log->rows += rows;
 	if ((log->sync_interval && log->offset >=
 	    (off_t)(log->synced_size + log->sync_interval)) ||
 	    (log->rate_limit && log->offset >=
@@ -1153,6 +1336,27 @@ xlog_tx_write(struct xlog *log)
 	return written;
 }
 
+/**
+ * Writes xlog batch to file
+ */
+static ssize_t
+xlog_tx_write(struct xlog *log)
+{
+	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
+		return 0;
+	ssize_t written = -1;
+	struct obuf *data = xlog_tx_encode(&log->obuf, &log->zbuf,
+					   log->zctx, log->zdict);
+	if (data != NULL)
+		written = xlog_write_encoded_tx(log, data, log->tx_rows);
+	obuf_reset(&log->obuf);
+	obuf_reset(&log->zbuf);
+	if (written < 0)
+		return -1;
+	log->tx_rows = 0;
+	return written;
+}
+
 /*
  * Add a row to a log and possibly flush the log.
  *
@@ -1162,51 +1366,11 @@ xlog_tx_write(struct xlog *log)
 ssize_t
 xlog_write_row(struct xlog *log, const struct xrow_header *packet)
 {
-	/*
-	 * Automatically reserve space for a fixheader when adding
-	 * the first row in * a log. The fixheader is populated
-	 * at write. @sa xlog_tx_write().
-	 */
-	if (obuf_size(&log->obuf) == 0) {
-		if (!obuf_alloc(&log->obuf, XLOG_FIXHEADER_SIZE)) {
-			tnt_error(OutOfMemory, XLOG_FIXHEADER_SIZE,
-				  "runtime arena", "xlog tx output buffer");
-			return -1;
-		}
-	}
-
-	struct obuf_svp svp = obuf_create_svp(&log->obuf);
-	size_t page_offset = obuf_size(&log->obuf);
-	/** encode row into iovec */
-	struct iovec iov[XROW_IOVMAX];
-	/** don't write sync to the disk */
-	int iovcnt = xrow_header_encode(packet, 0, iov, 0);
-	if (iovcnt < 0) {
-		obuf_rollback_to_svp(&log->obuf, &svp);
+	ssize_t row_size = xlog_tx_encode_row(&log->obuf, packet);
+	if (row_size < 0)
 		return -1;
-	}
-	for (int i = 0; i < iovcnt; ++i) {
-		struct errinj *inj = errinj(ERRINJ_WAL_WRITE_PARTIAL,
-					    ERRINJ_INT);
-		if (inj != NULL && inj->iparam >= 0 &&
-		    obuf_size(&log->obuf) > (size_t)inj->iparam) {
-			diag_set(ClientError, ER_INJECTION,
-				 "xlog write injection");
-			obuf_rollback_to_svp(&log->obuf, &svp);
-			return -1;
-		};
-		if (obuf_dup(&log->obuf, iov[i].iov_base, iov[i].iov_len) <
-		    iov[i].iov_len) {
-			tnt_error(OutOfMemory, XLOG_FIXHEADER_SIZE,
-				  "runtime arena", "xlog tx output buffer");
-			obuf_rollback_to_svp(&log->obuf, &svp);
-			return -1;
-		}
-	}
-	assert(iovcnt <= XROW_IOVMAX);
 	log->tx_rows++;
 
-	size_t row_size = obuf_size(&log->obuf) - page_offset;
 	if (log->is_autocommit &&
 	    obuf_size(&log->obuf) >= XLOG_TX_AUTOCOMMIT_THRESHOLD &&
 	    xlog_tx_write(log) < 0)
@@ -1268,6 +1432,81 @@ xlog_flush(struct xlog *log)
 	return xlog_tx_write(log);
 }
 
+int
+xlog_tx_block_create(struct xlog_tx_block *block)
+{
+	obuf_create(&block->obuf, &cord()->slabc,
+		    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+	obuf_create(&block->zbuf, &cord()->slabc,
+		    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+	block->rows = 0;
+	block->data = NULL;
+	block->zctx = ZSTD_createCCtx();
+	if (block->zctx == NULL) {
+		obuf_destroy(&block->obuf);
+		obuf_destroy(&block->zbuf);
+		diag_set(ClientError, ER_COMPRESSION,
+			 "failed to create context");
+		return -1;
+	}
+	return 0;
+}
+
+void
+xlog_tx_block_destroy(struct xlog_tx_block *block)
+{
+	obuf_destroy(&block->obuf);
+	obuf_destroy(&block->zbuf);
+	ZSTD_freeCCtx(block->zctx);
+	TRASH(block);
+}
+
+void
+xlog_tx_block_reset(struct xlog_tx_block *block)
+{
+	obuf_reset(&block->obuf);
+	obuf_reset(&block->zbuf);
+	block->rows = 0;
+	block->data = NULL;
+}
+
+ssize_t
+xlog_tx_block_add_row(struct xlog_tx_block *block,
+		      const struct xrow_header *packet)
+{
+	assert(block->data == NULL);
+	ssize_t row_size = xlog_tx_encode_row(&block->obuf, packet);
+	if (row_size < 0)
+		return -1;
+	block->rows++;
+	return row_size;
+}
+
+int
+xlog_tx_block_encode(struct xlog_tx_block *block)
+{
+	assert(block->data == NULL);
+	if (block->rows == 0)
+		return 0;
+	block->data = xlog_tx_encode(&block->obuf, &block->zbuf,
+				     block->zctx, NULL);
+	return block->data != NULL ? 0 : -1;
+}
+
+ssize_t
+xlog_write_tx_block(struct xlog *log, struct xlog_tx_block *block)
+{
+	if (block->data == NULL)
+		return 0;
+	/*
+	 * Keep rows of the block together: write out
+	 * whatever was buffered in the log first.
+	 */
+	if (xlog_flush(log) < 0)
+		return -1;
+	return xlog_write_encoded_tx(log, block->data, block->rows);
+}
+
 static int
 sync_cb(eio_req *req)
 {
@@ -1305,6 +1544,10 @@ xlog_close(struct xlog *l, bool reuse_fd)
 	int rc = fio_writen(l->fd, &eof_marker, sizeof(log_magic_t));
 	if (rc < 0)
 		say_syserror("%s: failed to write EOF marker", l->filename);
+	/* Cut off the unused preallocated space. */
+	if (rc >= 0 && l->is_preallocated &&
+	    ftruncate(l->fd, l->offset + sizeof(log_magic_t)) != 0)
+		say_syserror("%s: failed to truncate", l->filename);
 
 	/*
 	 * Sync the file before closing, since
@@ -1516,7 +1759,8 @@ xlog_fixheader_decode(struct xlog_fixheader *fixheader,
 
 int
 xlog_tx_decode(const char *data, const char *data_end,
-	       char *rows, char *rows_end, ZSTD_DStream *zdctx)
+	       char *rows, char *rows_end, ZSTD_DStream *zdctx,
+	       const ZSTD_DDict *zdict)
 {
 	/* Decode fixheader */
 	struct xlog_fixheader fixheader;
@@ -1551,7 +1795,16 @@ xlog_tx_decode(const char *data, const char *data_end,
 
 	/* Decompress zstd rows */
 	assert(fixheader.magic == zrow_marker);
-	ZSTD_initDStream(zdctx);
+	size_t zrc;
+	if (zdict != NULL)
+		zrc = ZSTD_initDStream_usingDDict(zdctx, zdict);
+	else
+		zrc = ZSTD_initDStream(zdctx);
+	if (ZSTD_isError(zrc)) {
+		diag_set(ClientError, ER_DECOMPRESSION,
+			 ZSTD_getErrorName(zrc));
+		return -1;
+	}
 	int rc = xlog_cursor_decompress(&rows, rows_end, &data, data_end,
 					zdctx);
 	if (rc < 0) {
@@ -1567,6 +1820,13 @@ xlog_tx_decode(const char *data, const char *data_end,
 	return 0;
 }
 
+bool
+xlog_tx_is_fixheader(char c)
+{
+	/* row_marker and zrow_marker share the first byte. */
+	return c == *(const char *)&row_marker;
+}
+
 /**
  * @retval -1 error
  * @retval 0 success
@@ -1686,6 +1946,68 @@ xlog_cursor_find_tx_magic(struct xlog_cursor *i)
 	return 0;
 }
 
+/**
+ * Handle an eof marker found at the cursor position: check
+ * that there is no more data in the file and switch the
+ * cursor to the eof state.
+ *
+ * @retval 1 eof
+ * @retval -1 error
+ */
+static int
+xlog_cursor_eof(struct xlog_cursor *i)
+{
+	int rc = xlog_cursor_ensure(i, sizeof(log_magic_t) + sizeof(char));
+	if (rc < 0)
+		return -1;
+	if (rc == 0) {
+		tnt_error(XlogError, "%s: has some data after "
+			  "eof marker at %lld", i->name,
+			  xlog_cursor_pos(i));
+		return -1;
+	}
+	i->state = XLOG_CURSOR_EOF;
+	return 1;
+}
+
+/**
+ * Drop the data read ahead past the cursor position, so
+ * that it is read from the file again next time. Used when
+ * the cursor reaches the end of data written to a
+ * preallocated file: the zeros read past it are going to be
+ * overwritten.
+ */
+static void
+xlog_cursor_rewind(struct xlog_cursor *i)
+{
+	/* in-memory mode */
+	if (i->fd < 0)
+		return;
+	i->read_offset = xlog_cursor_pos(i);
+	ibuf_reset(&i->rbuf);
+}
+
+/**
+ * Check if a tx which failed to decode is followed by zeros,
+ * i.e. is the last one written to a preallocated file. Such a
+ * tx is either being written right now or was torn by a crash,
+ * so it marks the end of data rather than a corruption.
+ */
+static bool
+xlog_cursor_is_torn_tx(struct xlog_cursor *i)
+{
+	if (!i->meta.is_preallocated)
+		return false;
+	struct xlog_fixheader fixheader;
+	const char *pos = i->rbuf.rpos;
+	size_t tx_size = XLOG_FIXHEADER_SIZE;
+	if (xlog_fixheader_decode(&fixheader, &pos, i->rbuf.wpos) == 0)
+		tx_size += fixheader.len;
+	if (xlog_cursor_ensure(i, tx_size + sizeof(log_magic_t)) != 0)
+		return false;
+	return load_u32(i->rbuf.rpos + tx_size) == 0;
+}
+
 int
 xlog_cursor_next_tx(struct xlog_cursor *i)
 {
@@ -1700,7 +2022,12 @@ xlog_cursor_next_tx(struct xlog_cursor *i)
 		return 1;
 	if (load_u32(i->rbuf.rpos) == eof_marker) {
 		/* eof marker found */
-		goto eof_found;
+		return xlog_cursor_eof(i);
+	}
+	if (load_u32(i->rbuf.rpos) == 0 && i->meta.is_preallocated) {
+		/* end of data in a preallocated file */
+		xlog_cursor_rewind(i);
+		return 1;
 	}
 
 	ssize_t to_load;
@@ -1714,28 +2041,63 @@ xlog_cursor_next_tx(struct xlog_cursor *i)
 		if (rc > 0)
 			return 1;
 	}
-	if (to_load < 0)
-		return -1;
+	if (to_load < 0) {
+		if (!xlog_cursor_is_torn_tx(i))
+			return -1;
+		diag_clear(diag_get());
+		xlog_cursor_rewind(i);
+		return 1;
+	}
 
 	i->state = XLOG_CURSOR_TX;
 	return 0;
-eof_found:
-	/*
-	 * A eof marker is read, check that there is no
-	 * more data in the file.
-	 */
-	rc = xlog_cursor_ensure(i, sizeof(log_magic_t) + sizeof(char));
+}
 
-	if (rc < 0)
-		return -1;
-	if (rc == 0) {
-		tnt_error(XlogError, "%s: has some data after "
-			  "eof marker at %lld", i->name,
-			  xlog_cursor_pos(i));
-		return -1;
+int
+xlog_cursor_skip_tx(struct xlog_cursor *i)
+{
+	assert(i->state == XLOG_CURSOR_ACTIVE);
+
+	/* load at least magic to check eof */
+	int rc = xlog_cursor_ensure(i, sizeof(log_magic_t));
+	if (rc != 0)
+		return rc;
+	if (load_u32(i->rbuf.rpos) == eof_marker)
+		return xlog_cursor_eof(i);
+	if (load_u32(i->rbuf.rpos) == 0 && i->meta.is_preallocated) {
+		/* end of data in a preallocated file */
+		xlog_cursor_rewind(i);
+		return 1;
 	}
-	i->state = XLOG_CURSOR_EOF;
-	return 1;
+
+	struct xlog_fixheader fixheader;
+	const char *pos = i->rbuf.rpos;
+	ssize_t to_load;
+	while ((to_load = xlog_fixheader_decode(&fixheader, &pos,
+						 i->rbuf.wpos)) > 0) {
+		/* not enough data in read buffer */
+		rc = xlog_cursor_ensure(i, ibuf_used(&i->rbuf) + to_load);
+		if (rc != 0)
+			return rc;
+		pos = i->rbuf.rpos;
+	}
+	if (to_load < 0) {
+		if (!xlog_cursor_is_torn_tx(i))
+			return -1;
+		diag_clear(diag_get());
+		xlog_cursor_rewind(i);
+		return 1;
+	}
+
+	size_t tx_size = XLOG_FIXHEADER_SIZE + fixheader.len;
+	if (ibuf_used(&i->rbuf) >= tx_size) {
+		i->rbuf.rpos += tx_size;
+	} else {
+		/* Don't read the rest of the tx, just seek past it. */
+		i->read_offset += tx_size - ibuf_used(&i->rbuf);
+		ibuf_reset(&i->rbuf);
+	}
+	return 0;
 }
 
 int
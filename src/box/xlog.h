@@ -136,6 +136,18 @@ struct xdir {
 	 * corresponding file cache will be marked as free
 	 */
 	uint64_t sync_interval;
+	/**
+	 * Size to preallocate new files to, so that appends
+	 * don't have to grow the file. 0 if files are not
+	 * preallocated.
+	 */
+	off_t prealloc_size;
+	/**
+	 * Set if there is a preallocated spare file, created
+	 * with xdir_create_spare(). The spare is turned into
+	 * the next file created in the directory.
+	 */
+	bool has_spare;
 };
 
 /**
@@ -229,6 +241,13 @@ struct xlog_meta {
 	 * is vector clock *at the time the snapshot is taken.
 	 */
 	struct vclock vclock;
+	/**
+	 * Text file header: set if the file was preallocated,
+	 * i.e. may be padded with zeros past the written data.
+	 * Only such files let the cursor take zeros for the end
+	 * of data, in any other file they are a corruption.
+	 */
+	bool is_preallocated;
 };
 
 /* }}} */
@@ -261,6 +280,12 @@ struct xlog {
 	char filename[PATH_MAX + 1];
 	/** Whether this file has .inprogress suffix. */
 	bool is_inprogress;
+	/**
+	 * Whether the file was preallocated, i.e. it is longer
+	 * than the data written to it and is padded with zeros.
+	 * Such a file is truncated on close.
+	 */
+	bool is_preallocated;
 	/*
 	 * If true, we can flush the data in this buffer whenever
 	 * we like, and it's usually when the buffer gets
@@ -284,6 +309,13 @@ struct xlog {
 	struct obuf obuf;
 	/** The context of zstd compression */
 	ZSTD_CCtx *zctx;
+	/**
+	 * Optional digested zstd dictionary to compress tx with,
+	 * NULL if not used. Not owned by the log. A tx compressed
+	 * with a dictionary can only be decoded with the same
+	 * dictionary passed to xlog_tx_decode().
+	 */
+	const ZSTD_CDict *zdict;
 	/**
 	 * Compressed output buffer
 	 */
@@ -344,6 +376,19 @@ int
 xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 		 const struct vclock *vclock);
 
+/**
+ * Create a spare file preallocated to @size bytes, to be
+ * turned into the next xlog created in the directory. The
+ * caller sets xdir::has_spare on success. Doesn't use fiber
+ * or diag facilities, so can be called from a coio thread;
+ * errors are logged.
+ *
+ * @retval 0 if OK
+ * @retval -1 if error
+ */
+int
+xdir_create_spare(const struct xdir *dir, off_t size);
+
 /**
  * Create new xlog writer based on fd.
  * @param fd            file descriptor
@@ -461,8 +506,102 @@ xlog_close(struct xlog *l, bool reuse_fd);
 void
 xlog_atfork(struct xlog *xlog);
 
+/* {{{ xlog_tx_block - encode an xlog tx in memory */
+
+/**
+ * A batch of rows encoded into a self-contained xlog tx
+ * (fixheader, checksum and, if the batch is big enough,
+ * zstd compression) independently of any log file.
+ * Used to offload row encoding and compression to other
+ * threads: a block is filled and encoded in one thread and
+ * then appended to a log file in another one.
+ */
+struct xlog_tx_block {
+	/** Row buffer, starts with a reserved fixheader. */
+	struct obuf obuf;
+	/** Compressed output buffer. */
+	struct obuf zbuf;
+	/** The context of zstd compression. */
+	ZSTD_CCtx *zctx;
+	/** The number of rows in the block. */
+	int64_t rows;
+	/**
+	 * The encoded tx, either obuf or zbuf. NULL until
+	 * xlog_tx_block_encode() is called.
+	 */
+	struct obuf *data;
+};
+
+/**
+ * Initialize an empty block. Block buffers are allocated
+ * from the slab cache of the current cord, so the block
+ * must be destroyed and reset in the cord it was created in.
+ *
+ * @retval 0 success
+ * @retval -1 error, check diag
+ */
+int
+xlog_tx_block_create(struct xlog_tx_block *block);
+
+/** Free all memory associated with a block. */
+void
+xlog_tx_block_destroy(struct xlog_tx_block *block);
+
+/** Discard all rows of a block, to be reused for a new batch. */
+void
+xlog_tx_block_reset(struct xlog_tx_block *block);
+
+/**
+ * Append a row to a block.
+ *
+ * @retval  -1 error, check diag.
+ * @retval >=0 the number of bytes appended to the block.
+ */
+ssize_t
+xlog_tx_block_add_row(struct xlog_tx_block *block,
+		      const struct xrow_header *packet);
+
+/** Return the size of not yet encoded block rows. */
+static inline size_t
+xlog_tx_block_size(struct xlog_tx_block *block)
+{
+	return obuf_size(&block->obuf);
+}
+
+/**
+ * Finish a block: populate the fixheader and compress the
+ * rows. No rows can be added to the block after this.
+ *
+ * @retval 0 success
+ * @retval -1 error, check diag
+ */
+int
+xlog_tx_block_encode(struct xlog_tx_block *block);
+
+/**
+ * Append an encoded block to a log file. The block may
+ * have been encoded in another thread.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+ssize_t
+xlog_write_tx_block(struct xlog *log, struct xlog_tx_block *block);
+
+/* }}} */
+
 /* {{{ xlog_tx_cursor - iterate over rows in xlog transaction */
 
+/**
+ * Return true if a byte stream starting with @a c may
+ * be an xlog tx, false if it must be something else, e.g.
+ * an iproto packet. All tx fixheaders start with the same
+ * magic byte, which is never the first byte of an iproto
+ * packet length.
+ */
+bool
+xlog_tx_is_fixheader(char c);
+
 /**
  * xlog tx iterator
  */
@@ -509,13 +648,15 @@ xlog_tx_cursor_next_row(struct xlog_tx_cursor *tx_cursor, struct xrow_header *xr
  * @param data_end the end of @a data buffer
  * @param[out] rows a buffer to store decoded rows
  * @param[out] rows_end the end of @a rows buffer
+ * @param zdict digested zstd dictionary the tx was compressed
+ *        with or NULL, see xlog::zdict
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
 xlog_tx_decode(const char *data, const char *data_end,
 	       char *rows, char *rows_end,
-	       ZSTD_DStream *zdctx);
+	       ZSTD_DStream *zdctx, const ZSTD_DDict *zdict);
 
 /* }}} */
 
@@ -605,6 +746,17 @@ xlog_cursor_close(struct xlog_cursor *cursor, bool reuse_fd);
 int
 xlog_cursor_next_tx(struct xlog_cursor *cursor);
 
+/**
+ * Skip the next tx in xlog without reading, checking and
+ * decompressing its body
+ * @param cursor cursor
+ * @retval 0 succes
+ * @retval 1 eof
+ * retval -1 error, check diag
+ */
+int
+xlog_cursor_skip_tx(struct xlog_cursor *cursor);
+
 /**
  * Fetch next xrow from current xlog tx
  *
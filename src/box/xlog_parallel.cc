@@ -0,0 +1,314 @@
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "xlog_parallel.h"
+
+#include "cbus.h"
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "xlog.h"
+#include "xrow.h"
+
+struct xlog_reader;
+
+/** A request to a reader thread to read its next tx. */
+struct xlog_reader_msg {
+	struct cbus_call_msg base;
+	struct xlog_reader *reader;
+};
+
+/** An xlog reader thread, see xlog_read_parallel(). */
+struct xlog_reader {
+	/** Reader thread. */
+	struct cord cord;
+	/** Pipe from the tx thread to the reader thread. */
+	struct cpipe reader_pipe;
+	/** Pipe from the reader thread to the tx thread. */
+	struct cpipe tx_pipe;
+	/** Name of the file to read. */
+	const char *filename;
+	/** Ordinal number of the reader. */
+	int id;
+	/** Total number of readers. */
+	int count;
+	/** File cursor, owned by the reader thread. */
+	struct xlog_cursor cursor;
+	/** Set if the cursor is open. */
+	bool is_open;
+	/**
+	 * Rows of the last tx read, pointing to the tx cursor
+	 * memory.
+	 */
+	struct xrow_header *rows;
+	/** Number of rows in the last tx read. */
+	int row_count;
+	/** Number of rows the rows array can hold. */
+	int row_capacity;
+	/** [out] 0 if the next tx was read, 1 on eof. */
+	int rc;
+	/** Message used to request the next tx. */
+	struct xlog_reader_msg msg;
+};
+
+/** State of a parallel read shared by the feeder fibers. */
+struct xlog_parallel_read {
+	/** Callback applying transactions. */
+	xlog_parallel_apply_f apply;
+	/** Callback argument. */
+	void *arg;
+	/** Id of the reader whose tx is to be applied next. */
+	int turn;
+	/** Set when the read is over, either way. */
+	bool is_done;
+	/** Set if the eof marker was found. */
+	bool is_eof;
+	/** Signalled when turn or is_done changes. */
+	struct fiber_cond cond;
+};
+
+/** Reader thread function. */
+static int
+xlog_reader_f(va_list ap)
+{
+	struct xlog_reader *reader = va_arg(ap, struct xlog_reader *);
+	struct cbus_endpoint endpoint;
+
+	cpipe_create(&reader->tx_pipe, "tx_prio");
+	cbus_endpoint_create(&endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	cpipe_destroy(&reader->tx_pipe);
+	if (reader->is_open)
+		xlog_cursor_close(&reader->cursor, false);
+	free(reader->rows);
+	return 0;
+}
+
+/** Decode rows of the current tx of a reader. */
+static int
+xlog_reader_decode_tx(struct xlog_reader *reader)
+{
+	struct xlog_tx_cursor *tx_cursor = &reader->cursor.tx_cursor;
+	reader->row_count = 0;
+	while (true) {
+		if (reader->row_count == reader->row_capacity) {
+			int capacity = MAX(reader->row_capacity * 2, 16);
+			size_t size = capacity * sizeof(*reader->rows);
+			struct xrow_header *rows = (struct xrow_header *)
+				realloc(reader->rows, size);
+			if (rows == NULL) {
+				diag_set(OutOfMemory, size, "realloc",
+					 "xlog reader rows");
+				return -1;
+			}
+			reader->rows = rows;
+			reader->row_capacity = capacity;
+		}
+		struct xrow_header *row = &reader->rows[reader->row_count];
+		int rc = xlog_tx_cursor_next_row(tx_cursor, row);
+		if (rc < 0)
+			return -1;
+		if (rc > 0)
+			return 0;
+		reader->row_count++;
+	}
+}
+
+/** Read the next tx of a reader, called in the reader thread. */
+static int
+xlog_reader_next_tx_f(struct cbus_call_msg *base)
+{
+	struct xlog_reader *reader = ((struct xlog_reader_msg *) base)->reader;
+	struct xlog_cursor *cursor = &reader->cursor;
+	int to_skip = reader->count - 1;
+	if (!reader->is_open) {
+		if (xlog_cursor_open(cursor, reader->filename) != 0)
+			return -1;
+		reader->is_open = true;
+		to_skip = reader->id;
+	}
+	if (cursor->state == XLOG_CURSOR_TX) {
+		/* The previous tx has been applied. */
+		xlog_tx_cursor_destroy(&cursor->tx_cursor);
+		cursor->state = XLOG_CURSOR_ACTIVE;
+	}
+	reader->rc = 1;
+	if (cursor->state == XLOG_CURSOR_EOF)
+		return 0;
+	for (int i = 0; i < to_skip; i++) {
+		int rc = xlog_cursor_skip_tx(cursor);
+		if (rc < 0)
+			return -1;
+		if (rc > 0)
+			return 0;
+	}
+	int rc = xlog_cursor_next_tx(cursor);
+	if (rc < 0)
+		return -1;
+	if (rc == 0 && xlog_reader_decode_tx(reader) != 0)
+		return -1;
+	reader->rc = rc;
+	return 0;
+}
+
+/**
+ * A fiber requesting transactions from one reader and
+ * applying them. Fibers take turns so that transactions
+ * are applied in the order they follow in the file.
+ */
+static int
+xlog_parallel_feed_f(va_list ap)
+{
+	struct xlog_parallel_read *read =
+		va_arg(ap, struct xlog_parallel_read *);
+	struct xlog_reader *reader = va_arg(ap, struct xlog_reader *);
+
+	while (!read->is_done) {
+		int rc = cbus_call(&reader->reader_pipe, &reader->tx_pipe,
+				   &reader->msg.base, xlog_reader_next_tx_f,
+				   NULL, TIMEOUT_INFINITY);
+		while (!read->is_done && read->turn != reader->id)
+			fiber_cond_wait(&read->cond);
+		if (read->is_done)
+			break;
+		if (rc == 0 && reader->rc == 0)
+			rc = read->apply(reader->rows, reader->row_count,
+					 read->arg);
+		if (rc != 0 || reader->rc != 0) {
+			read->is_eof = (rc == 0 &&
+				reader->cursor.state == XLOG_CURSOR_EOF);
+			read->is_done = true;
+			fiber_cond_broadcast(&read->cond);
+			return rc;
+		}
+		read->turn = (read->turn + 1) % reader->count;
+		fiber_cond_broadcast(&read->cond);
+	}
+	return 0;
+}
+
+/** Stop and join the first @a count reader threads. */
+static void
+xlog_readers_stop(struct xlog_reader *readers, int count)
+{
+	for (int i = 0; i < count; i++) {
+		struct xlog_reader *reader = &readers[i];
+		cbus_stop_loop(&reader->reader_pipe);
+		cpipe_destroy(&reader->reader_pipe);
+		if (cord_join(&reader->cord) != 0)
+			panic("failed to join xlog reader thread");
+	}
+}
+
+int
+xlog_read_parallel(const char *filename, int threads, const char *name,
+		   xlog_parallel_apply_f apply, void *arg, bool *is_eof)
+{
+	*is_eof = false;
+	struct xlog_reader *readers = (struct xlog_reader *)
+		calloc(threads, sizeof(*readers));
+	struct fiber **feeders = (struct fiber **)
+		calloc(threads, sizeof(*feeders));
+	if (readers == NULL || feeders == NULL) {
+		diag_set(OutOfMemory, threads * sizeof(*readers),
+			 "calloc", "xlog readers");
+		free(readers);
+		free(feeders);
+		return -1;
+	}
+
+	/* The name may be overwritten while the readers use it. */
+	char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s", filename);
+
+	int started = 0;
+	for (; started < threads; started++) {
+		struct xlog_reader *reader = &readers[started];
+		char cord_name[FIBER_NAME_MAX];
+
+		reader->filename = path;
+		reader->id = started;
+		reader->count = threads;
+		reader->msg.reader = reader;
+		snprintf(cord_name, sizeof(cord_name), "%s.%d", name, started);
+		if (cord_costart(&reader->cord, cord_name,
+				 xlog_reader_f, reader) != 0) {
+			xlog_readers_stop(readers, started);
+			free(readers);
+			free(feeders);
+			return -1;
+		}
+		cpipe_create(&reader->reader_pipe, cord_name);
+	}
+
+	struct xlog_parallel_read read;
+	read.apply = apply;
+	read.arg = arg;
+	read.turn = 0;
+	read.is_done = false;
+	read.is_eof = false;
+	fiber_cond_create(&read.cond);
+
+	int rc = 0;
+	int count;
+	for (count = 0; count < threads; count++) {
+		char fiber_name[FIBER_NAME_MAX];
+		snprintf(fiber_name, sizeof(fiber_name), "%s.feed.%d",
+			 name, count);
+		struct fiber *f = fiber_new(fiber_name, xlog_parallel_feed_f);
+		if (f == NULL) {
+			read.is_done = true;
+			fiber_cond_broadcast(&read.cond);
+			rc = -1;
+			break;
+		}
+		fiber_set_joinable(f, true);
+		fiber_start(f, &read, &readers[count]);
+		feeders[count] = f;
+	}
+	struct diag diag;
+	diag_create(&diag);
+	diag_move(diag_get(), &diag);
+	for (int i = 0; i < count; i++) {
+		if (fiber_join(feeders[i]) != 0) {
+			diag_move(diag_get(), &diag);
+			rc = -1;
+		}
+	}
+	diag_move(&diag, diag_get());
+	fiber_cond_destroy(&read.cond);
+	*is_eof = read.is_eof;
+
+	xlog_readers_stop(readers, started);
+	free(readers);
+	free(feeders);
+	return rc;
+}
@@ -0,0 +1,82 @@
+#ifndef TARANTOOL_BOX_XLOG_PARALLEL_H_INCLUDED
+#define TARANTOOL_BOX_XLOG_PARALLEL_H_INCLUDED
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stdbool.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct xrow_header;
+
+/**
+ * A callback invoked in the tx thread for every tx of a file
+ * read by xlog_read_parallel(), in the order the transactions
+ * follow in the file. Row bodies point to memory of the reader
+ * thread and are valid until the callback returns.
+ *
+ * @retval 0 success
+ * @retval -1 error, stop reading, check diag
+ */
+typedef int
+(*xlog_parallel_apply_f)(struct xrow_header *rows, int row_count,
+			 void *arg);
+
+/**
+ * Read an xlog file using several threads. Every thread opens
+ * the file on its own and reads, checks, decompresses and
+ * decodes every n-th tx in it, skipping the rest, where n is
+ * the number of threads. Decoded transactions are passed to
+ * @a apply in the tx thread in the file order.
+ *
+ * Readers rely on every tx in the file being intact, so it's
+ * not for forced recovery.
+ *
+ * @param filename   file to read
+ * @param threads    number of reader threads
+ * @param name       reader thread name prefix
+ * @param apply      tx callback
+ * @param arg        callback argument
+ * @param[out] is_eof set if the file ends with an eof marker
+ *
+ * @retval 0 success
+ * @retval -1 error, check diag
+ */
+int
+xlog_read_parallel(const char *filename, int threads, const char *name,
+		   xlog_parallel_apply_f apply, void *arg, bool *is_eof);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_BOX_XLOG_PARALLEL_H_INCLUDED */
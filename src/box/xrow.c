@@ -815,7 +815,7 @@ int
 xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
-		      const struct vclock *vclock)
+		      const struct vclock *vclock, bool compress)
 {
 	memset(row, 0, sizeof(*row));
 	uint32_t replicaset_size = vclock_size(vclock);
@@ -827,7 +827,7 @@ xrow_encode_subscribe(struct xrow_header *row,
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 3);
+	data = mp_encode_map(data, compress ? 4 : 3);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -840,6 +840,10 @@ xrow_encode_subscribe(struct xrow_header *row,
 		data = mp_encode_uint(data, replica.id);
 		data = mp_encode_uint(data, replica.lsn);
 	}
+	if (compress) {
+		data = mp_encode_uint(data, IPROTO_COMPRESSION);
+		data = mp_encode_bool(data, true);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -848,9 +852,41 @@ xrow_encode_subscribe(struct xrow_header *row,
 	return 0;
 }
 
+/** Decode IPROTO_JOIN_PART: [id, count, skip]. */
+static int
+xrow_decode_join_part(const char **data, struct join_part *part)
+{
+	const char *d = *data;
+	if (mp_typeof(*d) != MP_ARRAY || mp_decode_array(&d) != 3)
+		goto error;
+	for (int i = 0; i < 3; i++) {
+		if (mp_typeof(*d) != MP_UINT)
+			goto error;
+		uint64_t value = mp_decode_uint(&d);
+		switch (i) {
+		case 0:
+			part->id = value;
+			break;
+		case 1:
+			part->count = value;
+			break;
+		default:
+			part->skip = value;
+		}
+	}
+	if (part->count == 0 || part->id >= part->count)
+		goto error;
+	*data = d;
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_MSGPACK, "invalid JOIN_PART");
+	return -1;
+}
+
 int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
-		      struct tt_uuid *instance_uuid, struct vclock *vclock)
+		      struct tt_uuid *instance_uuid, struct vclock *vclock,
+		      bool *compress, struct join_part *part)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -899,6 +935,22 @@ xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 			lsnmap = d;
 			mp_next(&d);
 			break;
+		case IPROTO_COMPRESSION:
+			if (compress == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_BOOL) {
+				diag_set(ClientError, ER_INVALID_MSGPACK,
+					 "invalid COMPRESSION");
+				return -1;
+			}
+			*compress = mp_decode_bool(&d);
+			break;
+		case IPROTO_JOIN_PART:
+			if (part == NULL)
+				goto skip;
+			if (xrow_decode_join_part(&d, part) != 0)
+				return -1;
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -926,22 +978,60 @@ xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
 	return 0;
 }
 
+/** Max size of encoded IPROTO_JOIN_PART, including the key. */
+enum {
+	XROW_JOIN_PART_LEN_MAX = 1 + 1 + 2 * 5 + 9,
+};
+
+/** Encode IPROTO_JOIN_PART: [id, count, skip]. */
+static char *
+xrow_encode_join_part(char *data, const struct join_part *part)
+{
+	data = mp_encode_uint(data, IPROTO_JOIN_PART);
+	data = mp_encode_array(data, 3);
+	data = mp_encode_uint(data, part->id);
+	data = mp_encode_uint(data, part->count);
+	data = mp_encode_uint(data, part->skip);
+	return data;
+}
+
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 const struct vclock *vclock, const struct join_part *part,
+		 bool compress)
 {
 	memset(row, 0, sizeof(*row));
 
-	size_t size = 64;
+	uint32_t replicaset_size = vclock != NULL ? vclock_size(vclock) : 0;
+	size_t size = XROW_BODY_LEN_MAX + replicaset_size *
+		(mp_sizeof_uint(UINT32_MAX) + mp_sizeof_uint(UINT64_MAX));
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 1);
+	data = mp_encode_map(data, 1 + (vclock != NULL) + (part != NULL) +
+			     compress);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
 	/* Greet the remote replica with our replica UUID */
 	data = xrow_encode_uuid(data, instance_uuid);
+	if (vclock != NULL) {
+		data = mp_encode_uint(data, IPROTO_VCLOCK);
+		data = mp_encode_map(data, replicaset_size);
+		struct vclock_iterator it;
+		vclock_iterator_init(&it, vclock);
+		vclock_foreach(&it, replica) {
+			data = mp_encode_uint(data, replica.id);
+			data = mp_encode_uint(data, replica.lsn);
+		}
+	}
+	if (part != NULL)
+		data = xrow_encode_join_part(data, part);
+	if (compress) {
+		data = mp_encode_uint(data, IPROTO_COMPRESSION);
+		data = mp_encode_bool(data, true);
+	}
 	assert(data <= buf + size);
 
 	row->body[0].iov_base = buf;
@@ -952,7 +1042,8 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 }
 
 int
-xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
+xrow_encode_join_response(struct xrow_header *row, const struct vclock *vclock,
+			  const struct join_part *part)
 {
 	memset(row, 0, sizeof(*row));
 
@@ -960,13 +1051,15 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 	uint32_t replicaset_size = vclock_size(vclock);
 	size_t size = 8 + replicaset_size *
 		(mp_sizeof_uint(UINT32_MAX) + mp_sizeof_uint(UINT64_MAX));
+	if (part != NULL)
+		size += XROW_JOIN_PART_LEN_MAX;
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 1);
+	data = mp_encode_map(data, part != NULL ? 2 : 1);
 	data = mp_encode_uint(data, IPROTO_VCLOCK);
 	data = mp_encode_map(data, replicaset_size);
 	struct vclock_iterator it;
@@ -975,6 +1068,8 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 		data = mp_encode_uint(data, replica.id);
 		data = mp_encode_uint(data, replica.lsn);
 	}
+	if (part != NULL)
+		data = xrow_encode_join_part(data, part);
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -983,6 +1078,12 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 	return 0;
 }
 
+int
+xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
+{
+	return xrow_encode_join_response(row, vclock, NULL);
+}
+
 void
 greeting_encode(char *greetingbuf, uint32_t version_id,
 		const struct tt_uuid *uuid, const char *salt, uint32_t salt_len)
@@ -241,12 +241,32 @@ xrow_encode_auth(struct xrow_header *row, const char *salt, size_t salt_len,
 		 size_t password_len);
 
 struct vclock;
+
+/**
+ * Part of the initial data requested by JOIN. The initial data
+ * may be split into several parts received over separate
+ * connections. Rows of system spaces always belong to part 0,
+ * rows of other spaces are divided by space id.
+ */
+struct join_part {
+	/** Ordinal number of the part, less than @count. */
+	uint32_t id;
+	/** Number of parts the initial data is split into. */
+	uint32_t count;
+	/**
+	 * Number of rows of the part the replica has already
+	 * received, they are not sent again.
+	 */
+	uint64_t skip;
+};
+
 /**
  * Encode SUBSCRIBE command.
  * @param[out] Row.
  * @param replicaset_uuid Replica set uuid.
  * @param instance_uuid Instance uuid.
  * @param vclock Replication clock.
+ * @param compress Ask the master to compress the stream.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -255,7 +275,7 @@ int
 xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
-		      const struct vclock *vclock);
+		      const struct vclock *vclock, bool compress);
 
 /**
  * Decode SUBSCRIBE command.
@@ -263,24 +283,47 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] replicaset_uuid.
  * @param[out] instance_uuid.
  * @param[out] vclock.
+ * @param[out] compress Set if the replica asks to compress
+ *             the stream.
+ * @param[out] part Part of the initial data, left intact
+ *             if the row doesn't have it.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
  */
 int
 xrow_decode_subscribe(struct xrow_header *row, struct tt_uuid *replicaset_uuid,
-		      struct tt_uuid *instance_uuid, struct vclock *vclock);
+		      struct tt_uuid *instance_uuid, struct vclock *vclock,
+		      bool *compress, struct join_part *part);
 
 /**
  * Encode JOIN command.
  * @param[out] row Row to encode into.
  * @param instance_uuid.
+ * @param vclock Vclock of the checkpoint to send or NULL.
+ * @param part Part of the initial data to send or NULL.
+ * @param compress Ask the master to compress the stream.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 const struct vclock *vclock, const struct join_part *part,
+		 bool compress);
+
+/**
+ * Encode a response to JOIN command.
+ * @param row[out] Row to encode into.
+ * @param vclock.
+ * @param part Part of the initial data being sent or NULL.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
  */
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid);
+xrow_encode_join_response(struct xrow_header *row, const struct vclock *vclock,
+			  const struct join_part *part);
 
 /**
  * Encode end of stream command (a response to JOIN command).
@@ -557,10 +600,10 @@ static inline void
 xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
-			 const struct vclock *vclock)
+			 const struct vclock *vclock, bool compress)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock) != 0)
+				  vclock, compress) != 0)
 		diag_raise();
 }
 
@@ -568,19 +611,22 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 static inline void
 xrow_decode_subscribe_xc(struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
-		         struct tt_uuid *instance_uuid, struct vclock *vclock)
+		         struct tt_uuid *instance_uuid, struct vclock *vclock,
+			 bool *compress, struct join_part *part)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock) != 0)
+				  vclock, compress, part) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_encode_join. */
 static inline void
 xrow_encode_join_xc(struct xrow_header *row,
-		    const struct tt_uuid *instance_uuid)
+		    const struct tt_uuid *instance_uuid,
+		    const struct vclock *vclock, const struct join_part *part,
+		    bool compress)
 {
-	if (xrow_encode_join(row, instance_uuid) != 0)
+	if (xrow_encode_join(row, instance_uuid, vclock, part, compress) != 0)
 		diag_raise();
 }
 
@@ -588,11 +634,39 @@ xrow_encode_join_xc(struct xrow_header *row,
  * \brief Decode JOIN command
  * \param row
  * \param[out] instance_uuid
+ * \param[out] vclock
+ * \param[out] compress
+ * \param[out] part
+*/
+static inline void
+xrow_decode_join(struct xrow_header *row, struct tt_uuid *instance_uuid,
+		 struct vclock *vclock, bool *compress, struct join_part *part)
+{
+	xrow_decode_subscribe_xc(row, NULL, instance_uuid, vclock, compress,
+				 part);
+}
+
+/** @copydoc xrow_encode_join_response. */
+static inline void
+xrow_encode_join_response_xc(struct xrow_header *row,
+			     const struct vclock *vclock,
+			     const struct join_part *part)
+{
+	if (xrow_encode_join_response(row, vclock, part) != 0)
+		diag_raise();
+}
+
+/**
+ * \brief Decode a response to JOIN command
+ * \param row
+ * \param[out] vclock
+ * \param[out] part
 */
 static inline void
-xrow_decode_join(struct xrow_header *row, struct tt_uuid *instance_uuid)
+xrow_decode_join_response(struct xrow_header *row, struct vclock *vclock,
+			  struct join_part *part)
 {
-	xrow_decode_subscribe_xc(row, NULL, instance_uuid, NULL);
+	xrow_decode_subscribe_xc(row, NULL, NULL, vclock, NULL, part);
 }
 
 /** @copydoc xrow_encode_vclock. */
@@ -611,7 +685,7 @@ xrow_encode_vclock_xc(struct xrow_header *row, const struct vclock *vclock)
 static inline void
 xrow_decode_vclock(struct xrow_header *row, struct vclock *vclock)
 {
-	xrow_decode_subscribe_xc(row, NULL, NULL, vclock);
+	xrow_decode_subscribe_xc(row, NULL, NULL, vclock, NULL, NULL);
 }
 
 /** @copydoc iproto_reply_ok. */
@@ -42,3 +42,16 @@ xstream_write(struct xstream *stream, struct xrow_header *row)
 	}
 	return 0;
 }
+
+int
+xstream_flush(struct xstream *stream)
+{
+	if (stream->flush == NULL)
+		return 0;
+	try {
+		stream->flush(stream);
+	} catch (Exception *e) {
+		return -1;
+	}
+	return 0;
+}
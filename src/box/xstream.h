@@ -32,6 +32,8 @@
  * SUCH DAMAGE.
  */
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "diag.h"
 
 #if defined(__cplusplus)
@@ -42,20 +44,47 @@ struct xrow_header;
 struct xstream;
 
 typedef void (*xstream_write_f)(struct xstream *, struct xrow_header *);
+typedef void (*xstream_flush_f)(struct xstream *);
+typedef bool (*xstream_accepts_space_f)(struct xstream *, uint32_t space_id);
 
 struct xstream {
 	xstream_write_f write;
+	/**
+	 * Optional callback invoked when the producer runs out
+	 * of rows for a while, e.g. when recovery has read all
+	 * available WALs. A stream that buffers rows must not
+	 * hold them past this point.
+	 */
+	xstream_flush_f flush;
+	/**
+	 * Optional callback returning false if the stream
+	 * drops rows of the given space. A producer may use
+	 * it to skip such rows without reading them.
+	 */
+	xstream_accepts_space_f accepts_space;
 };
 
 static inline void
 xstream_create(struct xstream *xstream, xstream_write_f write)
 {
 	xstream->write = write;
+	xstream->flush = NULL;
+	xstream->accepts_space = NULL;
+}
+
+static inline bool
+xstream_accepts_space(struct xstream *stream, uint32_t space_id)
+{
+	return stream->accepts_space == NULL ||
+	       stream->accepts_space(stream, space_id);
 }
 
 int
 xstream_write(struct xstream *stream, struct xrow_header *row);
 
+int
+xstream_flush(struct xstream *stream);
+
 #if defined(__cplusplus)
 } /* extern C */
 
@@ -66,6 +95,13 @@ xstream_write_xc(struct xstream *stream, struct xrow_header *row)
 		diag_raise();
 }
 
+static inline void
+xstream_flush_xc(struct xstream *stream)
+{
+	if (xstream_flush(stream) != 0)
+		diag_raise();
+}
+
 #endif /* defined(__cplusplus) */
 
 #endif /* TARANTOOL_XSTREAM_H_INCLUDED */
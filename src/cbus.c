@@ -31,6 +31,7 @@
 #include "cbus.h"
 
 #include <limits.h>
+#include <pmatomic.h>
 #include "fiber.h"
 
 /**
@@ -45,6 +46,8 @@ struct cbus {
 	pthread_cond_t cond;
 	/** Connected endpoints */
 	struct rlist endpoints;
+	/** All pipes, protected by the mutex. */
+	struct rlist pipes;
 };
 
 /** A singleton for all cords. */
@@ -84,7 +87,12 @@ cpipe_create(struct cpipe *pipe, const char *consumer)
 
 	pipe->n_input = 0;
 	pipe->max_input = INT_MAX;
+	pipe->max_input_min = INT_MAX;
+	pipe->max_input_max = 0;
 	pipe->producer = cord()->loop;
+	snprintf(pipe->name, sizeof(pipe->name), "%s->%s",
+		 cord_name(cord()), consumer);
+	memset(&pipe->stat, 0, sizeof(pipe->stat));
 
 	ev_async_init(&pipe->flush_input, cpipe_flush_cb);
 	pipe->flush_input.data = pipe;
@@ -97,6 +105,7 @@ cpipe_create(struct cpipe *pipe, const char *consumer)
 	}
 	pipe->endpoint = endpoint;
 	++pipe->endpoint->n_pipes;
+	rlist_add_tail(&cbus.pipes, &pipe->in_cbus);
 	tt_pthread_mutex_unlock(&cbus.mutex);
 }
 
@@ -119,6 +128,10 @@ cpipe_destroy(struct cpipe *pipe)
 {
 	ev_async_stop(pipe->producer, &pipe->flush_input);
 
+	tt_pthread_mutex_lock(&cbus.mutex);
+	rlist_del(&pipe->in_cbus);
+	tt_pthread_mutex_unlock(&cbus.mutex);
+
 	static const struct cmsg_hop route[1] = {
 		{cbus_endpoint_poison_f, NULL}
 	};
@@ -164,6 +177,7 @@ cbus_create(struct cbus *bus)
 	(void) tt_pthread_cond_init(&bus->cond, NULL);
 
 	rlist_create(&bus->endpoints);
+	rlist_create(&bus->pipes);
 }
 
 static void
@@ -247,6 +261,23 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	return 0;
 }
 
+/**
+ * Adjust the staged push cap of a pipe with adaptive input
+ * after a flush, see cpipe_set_adaptive_max_input().
+ */
+static inline void
+cpipe_adapt_max_input(struct cpipe *pipe, bool consumer_is_idle)
+{
+	if (consumer_is_idle) {
+		if (pipe->max_input > pipe->max_input_min)
+			pipe->max_input = MAX(pipe->max_input / 2,
+					      pipe->max_input_min);
+	} else if (pipe->n_input >= pipe->max_input) {
+		pipe->max_input = MIN(pipe->max_input * 2,
+				      pipe->max_input_max);
+	}
+}
+
 static void
 cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 {
@@ -266,15 +297,74 @@ cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 	stailq_concat(&endpoint->output, &pipe->input);
 	tt_pthread_mutex_unlock(&endpoint->mutex);
 
+	/*
+	 * The statistics is read from other threads without
+	 * synchronization with the producer, so update it with
+	 * atomics. The producer is the only writer, so relaxed
+	 * ordering is enough.
+	 */
+	pm_atomic_fetch_add_explicit(&pipe->stat.messages, pipe->n_input,
+				     pm_memory_order_relaxed);
+	pm_atomic_fetch_add_explicit(&pipe->stat.batches, 1,
+				     pm_memory_order_relaxed);
+	if (pipe->max_input_max != 0)
+		cpipe_adapt_max_input(pipe, output_was_empty);
 	pipe->n_input = 0;
 	if (output_was_empty) {
 		/* Count statistics */
 		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
+		pm_atomic_fetch_add_explicit(&pipe->stat.wakeups, 1,
+					     pm_memory_order_relaxed);
 
 		ev_async_send(endpoint->consumer, &endpoint->async);
 	}
 }
 
+int
+cpipe_stat_foreach(cpipe_stat_cb cb, void *cb_ctx)
+{
+	/*
+	 * Don't invoke the callback under the bus mutex,
+	 * take a snapshot of the statistics instead.
+	 */
+	struct cpipe_stat_entry {
+		char name[2 * FIBER_NAME_MAX];
+		struct cpipe_stat stat;
+	} *entries;
+	int count = 0;
+
+	tt_pthread_mutex_lock(&cbus.mutex);
+	struct cpipe *pipe;
+	rlist_foreach_entry(pipe, &cbus.pipes, in_cbus)
+		count++;
+	entries = malloc(count * sizeof(*entries) + 1);
+	if (entries == NULL) {
+		tt_pthread_mutex_unlock(&cbus.mutex);
+		diag_set(OutOfMemory, count * sizeof(*entries),
+			 "malloc", "pipe statistics");
+		return -1;
+	}
+	int i = 0;
+	rlist_foreach_entry(pipe, &cbus.pipes, in_cbus) {
+		memcpy(entries[i].name, pipe->name, sizeof(pipe->name));
+		struct cpipe_stat *stat = &entries[i].stat;
+		stat->messages = pm_atomic_load_explicit(&pipe->stat.messages,
+						pm_memory_order_relaxed);
+		stat->batches = pm_atomic_load_explicit(&pipe->stat.batches,
+						pm_memory_order_relaxed);
+		stat->wakeups = pm_atomic_load_explicit(&pipe->stat.wakeups,
+						pm_memory_order_relaxed);
+		i++;
+	}
+	tt_pthread_mutex_unlock(&cbus.mutex);
+
+	int rc = 0;
+	for (i = 0; i < count && rc == 0; i++)
+		rc = cb(entries[i].name, &entries[i].stat, cb_ctx);
+	free(entries);
+	return rc;
+}
+
 void
 cbus_init()
 {
@@ -109,6 +109,16 @@ cmsg_init(struct cmsg *msg, const struct cmsg_hop *route)
 void
 cmsg_deliver(struct cmsg *msg);
 
+/** Statistics of a pipe. */
+struct cpipe_stat {
+	/** Messages flushed to the consumer. */
+	int64_t messages;
+	/** Flushes, each delivering a batch of messages. */
+	int64_t batches;
+	/** Wake ups of the consumer. */
+	int64_t wakeups;
+};
+
 /** A  uni-directional FIFO queue from one cord to another. */
 struct cpipe {
 	/** Staging area for pushed messages */
@@ -121,6 +131,14 @@ struct cpipe {
 	 * latency, while still keeping the bus mutex cold enough).
 	 */
 	int max_input;
+	/**
+	 * If non-zero, max_input adapts to the load: it may grow
+	 * up to this value while the consumer lags behind, and
+	 * shrinks back to max_input_min when it catches up.
+	 */
+	int max_input_max;
+	/** max_input set with cpipe_set_max_input(). */
+	int max_input_min;
 	/**
 	 * Rather than flushing input into the pipe
 	 * whenever a single message or a batch is
@@ -135,6 +153,15 @@ struct cpipe {
 	 * flushed messages.
 	 */
 	struct cbus_endpoint *endpoint;
+	/** Pipe name, "producer->consumer". */
+	char name[2 * FIBER_NAME_MAX];
+	/** Member of the list of all pipes. */
+	struct rlist in_cbus;
+	/**
+	 * Pipe statistics, updated by the producer and read
+	 * by cpipe_stat_foreach() with atomics.
+	 */
+	struct cpipe_stat stat;
 };
 
 /**
@@ -169,8 +196,38 @@ static inline void
 cpipe_set_max_input(struct cpipe *pipe, int max_input)
 {
 	pipe->max_input = max_input;
+	pipe->max_input_min = max_input;
+}
+
+/**
+ * Make the staged push cap of the pipe adapt to the load.
+ * Every time the cap is reached while the consumer still has
+ * messages from the previous flushes to process, the cap is
+ * doubled, up to max_input_max: a bigger batch adds no latency
+ * in this case, but takes the bus mutex less often. Every time
+ * a flush finds the consumer idle, the cap is halved, down to
+ * the value set with cpipe_set_max_input(), to keep latency low
+ * under light load.
+ */
+static inline void
+cpipe_set_adaptive_max_input(struct cpipe *pipe, int max_input_max)
+{
+	assert(max_input_max >= pipe->max_input_min);
+	pipe->max_input_max = max_input_max;
 }
 
+/** Callback for cpipe_stat_foreach(). */
+typedef int (*cpipe_stat_cb)(const char *name, const struct cpipe_stat *stat,
+			     void *cb_ctx);
+
+/**
+ * Invoke the callback for statistics of each pipe. Pipes with
+ * the same name are reported separately. Stops and returns
+ * the callback return value if it's not 0.
+ */
+int
+cpipe_stat_foreach(cpipe_stat_cb cb, void *cb_ctx);
+
 /**
  * Flush all staged messages into the pipe and eventually to the
  * consumer.
@@ -0,0 +1,528 @@
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "coio_aio.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "trivia/config.h"
+#include "trivia/util.h"
+#include "diag.h"
+#include "fiber.h"
+#include "say.h"
+
+#if defined(HAVE_SYS_EVENTFD_H)
+#include <sys/eventfd.h>
+#if defined(HAVE_LINUX_IO_URING_H) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define COIO_AIO_HAVE_URING 1
+#endif
+#if defined(HAVE_LINUX_AIO_ABI_H) && defined(__NR_io_setup)
+#include <linux/aio_abi.h>
+#define COIO_AIO_HAVE_LINUX 1
+#endif
+#endif /* defined(HAVE_SYS_EVENTFD_H) */
+
+const char *coio_aio_backend_strs[] = {
+	/* [COIO_AIO_NONE]  = */ "none",
+	/* [COIO_AIO_URING] = */ "io_uring",
+	/* [COIO_AIO_LINUX] = */ "aio",
+};
+
+/** Reads submitted by a fiber with one coio_aio_read() call. */
+struct coio_aio_batch {
+	/** Fiber waiting for the reads to complete. */
+	struct fiber *fiber;
+	/** Number of submitted reads that haven't completed yet. */
+	int pending;
+};
+
+/** Account completion of a read. */
+static void
+coio_aio_complete(struct coio_aio *aio, struct coio_aio_req *req,
+		  ssize_t result)
+{
+	assert(aio->inflight > 0);
+	aio->inflight--;
+	req->result = result;
+	struct coio_aio_batch *batch = req->batch;
+	assert(batch->pending > 0);
+	if (--batch->pending == 0)
+		fiber_wakeup(batch->fiber);
+}
+
+/** {{{ io_uring */
+
+#if defined(COIO_AIO_HAVE_URING)
+
+/** Submission and completion rings shared with the kernel. */
+struct coio_uring {
+	/** io_uring file descriptor. */
+	int fd;
+	/** Submission ring. */
+	void *sq_ptr;
+	size_t sq_size;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	/** Submission queue entries. */
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+	/** Completion ring. */
+	void *cq_ptr;
+	size_t cq_size;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_cqe *cqes;
+};
+
+static void
+coio_uring_delete(struct coio_uring *ring)
+{
+	if (ring->sqes != NULL)
+		munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq_ptr != NULL)
+		munmap(ring->cq_ptr, ring->cq_size);
+	if (ring->sq_ptr != NULL)
+		munmap(ring->sq_ptr, ring->sq_size);
+	if (ring->fd >= 0)
+		close(ring->fd);
+	free(ring);
+}
+
+static void *
+coio_uring_mmap(int fd, size_t size, off_t offset)
+{
+	void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_POPULATE, fd, offset);
+	return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+static struct coio_uring *
+coio_uring_new(unsigned depth, int efd)
+{
+	struct coio_uring *ring = calloc(1, sizeof(*ring));
+	if (ring == NULL) {
+		diag_set(OutOfMemory, sizeof(*ring), "malloc",
+			 "struct coio_uring");
+		return NULL;
+	}
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+	ring->fd = syscall(__NR_io_uring_setup, depth, &p);
+	if (ring->fd < 0) {
+		diag_set(SystemError, "io_uring_setup");
+		goto fail;
+	}
+	/*
+	 * Map the rings separately even if the kernel supports
+	 * IORING_FEAT_SINGLE_MMAP: it works on all kernels.
+	 */
+	ring->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	ring->sq_ptr = coio_uring_mmap(ring->fd, ring->sq_size,
+				       IORING_OFF_SQ_RING);
+	ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = coio_uring_mmap(ring->fd, ring->sqes_size,
+				     IORING_OFF_SQES);
+	ring->cq_size = p.cq_off.cqes +
+			p.cq_entries * sizeof(struct io_uring_cqe);
+	ring->cq_ptr = coio_uring_mmap(ring->fd, ring->cq_size,
+				       IORING_OFF_CQ_RING);
+	if (ring->sq_ptr == NULL || ring->sqes == NULL ||
+	    ring->cq_ptr == NULL) {
+		diag_set(SystemError, "failed to map io_uring");
+		goto fail;
+	}
+	char *sq = ring->sq_ptr;
+	ring->sq_head = (unsigned *)(sq + p.sq_off.head);
+	ring->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+	ring->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)(sq + p.sq_off.array);
+	char *cq = ring->cq_ptr;
+	ring->cq_head = (unsigned *)(cq + p.cq_off.head);
+	ring->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+	ring->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+	if (syscall(__NR_io_uring_register, ring->fd,
+		    IORING_REGISTER_EVENTFD, &efd, 1) != 0) {
+		diag_set(SystemError, "failed to register io_uring eventfd");
+		goto fail;
+	}
+	return ring;
+fail:
+	coio_uring_delete(ring);
+	return NULL;
+}
+
+/**
+ * Queue @count reads and pass them to the kernel with a single
+ * io_uring_enter() call. Return the number of reads the kernel
+ * has accepted or -1 if it hasn't accepted any.
+ */
+static int
+coio_uring_submit(struct coio_uring *ring, struct coio_aio_req *reqs,
+		  int count)
+{
+	unsigned mask = *ring->sq_mask;
+	unsigned tail = *ring->sq_tail;
+	for (int i = 0; i < count; i++) {
+		struct coio_aio_req *req = &reqs[i];
+		unsigned idx = (tail + i) & mask;
+		struct io_uring_sqe *sqe = &ring->sqes[idx];
+		req->iov.iov_base = req->buf;
+		req->iov.iov_len = req->size;
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = IORING_OP_READV;
+		sqe->fd = req->fd;
+		sqe->off = req->offset;
+		sqe->addr = (uintptr_t)&req->iov;
+		sqe->len = 1;
+		sqe->user_data = (uintptr_t)req;
+		ring->sq_array[idx] = idx;
+	}
+	/* Make the entries visible before the tail update. */
+	__atomic_store_n(ring->sq_tail, tail + count, __ATOMIC_RELEASE);
+	int rc;
+	do {
+		rc = syscall(__NR_io_uring_enter, ring->fd, count, 0, 0,
+			     NULL, 0);
+	} while (rc < 0 && errno == EINTR);
+	if (rc < count) {
+		/*
+		 * The kernel reads the submission ring only in
+		 * io_uring_enter(), so we may safely take back
+		 * the entries it hasn't consumed.
+		 */
+		int consumed = rc < 0 ? 0 : rc;
+		__atomic_store_n(ring->sq_tail, tail + consumed,
+				 __ATOMIC_RELEASE);
+		if (rc < 0) {
+			diag_set(SystemError, "io_uring_enter");
+			return -1;
+		}
+	}
+	return rc;
+}
+
+static void
+coio_uring_reap(struct coio_aio *aio, struct coio_uring *ring)
+{
+	unsigned mask = *ring->cq_mask;
+	unsigned head = *ring->cq_head;
+	unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+	for (; head != tail; head++) {
+		struct io_uring_cqe *cqe = &ring->cqes[head & mask];
+		struct coio_aio_req *req =
+			(struct coio_aio_req *)(uintptr_t)cqe->user_data;
+		coio_aio_complete(aio, req, cqe->res);
+	}
+	__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+}
+
+#endif /* defined(COIO_AIO_HAVE_URING) */
+
+/** }}} io_uring */
+
+/** {{{ Linux native AIO */
+
+#if defined(COIO_AIO_HAVE_LINUX)
+
+/**
+ * Max number of reads passed to the kernel with one io_submit()
+ * call and max number of events reaped with one io_getevents().
+ */
+enum { COIO_LINUX_AIO_EVENTS = 64 };
+
+static aio_context_t *
+coio_linux_aio_new(unsigned depth)
+{
+	aio_context_t *ctx = calloc(1, sizeof(*ctx));
+	if (ctx == NULL) {
+		diag_set(OutOfMemory, sizeof(*ctx), "malloc",
+			 "aio_context_t");
+		return NULL;
+	}
+	if (syscall(__NR_io_setup, depth, ctx) != 0) {
+		diag_set(SystemError, "io_setup");
+		free(ctx);
+		return NULL;
+	}
+	return ctx;
+}
+
+static void
+coio_linux_aio_delete(aio_context_t *ctx)
+{
+	syscall(__NR_io_destroy, *ctx);
+	free(ctx);
+}
+
+/**
+ * Pass @count reads to the kernel with io_submit(). Return the
+ * number of reads the kernel has accepted or -1 if it hasn't
+ * accepted any.
+ */
+static int
+coio_linux_aio_submit(aio_context_t *ctx, int efd,
+		      struct coio_aio_req *reqs, int count)
+{
+	/*
+	 * The kernel copies control blocks on submission so
+	 * we can reuse a small buffer on the fiber stack.
+	 */
+	struct iocb cbs[COIO_LINUX_AIO_EVENTS];
+	struct iocb *cbp[COIO_LINUX_AIO_EVENTS];
+	int submitted = 0;
+	while (submitted < count) {
+		int n = MIN(count - submitted, COIO_LINUX_AIO_EVENTS);
+		for (int i = 0; i < n; i++) {
+			struct coio_aio_req *req = &reqs[submitted + i];
+			struct iocb *cb = &cbs[i];
+			memset(cb, 0, sizeof(*cb));
+			cb->aio_data = (uintptr_t)req;
+			cb->aio_lio_opcode = IOCB_CMD_PREAD;
+			cb->aio_fildes = req->fd;
+			cb->aio_buf = (uintptr_t)req->buf;
+			cb->aio_nbytes = req->size;
+			cb->aio_offset = req->offset;
+			cb->aio_flags = IOCB_FLAG_RESFD;
+			cb->aio_resfd = efd;
+			cbp[i] = cb;
+		}
+		int rc;
+		do {
+			rc = syscall(__NR_io_submit, *ctx, n, cbp);
+		} while (rc < 0 && errno == EINTR);
+		if (rc < 0) {
+			if (submitted > 0)
+				break;
+			diag_set(SystemError, "io_submit");
+			return -1;
+		}
+		submitted += rc;
+		if (rc < n)
+			break;
+	}
+	return submitted;
+}
+
+static void
+coio_linux_aio_reap(struct coio_aio *aio, aio_context_t *ctx)
+{
+	struct io_event events[COIO_LINUX_AIO_EVENTS];
+	struct timespec timeout = {0, 0};
+	int rc;
+	do {
+		rc = syscall(__NR_io_getevents, *ctx, 0,
+			     COIO_LINUX_AIO_EVENTS, events, &timeout);
+		for (int i = 0; i < rc; i++) {
+			struct coio_aio_req *req =
+				(struct coio_aio_req *)(uintptr_t)
+				events[i].data;
+			coio_aio_complete(aio, req, events[i].res);
+		}
+	} while (rc == COIO_LINUX_AIO_EVENTS ||
+		 (rc < 0 && errno == EINTR));
+}
+
+#endif /* defined(COIO_AIO_HAVE_LINUX) */
+
+/** }}} Linux native AIO */
+
+/** Read completion notification callback. */
+static void
+coio_aio_efd_cb(ev_loop *loop, struct ev_io *watcher, int events)
+{
+	(void) loop;
+	(void) events;
+	struct coio_aio *aio = watcher->data;
+	uint64_t count;
+	/* Reset the counter, it is non-blocking. */
+	while (read(aio->efd, &count, sizeof(count)) < 0 && errno == EINTR)
+		;
+	switch (aio->backend) {
+#if defined(COIO_AIO_HAVE_URING)
+	case COIO_AIO_URING:
+		coio_uring_reap(aio, aio->impl);
+		break;
+#endif
+#if defined(COIO_AIO_HAVE_LINUX)
+	case COIO_AIO_LINUX:
+		coio_linux_aio_reap(aio, aio->impl);
+		break;
+#endif
+	default:
+		unreachable();
+	}
+	fiber_cond_broadcast(&aio->slot_cond);
+}
+
+int
+coio_aio_create(struct coio_aio *aio, unsigned depth)
+{
+	assert(depth > 0);
+	memset(aio, 0, sizeof(*aio));
+	aio->backend = COIO_AIO_NONE;
+	aio->depth = depth;
+	aio->efd = -1;
+#if defined(COIO_AIO_HAVE_URING) || defined(COIO_AIO_HAVE_LINUX)
+	aio->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (aio->efd < 0) {
+		diag_set(SystemError, "eventfd");
+		return -1;
+	}
+#if defined(COIO_AIO_HAVE_URING)
+	if (aio->impl == NULL) {
+		aio->impl = coio_uring_new(depth, aio->efd);
+		if (aio->impl != NULL)
+			aio->backend = COIO_AIO_URING;
+		else
+			say_info("io_uring is not available: %s",
+				 diag_last_error(diag_get())->errmsg);
+	}
+#endif
+#if defined(COIO_AIO_HAVE_LINUX)
+	if (aio->impl == NULL) {
+		aio->impl = coio_linux_aio_new(depth);
+		if (aio->impl != NULL)
+			aio->backend = COIO_AIO_LINUX;
+	}
+#endif
+	if (aio->impl == NULL) {
+		close(aio->efd);
+		return -1;
+	}
+	fiber_cond_create(&aio->slot_cond);
+	ev_io_init(&aio->efd_ev, coio_aio_efd_cb, aio->efd, EV_READ);
+	aio->efd_ev.data = aio;
+	ev_io_start(loop(), &aio->efd_ev);
+	return 0;
+#else
+	errno = ENOSYS;
+	diag_set(SystemError, "asynchronous I/O is not supported");
+	return -1;
+#endif
+}
+
+void
+coio_aio_destroy(struct coio_aio *aio)
+{
+	assert(aio->inflight == 0);
+	switch (aio->backend) {
+#if defined(COIO_AIO_HAVE_URING)
+	case COIO_AIO_URING:
+		coio_uring_delete(aio->impl);
+		break;
+#endif
+#if defined(COIO_AIO_HAVE_LINUX)
+	case COIO_AIO_LINUX:
+		coio_linux_aio_delete(aio->impl);
+		break;
+#endif
+	default:
+		unreachable();
+	}
+	ev_io_stop(loop(), &aio->efd_ev);
+	close(aio->efd);
+	fiber_cond_destroy(&aio->slot_cond);
+	TRASH(aio);
+}
+
+/**
+ * Pass reads to the kernel. Return the number of reads the
+ * kernel has accepted or -1 if it hasn't accepted any.
+ */
+static int
+coio_aio_submit(struct coio_aio *aio, struct coio_aio_req *reqs, int count)
+{
+	aio->submit_count++;
+	switch (aio->backend) {
+#if defined(COIO_AIO_HAVE_URING)
+	case COIO_AIO_URING:
+		return coio_uring_submit(aio->impl, reqs, count);
+#endif
+#if defined(COIO_AIO_HAVE_LINUX)
+	case COIO_AIO_LINUX:
+		return coio_linux_aio_submit(aio->impl, aio->efd,
+					     reqs, count);
+#endif
+	default:
+		unreachable();
+	}
+	return -1;
+}
+
+int
+coio_aio_read(struct coio_aio *aio, struct coio_aio_req *reqs, int count)
+{
+	struct coio_aio_batch batch;
+	batch.fiber = fiber();
+	batch.pending = 0;
+	int rc = 0;
+	int submitted = 0;
+	while (submitted < count) {
+		/* Wait for free slots in the queue. */
+		while (aio->inflight >= aio->depth)
+			fiber_cond_wait(&aio->slot_cond);
+		int n = MIN((int)(aio->depth - aio->inflight),
+			    count - submitted);
+		struct coio_aio_req *chunk = reqs + submitted;
+		for (int i = 0; i < n; i++)
+			chunk[i].batch = &batch;
+		int accepted = coio_aio_submit(aio, chunk, n);
+		if (accepted > 0) {
+			aio->inflight += accepted;
+			aio->read_count += accepted;
+			batch.pending += accepted;
+			submitted += accepted;
+		}
+		if (accepted < n) {
+			if (accepted >= 0) {
+				/* Queue is full, try again later. */
+				errno = EAGAIN;
+				diag_set(SystemError, "failed to submit read");
+			}
+			rc = -1;
+			break;
+		}
+	}
+	/* Reads in flight may write to the buffers, wait for them. */
+	while (batch.pending > 0)
+		fiber_yield();
+	return rc;
+}
@@ -0,0 +1,165 @@
+#ifndef INCLUDES_TARANTOOL_COIO_AIO_H
+#define INCLUDES_TARANTOOL_COIO_AIO_H
+/*
+ * Copyright 2010-2017, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <tarantool_ev.h>
+#include "fiber_cond.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Asynchronous file reads for the event loop of the calling
+ * thread.
+ *
+ * Unlike coio_pread(), which hands a blocking read over to
+ * a worker thread, a read submitted here goes straight to the
+ * kernel, which notifies the event loop via an eventfd when it
+ * is complete. A single submission may carry many reads, and
+ * up to @depth reads may be in flight at the same time.
+ *
+ * io_uring is used if the kernel supports it, Linux native AIO
+ * otherwise. Note, native AIO is truly asynchronous only for
+ * file descriptors opened with O_DIRECT, so a caller using it
+ * must align buffers, offsets and sizes to the logical block
+ * size of the device, see coio_aio_needs_direct_io().
+ *
+ * Like the rest of cooperative file I/O, reads don't support
+ * timeouts or cancellation: a buffer must not be freed while
+ * the kernel may be writing to it.
+ */
+
+enum coio_aio_backend {
+	/** Asynchronous I/O is not available. */
+	COIO_AIO_NONE = 0,
+	/** io_uring, Linux 5.1+. */
+	COIO_AIO_URING,
+	/** Linux native AIO (io_submit). */
+	COIO_AIO_LINUX,
+	coio_aio_backend_MAX,
+};
+
+extern const char *coio_aio_backend_strs[];
+
+struct coio_aio_batch;
+
+/** A single read request. */
+struct coio_aio_req {
+	/** File descriptor to read from. */
+	int fd;
+	/** Buffer to read to. */
+	void *buf;
+	/** Number of bytes to read. */
+	size_t size;
+	/** Offset in the file to read from. */
+	off_t offset;
+	/** [out] Number of bytes read or -errno on failure. */
+	ssize_t result;
+	/** Vector of the read, used by io_uring. */
+	struct iovec iov;
+	/** Batch the request was submitted with. */
+	struct coio_aio_batch *batch;
+};
+
+/** Asynchronous I/O context. */
+struct coio_aio {
+	/** Backend in use. */
+	enum coio_aio_backend backend;
+	/** Max number of reads in flight. */
+	unsigned depth;
+	/** Number of reads in flight. */
+	unsigned inflight;
+	/** Eventfd the kernel signals on read completion. */
+	int efd;
+	/** Watcher of @efd in the event loop of the owner thread. */
+	struct ev_io efd_ev;
+	/** Signaled when reads complete and free queue slots. */
+	struct fiber_cond slot_cond;
+	/** Backend specific state. */
+	void *impl;
+	/** Number of reads submitted so far. */
+	int64_t read_count;
+	/** Number of submission system calls made so far. */
+	int64_t submit_count;
+};
+
+/**
+ * Initialize an asynchronous I/O context with at most @depth
+ * reads in flight. Must be called from the thread whose event
+ * loop is to receive completions.
+ *
+ * @retval  0 success
+ * @retval -1 neither io_uring nor native AIO is available,
+ *            diag is set
+ */
+int
+coio_aio_create(struct coio_aio *aio, unsigned depth);
+
+/**
+ * Destroy an asynchronous I/O context.
+ * There must be no reads in flight.
+ */
+void
+coio_aio_destroy(struct coio_aio *aio);
+
+/**
+ * Return true if reads must be issued on file descriptors
+ * opened with O_DIRECT to be asynchronous.
+ */
+static inline bool
+coio_aio_needs_direct_io(const struct coio_aio *aio)
+{
+	return aio->backend == COIO_AIO_LINUX;
+}
+
+/**
+ * Submit @count reads in as few system calls as the queue
+ * depth allows and yield the current fiber until all of them
+ * complete. The outcome of each read is stored in
+ * coio_aio_req::result.
+ *
+ * @retval  0 all reads were submitted and completed
+ * @retval -1 submission failed, diag is set
+ */
+int
+coio_aio_read(struct coio_aio *aio, struct coio_aio_req *reqs, int count);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* INCLUDES_TARANTOOL_COIO_AIO_H */
@@ -123,7 +123,7 @@ histogram_discard(struct histogram *hist, int64_t val)
 }
 
 int64_t
-histogram_percentile(struct histogram *hist, int pct)
+histogram_percentile(struct histogram *hist, double pct)
 {
 	size_t count = 0;
 
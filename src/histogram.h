@@ -81,7 +81,7 @@ histogram_discard(struct histogram *hist, int64_t val);
  * percentage of observations fall.
  */
 int64_t
-histogram_percentile(struct histogram *hist, int pct);
+histogram_percentile(struct histogram *hist, double pct);
 
 /**
  * Print string representation of a histogram.
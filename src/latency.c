@@ -85,7 +85,12 @@ latency_collect(struct latency *latency, double value)
 double
 latency_get(struct latency *latency)
 {
-	int64_t value_usec = histogram_percentile(latency->histogram,
-						  LATENCY_PERCENTILE);
+	return latency_get_percentile(latency, LATENCY_PERCENTILE);
+}
+
+double
+latency_get_percentile(struct latency *latency, double pct)
+{
+	int64_t value_usec = histogram_percentile(latency->histogram, pct);
 	return (double)value_usec / USEC_PER_SEC;
 }
@@ -70,4 +70,11 @@ latency_collect(struct latency *latency, double value);
 double
 latency_get(struct latency *latency);
 
+/**
+ * Get the value below which @pct percent of observations
+ * fall, in seconds.
+ */
+double
+latency_get_percentile(struct latency *latency, double pct);
+
 #endif /* TARANTOOL_LATENCY_H_INCLUDED */
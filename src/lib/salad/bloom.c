@@ -36,6 +36,46 @@
 #include <math.h>
 #include <assert.h>
 #include <string.h>
+#include <stdlib.h>
+
+/**
+ * Tables that take whole memory pages are mmapped and charged
+ * to the quota, smaller ones (see bloom_create_compact()) are
+ * allocated with malloc() to avoid wasting the rest of the page.
+ */
+static inline bool
+bloom_table_is_mmapped(size_t size)
+{
+	return size % sysconf(_SC_PAGE_SIZE) == 0;
+}
+
+static struct bloom_block *
+bloom_table_alloc(size_t size, struct quota *quota)
+{
+	if (!bloom_table_is_mmapped(size))
+		return (struct bloom_block *)calloc(1, size);
+	if (quota_use(quota, size) < 0)
+		return NULL;
+	void *table = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (table == MAP_FAILED) {
+		quota_release(quota, size);
+		return NULL;
+	}
+	return (struct bloom_block *)table;
+}
+
+static void
+bloom_table_free(struct bloom_block *table, size_t size,
+		 struct quota *quota)
+{
+	if (!bloom_table_is_mmapped(size)) {
+		free(table);
+		return;
+	}
+	munmap(table, size);
+	quota_release(quota, size);
+}
 
 int
 bloom_create(struct bloom *bloom, uint32_t number_of_values,
@@ -56,27 +96,35 @@ bloom_create(struct bloom *bloom, uint32_t number_of_values,
 	/* bit array size in bytes */
 	size_t mmap_size = p * page_size;
 	bloom->table_size = p * page_size / sizeof(struct bloom_block);
-	if (quota_use(quota, mmap_size) < 0) {
-		bloom->table = NULL;
-		return -1;
-	}
-	bloom->table = (struct bloom_block *)
-		mmap(NULL, mmap_size, PROT_READ | PROT_WRITE,
-		     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-	if (bloom->table == MAP_FAILED) {
-		bloom->table = NULL;
-		quota_release(quota, mmap_size);
-		return -1;
-	}
-	return 0;
+	bloom->table = bloom_table_alloc(mmap_size, quota);
+	return bloom->table == NULL ? -1 : 0;
+}
+
+int
+bloom_create_compact(struct bloom *bloom, uint32_t number_of_values,
+		     double false_positive_rate, struct quota *quota)
+{
+	bloom->hash_count = (uint32_t)
+		(log(false_positive_rate) / log(0.5) + 0.99);
+	uint64_t m = (uint64_t)
+		(number_of_values * bloom->hash_count / log(2) + 0.5);
+	/* Number of bits in one block */
+	uint64_t b = sizeof(struct bloom_block) * CHAR_BIT;
+	/* number of blocks, round up, at least one */
+	uint64_t p = (m + b - 1) / b;
+	if (p == 0)
+		p = 1;
+	bloom->table_size = p;
+	bloom->table = bloom_table_alloc(p * sizeof(struct bloom_block),
+					 quota);
+	return bloom->table == NULL ? -1 : 0;
 }
 
 void
 bloom_destroy(struct bloom *bloom, struct quota *quota)
 {
 	size_t mmap_size = bloom->table_size * sizeof(struct bloom_block);
-	munmap(bloom->table, mmap_size);
-	quota_release(quota, mmap_size);
+	bloom_table_free(bloom->table, mmap_size, quota);
 }
 
 size_t
@@ -97,18 +145,9 @@ int
 bloom_load_table(struct bloom *bloom, const char *table, struct quota *quota)
 {
 	size_t mmap_size = bloom->table_size * sizeof(struct bloom_block);
-	if (quota_use(quota, mmap_size) < 0) {
-		bloom->table = NULL;
+	bloom->table = bloom_table_alloc(mmap_size, quota);
+	if (bloom->table == NULL)
 		return -1;
-	}
-	bloom->table = (struct bloom_block *)
-		mmap(NULL, mmap_size, PROT_READ | PROT_WRITE,
-		     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-	if (bloom->table == MAP_FAILED) {
-		bloom->table = NULL;
-		quota_release(quota, mmap_size);
-		return -1;
-	}
 	memcpy(bloom->table, table, mmap_size);
 	return 0;
 }
@@ -97,6 +97,21 @@ int
 bloom_create(struct bloom *bloom, uint32_t number_of_values,
 	     double false_positive_rate, struct quota *quota);
 
+/**
+ * Same as bloom_create(), but the table is rounded up to
+ * a cache line rather than to a memory page, so it suits
+ * many filters built for small sets of values.
+ *
+ * @param bloom - structure to initialize
+ * @param number_of_values - estimated number of values to be added
+ * @param false_positive_rate - desired false positive rate
+ * @param quota - quota for memory allocation
+ * @return 0 - OK, -1 - memory error
+ */
+int
+bloom_create_compact(struct bloom *bloom, uint32_t number_of_values,
+		     double false_positive_rate, struct quota *quota);
+
 /**
  * Free resources of the bloom filter
  *
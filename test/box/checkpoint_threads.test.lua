@@ -0,0 +1,59 @@
+env = require('test_run')
+test_run = env.new()
+
+box.cfg.memtx_checkpoint_threads
+box.cfg{memtx_checkpoint_threads = 0}
+box.cfg.memtx_checkpoint_threads
+
+--
+-- Check that a snapshot written by several threads
+-- is recovered correctly.
+--
+box.cfg{memtx_checkpoint_threads = 4}
+s1 = box.schema.space.create('test1')
+_ = s1:create_index('pk')
+_ = s1:create_index('sk', {parts = {2, 'unsigned'}})
+s2 = box.schema.space.create('test2')
+_ = s2:create_index('pk', {type = 'hash'})
+s3 = box.schema.space.create('test3')
+_ = s3:create_index('pk', {parts = {1, 'string'}})
+for i = 1, 20000 do s1:insert{i, 20000 - i, string.rep('x', i % 100)} end
+for i = 1, 1000 do s2:insert{i} end
+for i = 1, 1000 do s3:insert{tostring(i)} end
+box.snapshot()
+
+test_run:cmd("restart server default")
+
+s1 = box.space.test1
+s2 = box.space.test2
+s3 = box.space.test3
+s1:count()
+s1.index.pk:min()
+s1.index.pk:max()
+s1.index.sk:min()
+s1.index.sk:max()
+s2:count()
+s3:count()
+s3:get('500')
+-- row LSNs grow by one through the snapshot file
+fio = require('fio')
+xlog = require('xlog')
+snaps = fio.glob(fio.pathjoin(box.cfg.memtx_dir, '*.snap'))
+table.sort(snaps)
+test_run:cmd("setopt delimiter ';'")
+function check_lsns(path)
+    local prev = nil
+    for lsn, _ in xlog.pairs(path) do
+        if prev ~= nil and lsn ~= prev + 1 then
+            return {prev, lsn}
+        end
+        prev = lsn
+    end
+    return true
+end;
+test_run:cmd("setopt delimiter ''");
+check_lsns(snaps[#snaps])
+
+s1:drop()
+s2:drop()
+s3:drop()
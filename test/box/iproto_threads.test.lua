@@ -0,0 +1,33 @@
+env = require('test_run')
+test_run = env.new()
+
+box.cfg.iproto_threads
+box.cfg{iproto_threads = 2}
+
+--
+-- Check that connections served by different network
+-- threads work.
+--
+test_run:cmd('create server iproto_threads with script = "box/lua/iproto_threads.lua"')
+test_run:cmd("start server iproto_threads")
+test_run:cmd('switch iproto_threads')
+box.cfg.iproto_threads
+net_box = require('net.box')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+conns = {}
+for i = 1, 8 do conns[i] = net_box.connect(box.cfg.listen) end
+ok = true
+for i = 1, 8 do ok = ok and conns[i]:ping() end
+ok
+for i = 1, 8 do conns[i].space.test:insert{i, i * 10} end
+for i = 1, 8 do ok = ok and conns[i].space.test:get(i)[2] == i * 10 end
+ok
+s:count()
+for i = 1, 8 do conns[i]:close() end
+box.stat.net().SENT.total > 0
+box.stat.net().RECEIVED.total > 0
+s:drop()
+test_run:cmd("switch default")
+test_run:cmd("stop server iproto_threads")
+test_run:cmd("cleanup server iproto_threads")
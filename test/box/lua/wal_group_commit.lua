@@ -0,0 +1,11 @@
+#!/usr/bin/env tarantool
+os = require('os')
+
+box.cfg{
+    listen              = os.getenv("LISTEN"),
+    wal_mode            = 'fsync',
+    wal_commit_delay    = 0.01,
+    wal_commit_max_txns = 100,
+}
+
+require('console').listen(os.getenv('ADMIN'))
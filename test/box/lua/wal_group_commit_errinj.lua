@@ -0,0 +1,10 @@
+#!/usr/bin/env tarantool
+os = require('os')
+
+box.cfg{
+    listen              = os.getenv("LISTEN"),
+    wal_commit_delay    = 0.5,
+    wal_commit_max_txns = 1000,
+}
+
+require('console').listen(os.getenv('ADMIN'))
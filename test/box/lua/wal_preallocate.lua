@@ -0,0 +1,10 @@
+#!/usr/bin/env tarantool
+os = require('os')
+
+box.cfg{
+    listen              = os.getenv("LISTEN"),
+    wal_preallocate     = true,
+    rows_per_wal        = 100,
+}
+
+require('console').listen(os.getenv('ADMIN'))
@@ -0,0 +1,10 @@
+#!/usr/bin/env tarantool
+os = require('os')
+
+box.cfg{
+    listen              = os.getenv("LISTEN"),
+    wal_recovery_threads = 3,
+    rows_per_wal        = 1000,
+}
+
+require('console').listen(os.getenv('ADMIN'))
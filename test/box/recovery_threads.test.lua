@@ -0,0 +1,38 @@
+env = require('test_run')
+test_run = env.new()
+
+box.cfg.memtx_recovery_threads
+box.cfg{memtx_recovery_threads = 2}
+
+--
+-- Check that a snapshot read by several threads
+-- is recovered correctly.
+--
+test_run:cmd('create server recovery_threads with script = "box/lua/recovery_threads.lua"')
+test_run:cmd("start server recovery_threads")
+test_run:cmd('switch recovery_threads')
+box.cfg.memtx_recovery_threads
+s1 = box.schema.space.create('test1')
+_ = s1:create_index('pk')
+_ = s1:create_index('sk', {parts = {2, 'unsigned'}})
+s2 = box.schema.space.create('test2')
+_ = s2:create_index('pk', {type = 'hash'})
+for i = 1, 20000 do s1:insert{i, 20000 - i, string.rep('x', i % 100)} end
+for i = 1, 1000 do s2:insert{i} end
+box.snapshot()
+test_run:cmd("switch default")
+test_run:cmd("stop server recovery_threads")
+test_run:cmd("start server recovery_threads")
+test_run:cmd('switch recovery_threads')
+s1 = box.space.test1
+s2 = box.space.test2
+s1:count()
+s1.index.pk:min()
+s1.index.pk:max()
+s1.index.sk:min()
+s1.index.sk:max()
+s2:count()
+s2:get(500)
+test_run:cmd("switch default")
+test_run:cmd("stop server recovery_threads")
+test_run:cmd("cleanup server recovery_threads")
@@ -0,0 +1,26 @@
+env = require('test_run')
+test_run = env.new()
+
+box.schema.user.grant('guest','read,write,execute','universe')
+remote = require('net.box')
+cn = remote.connect(box.cfg.listen)
+cn:ping()
+
+stat = box.stat.cbus()
+net_stat = stat['iproto->tx']
+net_stat.messages > 0
+net_stat.batches > 0
+net_stat.batches <= net_stat.messages
+net_stat.wakeups <= net_stat.batches
+net_stat.avg_batch >= 1
+tx_stat = stat['main->net']
+tx_stat.messages > 0
+tx_stat.batches > 0
+
+-- counters only grow
+messages = net_stat.messages
+cn:ping()
+box.stat.cbus()['iproto->tx'].messages > messages
+
+cn:close()
+box.schema.user.revoke('guest','read,write,execute','universe')
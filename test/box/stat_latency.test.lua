@@ -0,0 +1,42 @@
+-- latency statistics is off by default
+box.cfg.latency_stat
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+_ = s:create_index('sk', {parts = {2, 'unsigned'}})
+s:insert{1, 1}
+s:stat()
+box.stat.latency().test
+--
+-- Check that requests are accounted per space and per
+-- index once statistics is enabled.
+--
+box.cfg{latency_stat = true}
+function summary(stat) local r = {} for op, v in pairs(stat) do if op ~= 'index' then assert(v.p50 <= v.p90 and v.p90 <= v.p99 and v.p99 <= v.p999) table.insert(r, op .. ' ' .. v.count) end end table.sort(r) return r end
+s:insert{2, 2}
+s:replace{3, 3}
+s:upsert({4, 4}, {{'=', 2, 4}})
+s:get{1}
+s:select{}
+s.index.sk:select{2}
+s:update({1}, {{'=', 3, 'x'}})
+s.index.sk:update({2}, {{'=', 3, 'y'}})
+s.index.sk:delete{3}
+summary(s:stat())
+summary(s:stat().index.pk)
+summary(s:stat().index.sk)
+summary(box.stat.latency().test)
+s:stat().select.p999 < 1
+-- statistics survives alter
+_ = s:create_index('tk', {parts = {1, 'unsigned'}})
+s:rename('test2')
+summary(s:stat())
+summary(s:stat().index.sk)
+s:rename('test')
+-- and isn't collected when turned off
+box.cfg{latency_stat = false}
+s:insert{5, 5}
+s:select{}
+summary(s:stat())
+s:drop()
+s:stat()
+box.stat.latency().test
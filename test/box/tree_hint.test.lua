@@ -0,0 +1,65 @@
+--
+-- TREE index with hints must give the same results as
+-- a plain one.
+--
+s1 = box.schema.space.create('test1')
+s2 = box.schema.space.create('test2')
+_ = s1:create_index('pk', {hint = true})
+_ = s2:create_index('pk')
+s1.index.pk.hint
+s2.index.pk.hint
+_ = s1:create_index('int', {parts = {2, 'integer'}, unique = false, hint = true})
+_ = s2:create_index('int', {parts = {2, 'integer'}, unique = false})
+_ = s1:create_index('str', {parts = {3, 'string'}, unique = false, hint = true})
+_ = s2:create_index('str', {parts = {3, 'string'}, unique = false})
+_ = s1:create_index('multi', {parts = {4, 'unsigned', 3, 'string'}, unique = false, hint = true})
+_ = s2:create_index('multi', {parts = {4, 'unsigned', 3, 'string'}, unique = false})
+ints = {-9223372036854775808LL, -100, -1, 0, 1, 100, 9223372036854775806LL, 9223372036854775807LL, 18446744073709551615ULL}
+strs = {'', 'a', 'ab', 'abcdefg', 'abcdefgh', 'abcdefgi', 'abcdefg\0', '\255\255\255\255\255\255\255\255', '\255\255\255\255\255\255\255'}
+uints = {0, 1, 18446744073709551614ULL, 18446744073709551615ULL}
+n = 0
+for _, i in ipairs(ints) do for _, str in ipairs(strs) do for _, u in ipairs(uints) do n = n + 1 s1:insert{n, i, str, u} s2:insert{n, i, str, u} end end end
+s1:count() == s2:count()
+-- compare key parts of the selected tuples, since tuples with equal keys are ordered by address in a non-unique index
+function project(index, tuples) local r = {} for _, t in ipairs(tuples) do for _, part in ipairs(index.parts) do table.insert(r, t[part.fieldno]) end end return r end
+function same(a, b) if #a ~= #b then return false end for i = 1, #a do if a[i] ~= b[i] then return false end end return true end
+iterators = {'EQ', 'REQ', 'GT', 'GE', 'LT', 'LE', 'ALL'}
+function check(name, keys) for _, it in ipairs(iterators) do for _, key in ipairs(keys) do local i1, i2 = s1.index[name], s2.index[name] local r1 = project(i1, i1:select(key, {iterator = it})) local r2 = project(i2, i2:select(key, {iterator = it})) if not same(r1, r2) then return {name, it, key} end end end return true end
+keys = {{}}
+for i = 0, n + 1, 7 do table.insert(keys, {i}) end
+check('pk', keys)
+keys = {{}}
+for _, i in ipairs(ints) do table.insert(keys, {i}) end
+check('int', keys)
+keys = {{}}
+for _, str in ipairs(strs) do table.insert(keys, {str}) end
+check('str', keys)
+keys = {{}}
+for _, u in ipairs(uints) do table.insert(keys, {u}) for _, str in ipairs(strs) do table.insert(keys, {u, str}) end end
+check('multi', keys)
+s1:get{10}
+s1:delete{10}
+s1:get{10}
+s1.index.str:count{'abcdefg'}
+s1.index.int:count{-1}
+-- rebuild with and without hints
+s1.index.str:alter{hint = false}
+s1.index.str.hint
+s2.index.str:alter{hint = true}
+s2.index.str.hint
+s2:delete{10}
+keys = {{}}
+for _, str in ipairs(strs) do table.insert(keys, {str}) end
+check('str', keys)
+-- hints are ignored for unsupported types
+_ = s1:create_index('scalar', {parts = {3, 'scalar'}, unique = false, hint = true})
+#s1.index.scalar:select{'abcdefgh'} == #s1.index.str:select{'abcdefgh'}
+-- only a hinted index stores a hint next to each tuple pointer
+s3 = box.schema.space.create('test3')
+_ = s3:create_index('plain')
+_ = s3:create_index('hinted', {parts = {1, 'unsigned'}, hint = true})
+for i = 1, 10000 do s3:insert{i} end
+s3.index.hinted:bsize() > s3.index.plain:bsize() * 1.5
+s3:drop()
+s1:drop()
+s2:drop()
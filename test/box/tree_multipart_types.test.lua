@@ -0,0 +1,24 @@
+--
+-- Multipart keys of any types use comparators specialized
+-- by the type signature. Check ordering for 3- and 4-part
+-- keys with gaps between fields.
+--
+s = box.schema.space.create('test')
+_ = s:create_index('pk', {parts = {1, 'integer', 3, 'number', 5, 'scalar'}})
+_ = s:create_index('sk', {parts = {6, 'string', 4, 'unsigned', 2, 'integer', 1, 'integer'}})
+_ = s:insert{-1, 1, 0, 0, 'a', 'x'}
+_ = s:insert{-1, 2, 0.5, 1, 'a', 'x'}
+_ = s:insert{-1, 3, 0.5, 1, 1, 'y'}
+_ = s:insert{-1, 4, 0.5, 1, true, 'y'}
+_ = s:insert{0, 5, -2, 1, 'b', 'x'}
+_ = s:insert{1, 6, 1.5, 0, 2.5, 'w'}
+_ = s:insert{1, 7, 1.5, 0, 'c', 'w'}
+s.index.pk:select({}, {iterator = 'ALL'})
+s.index.pk:select({-1, 0.5}, {iterator = 'GE'})
+s.index.pk:select({-1, 0.5, 'a'}, {iterator = 'LT'})
+s.index.pk:select({1, 1.5}, {iterator = 'REQ'})
+s.index.sk:select({}, {iterator = 'ALL'})
+s.index.sk:select({'x', 1}, {iterator = 'EQ'})
+s.index.sk:select({'y', 1, 3}, {iterator = 'GT'})
+s.index.sk:get{'w', 0, 7, 1}
+s:drop()
@@ -0,0 +1,42 @@
+env = require('test_run')
+test_run = env.new()
+
+box.cfg.wal_commit_delay
+box.cfg{wal_commit_delay = 0.01}
+-- without group commit every batch is a group
+s = box.schema.space.create('test')
+s:drop()
+stat = box.stat.wal()
+stat.groups > 0
+stat.avg_txns >= 1
+
+--
+-- Check that concurrent transactions are committed in
+-- groups and survive restart.
+--
+test_run:cmd('create server wal_group_commit with script = "box/lua/wal_group_commit.lua"')
+test_run:cmd("start server wal_group_commit")
+test_run:cmd('switch wal_group_commit')
+fiber = require('fiber')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+groups = box.stat.wal().groups
+txns = box.stat.wal().txns
+ch = fiber.channel(1000)
+for i = 1, 1000 do fiber.create(function() s:insert{i} ch:put(true) end) end
+for i = 1, 1000 do ch:get() end
+s:count()
+stat = box.stat.wal()
+stat.txns - txns >= 1000
+stat.groups - groups > 0
+stat.groups - groups < 1000
+stat.avg_bytes > 0
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_group_commit")
+test_run:cmd("start server wal_group_commit")
+test_run:cmd('switch wal_group_commit')
+box.space.test:count()
+box.space.test:get(1000)
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_group_commit")
+test_run:cmd("cleanup server wal_group_commit")
@@ -0,0 +1,45 @@
+env = require('test_run')
+test_run = env.new()
+
+--
+-- Check that a failed group is rolled back as a whole and
+-- none of it reaches the WAL file, even if the group is
+-- bigger than the xlog write buffer.
+--
+test_run:cmd('create server wal_group_commit_errinj with script = "box/lua/wal_group_commit_errinj.lua"')
+test_run:cmd("start server wal_group_commit_errinj")
+test_run:cmd('switch wal_group_commit_errinj')
+fio = require('fio')
+fiber = require('fiber')
+errinj = box.error.injection
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+test_run:cmd("setopt delimiter ';'")
+function wal_size()
+    local xlogs = fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog'))
+    table.sort(xlogs)
+    return fio.stat(xlogs[#xlogs]).size
+end;
+test_run:cmd("setopt delimiter ''");
+size = wal_size()
+ch = fiber.channel(20)
+for i = 1, 20 do fiber.create(function() ch:put((pcall(s.insert, s, {i, string.rep('x', 10000)}))) end) end
+fiber.sleep(0.1)
+-- the group is open and holds 200KB, none of it is written
+wal_size() == size
+errinj.set("ERRINJ_WAL_WRITE", true)
+failed = 0
+for i = 1, 20 do if not ch:get() then failed = failed + 1 end end
+failed
+errinj.set("ERRINJ_WAL_WRITE", false)
+s:count()
+wal_size() == size
+_ = s:insert{21}
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_group_commit_errinj")
+test_run:cmd("start server wal_group_commit_errinj")
+test_run:cmd('switch wal_group_commit_errinj')
+box.space.test:select()
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_group_commit_errinj")
+test_run:cmd("cleanup server wal_group_commit_errinj")
@@ -0,0 +1,47 @@
+env = require('test_run')
+test_run = env.new()
+
+box.cfg.wal_preallocate
+box.cfg{wal_preallocate = true}
+
+--
+-- Check that preallocated WAL files are recovered correctly
+-- and truncated on rotation.
+--
+test_run:cmd('create server wal_preallocate with script = "box/lua/wal_preallocate.lua"')
+test_run:cmd("start server wal_preallocate")
+test_run:cmd('switch wal_preallocate')
+fio = require('fio')
+fiber = require('fiber')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+for i = 1, 250 do s:insert{i, string.rep('x', 100)} end
+-- the spare is created in background
+while #fio.glob(fio.pathjoin(box.cfg.wal_dir, 'spare.xlog.inprogress')) == 0 do fiber.sleep(0.01) end
+files = fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog'))
+table.sort(files)
+#files >= 3
+-- closed files are cut to the data size
+fio.stat(files[1]).size < 1024 * 1024
+-- the current file is preallocated
+fio.stat(files[#files]).size >= 1024 * 1024
+-- and marked so in its header
+f = fio.open(files[#files])
+f:read(512):find('\nPreallocated: true\n') ~= nil
+f:close()
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_preallocate")
+test_run:cmd("start server wal_preallocate")
+test_run:cmd('switch wal_preallocate')
+box.space.test:count()
+box.space.test:get(250)[1]
+box.space.test:insert{251}
+box.space.test:count()
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_preallocate")
+test_run:cmd("start server wal_preallocate")
+test_run:cmd('switch wal_preallocate')
+box.space.test:count()
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_preallocate")
+test_run:cmd("cleanup server wal_preallocate")
@@ -0,0 +1,35 @@
+env = require('test_run')
+test_run = env.new()
+
+box.cfg.wal_recovery_threads
+box.cfg{wal_recovery_threads = 2}
+
+--
+-- Check that WALs read by several threads are replayed
+-- correctly and in order.
+--
+test_run:cmd('create server wal_recovery_threads with script = "box/lua/wal_recovery_threads.lua"')
+test_run:cmd("start server wal_recovery_threads")
+test_run:cmd('switch wal_recovery_threads')
+s = box.schema.space.create('test')
+_ = s:create_index('pk')
+_ = s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+for i = 1, 3000 do s:insert{i, i % 10} end
+box.begin() for i = 1, 100 do s:replace{i, 100} end box.commit()
+for i = 1, 3000, 2 do s:delete{i} end
+for i = 2, 3000, 2 do s:update(i, {{'+', 2, 1}}) end
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_recovery_threads")
+test_run:cmd("start server wal_recovery_threads")
+test_run:cmd('switch wal_recovery_threads')
+s = box.space.test
+s:count()
+s:get(1)
+s:get(2)
+s:get(200)
+s:get(3000)
+s.index.sk:count(101)
+box.info.vclock[1] > 6000
+test_run:cmd("switch default")
+test_run:cmd("stop server wal_recovery_threads")
+test_run:cmd("cleanup server wal_recovery_threads")
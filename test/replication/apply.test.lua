@@ -0,0 +1,43 @@
+env = require('test_run')
+test_run = env.new()
+engine = test_run:get_cfg('engine')
+
+--
+-- Rows received from the master are applied by several
+-- fibers (box.cfg.replication_apply_fibers).
+--
+box.schema.user.grant('guest', 'replication')
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica_apply.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+box.cfg.replication_apply_fibers
+test_run:cmd("switch default")
+
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+
+-- Rows modifying the same key must be applied in order.
+for i = 1, 1000 do s:replace{i % 10, i} end
+for i = 1, 100 do s:upsert({i, 0}, {{'+', 2, 1}}) end
+for i = 1, 100 do s:update(i % 10, {{'+', 2, 1}}) end
+_ = s:replace{1000000, 0}
+
+function checksum() local sum = 0 for _, t in box.space.test:pairs() do sum = sum + t[2] end return box.space.test:count(), sum end
+checksum()
+
+test_run:cmd("switch replica")
+fiber = require('fiber')
+master_id = test_run:get_server_id('default')
+function queue() return box.info.replication[master_id].upstream.queue end
+while box.space.test == nil or box.space.test:get(1000000) == nil or queue() > 0 do fiber.sleep(0.01) end
+queue()
+function checksum() local sum = 0 for _, t in box.space.test:pairs() do sum = sum + t[2] end return box.space.test:count(), sum end
+checksum()
+box.info.replication[master_id].upstream.status
+
+-- cleanup
+test_run:cmd("switch default")
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+s:drop()
+box.schema.user.revoke('guest', 'replication')
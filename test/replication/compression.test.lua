@@ -0,0 +1,63 @@
+env = require('test_run')
+test_run = env.new()
+engine = test_run:get_cfg('engine')
+fiber = require('fiber')
+
+--
+-- A replica may ask the master to compress the replication
+-- stream (box.cfg.replication_compression).
+--
+box.schema.user.grant('guest', 'replication')
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+pad = string.rep('x', 100)
+for i = 1, 1000 do s:replace{i, pad} end
+box.snapshot()
+for i = 1001, 2000 do s:replace{i, pad} end
+
+-- Initial and final join are compressed.
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica_compression.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+box.space.test:count()
+box.space.test:get(2000)[2] == string.rep('x', 100)
+test_run:cmd("switch default")
+
+-- Subscribe is compressed.
+replica_id = test_run:get_server_id('replica')
+function downstream() return box.info.replication[replica_id].downstream end
+-- Commit the rows at once so that they are sent in one batch.
+box.begin() for i = 2001, 3000 do s:replace{i, pad} end box.commit()
+while downstream() == nil or downstream().rows < 1000 do fiber.sleep(0.01) end
+c = downstream().compression
+c.ratio > 2
+c.time >= 0
+
+test_run:cmd("switch replica")
+fiber = require('fiber')
+while box.space.test:count() < 3000 do fiber.sleep(0.01) end
+box.space.test:count()
+box.space.test:get(3000)[2] == string.rep('x', 100)
+c = box.info.replication[1].upstream.compression
+c.ratio > 2
+c.time >= 0
+test_run:cmd("switch default")
+
+-- Without the option the stream is not compressed.
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+box.space.test:count()
+box.info.replication[1].upstream.compression == nil
+test_run:cmd("switch default")
+replica_id = test_run:get_server_id('replica')
+while downstream() == nil do fiber.sleep(0.01) end
+downstream().compression == nil
+
+-- cleanup
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+s:drop()
+box.schema.user.revoke('guest', 'replication')
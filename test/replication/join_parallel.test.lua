@@ -0,0 +1,104 @@
+env = require('test_run')
+test_run = env.new()
+engine = test_run:get_cfg('engine')
+
+--
+-- Initial data may be received over several connections
+-- (box.cfg.replication_join_connections), spaces are divided
+-- between them.
+--
+box.schema.user.grant('guest', 'replication')
+test_run:cmd("setopt delimiter ';'")
+for i = 1, 8 do
+    local s = box.schema.space.create('test' .. i, {engine = engine})
+    s:create_index('pk')
+    s:create_index('sk', {parts = {2, 'unsigned'}})
+    for j = 1, 100 * i do s:replace{j, j * 10} end
+end;
+test_run:cmd("setopt delimiter ''");
+box.snapshot()
+for i = 1, 8 do box.space['test' .. i]:replace{1000, 1} end
+
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica_join_parallel.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+box.cfg.replication_join_connections
+counts = {}
+for i = 1, 8 do counts[i] = box.space['test' .. i]:count() end
+counts
+box.space.test8.index.sk:get(8000)
+box.space.test8:get(1000)
+box.info.status
+test_run:cmd("switch default")
+
+-- The replica follows the master after bootstrap.
+for i = 1, 8 do box.space['test' .. i]:replace{2000, 2} end
+test_run:cmd("switch replica")
+fiber = require('fiber')
+while box.space.test8:get(2000) == nil do fiber.sleep(0.01) end
+box.space.test1:count()
+test_run:cmd("switch default")
+
+test_run:grep_log('replica', 'receiving initial data over 4 connections') ~= nil
+
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+
+--
+-- A broken connection is resumed from the row it stopped at,
+-- both for the main applier and for helpers. The injection
+-- makes the master break every connection once, after it has
+-- sent 300 rows of the initial data.
+--
+errinj = box.error.injection
+errinj.set('ERRINJ_RELAY_BREAK_JOIN', 300)
+test_run:cmd("start server replica")
+test_run:cmd("switch replica")
+counts = {}
+for i = 1, 8 do counts[i] = box.space['test' .. i]:count() end
+counts
+sk_counts = {}
+for i = 1, 8 do sk_counts[i] = box.space['test' .. i].index.sk:count() end
+sk_counts
+box.space.test8:get(2000)
+box.info.status
+test_run:cmd("switch default")
+errinj.set('ERRINJ_RELAY_BREAK_JOIN', -1)
+test_run:grep_log('replica', 'Duplicate key') == nil
+test_run:grep_log('default', 'resuming initial join part 0 of 4') ~= nil
+test_run:grep_log('default', 'resuming initial join part 3 of 4') ~= nil
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+
+--
+-- If the checkpoint the initial data is sent from has been
+-- collected by the time the replica reconnects, the master
+-- replies ER_MISSING_SNAPSHOT and bootstrap fails.
+--
+test_run:cleanup_cluster()
+default_checkpoint_count = box.cfg.checkpoint_count
+box.cfg{checkpoint_count = 1}
+fiber = require('fiber')
+consumers = #box.internal.gc.info().consumers
+errinj.set('ERRINJ_RELAY_TIMEOUT', 0.001)
+errinj.set('ERRINJ_RELAY_BREAK_JOIN', 300)
+-- make a new checkpoint while the JOIN is in progress
+test_run:cmd("setopt delimiter ';'")
+_ = fiber.create(function()
+    while #box.internal.gc.info().consumers == consumers do
+        fiber.sleep(0.001)
+    end
+    box.snapshot()
+end);
+test_run:cmd("setopt delimiter ''");
+test_run:cmd("start server replica with crash_expected=True")
+errinj.set('ERRINJ_RELAY_BREAK_JOIN', -1)
+errinj.set('ERRINJ_RELAY_TIMEOUT', 0)
+test_run:grep_log('default', "can't resume initial join part 0") ~= nil
+#box.internal.gc.info().checkpoints == 1 or box.internal.gc.info()
+test_run:cmd("cleanup server replica")
+box.cfg{checkpoint_count = default_checkpoint_count}
+
+-- cleanup
+for i = 1, 8 do box.space['test' .. i]:drop() end
+box.schema.user.revoke('guest', 'replication')
@@ -0,0 +1,38 @@
+env = require('test_run')
+test_run = env.new()
+engine = test_run:get_cfg('engine')
+fiber = require('fiber')
+
+--
+-- Relay sends WAL rows to the replica in batches.
+--
+box.schema.user.grant('guest', 'replication')
+test_run:cmd("create server replica with rpl_master=default, script='replication/replica.lua'")
+test_run:cmd("start server replica")
+test_run:cmd("stop server replica")
+
+s = box.schema.space.create('test', {engine = engine})
+_ = s:create_index('pk')
+for i = 1, 1000 do s:replace{i} end
+
+-- The backlog is sent in a few socket writes.
+test_run:cmd("start server replica")
+replica_id = test_run:get_server_id('replica')
+function downstream() return box.info.replication[replica_id].downstream end
+while downstream() == nil or downstream().rows < 1000 do fiber.sleep(0.01) end
+d = downstream()
+d.rows >= 1000
+d.writes < d.rows / 10
+d.bytes > 0
+
+test_run:cmd("switch replica")
+fiber = require('fiber')
+while box.space.test == nil or box.space.test:count() < 1000 do fiber.sleep(0.01) end
+box.space.test:count()
+test_run:cmd("switch default")
+
+-- cleanup
+test_run:cmd("stop server replica")
+test_run:cmd("cleanup server replica")
+s:drop()
+box.schema.user.revoke('guest', 'replication')
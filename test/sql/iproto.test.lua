@@ -191,6 +191,24 @@ while f1:status() ~= 'dead' do fiber.sleep(0) end
 insert_res
 select_res
 
+-- Prepared statements.
+id = cn:prepare('select * from test where id = ?')
+type(id)
+cn:prepare('select * from test where id = ?') == id
+cn:execute(id, {1})
+-- Bindings are not kept between executions.
+cn:execute(id)
+-- The statement is re-prepared after a schema change.
+box.sql.execute('create index test_a on test(a)')
+cn:execute(id, {1})
+box.sql.execute('drop index test_a')
+cn:prepare('select * from not_existing_table')
+-- Statements are evicted when the cache shrinks.
+box.cfg{sql_stmt_cache_size = 0}
+cn:execute(id, {1})
+cn:prepare('select 1')
+box.cfg{sql_stmt_cache_size = 100}
+
 -- gh-2602 obuf_alloc breaks the tuple in different slabs
 _ = space:replace{1, 1, string.rep('a', 4 * 1024 * 1024)}
 res = cn:execute('select * from test')
@@ -165,10 +165,41 @@ spectrum_test()
 	cout << "memory after destruction = " << quota_used(&q) << endl << endl;
 }
 
+void
+compact_test()
+{
+	cout << "*** " << __func__ << " ***" << endl;
+	struct quota q;
+	quota_init(&q, 100500);
+	uint32_t count = 100;
+	struct bloom bloom;
+	bloom_create_compact(&bloom, count, 0.05, &q);
+	for (uint32_t i = 0; i < count; i++)
+		bloom_add(&bloom, h(i * 3));
+
+	struct bloom test = bloom;
+	char *buf = (char *)malloc(bloom_store_size(&bloom));
+	bloom_store(&bloom, buf);
+	bloom_destroy(&bloom, &q);
+	bloom_load_table(&test, buf, &q);
+	free(buf);
+
+	uint64_t error_count = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (!bloom_possible_has(&test, h(i * 3)))
+			error_count++;
+	}
+	cout << "bloom table size = " << test.table_size << endl;
+	cout << "error_count = " << error_count << endl;
+	bloom_destroy(&test, &q);
+	cout << "memory after destruction = " << quota_used(&q) << endl << endl;
+}
+
 int
 main(void)
 {
 	simple_test();
 	store_load_test();
 	spectrum_test();
+	compact_test();
 }
@@ -0,0 +1,9 @@
+#!/usr/bin/env tarantool
+
+box.cfg{
+    listen = os.getenv("LISTEN"),
+    vinyl_cache = 0,
+    vinyl_aio_queue_depth = 4,
+}
+
+require('console').listen(os.getenv('ADMIN'))
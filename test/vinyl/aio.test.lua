@@ -0,0 +1,47 @@
+test_run = require('test_run').new()
+
+--
+-- Run pages are read with asynchronous I/O if available.
+--
+test_run:cmd("create server test with script='vinyl/aio.lua'")
+test_run:cmd("start server test")
+test_run:cmd('switch test')
+
+box.cfg.vinyl_aio_queue_depth
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_size = 1024})
+
+pad = string.rep('x', 64)
+for k = 1, 100 do s:replace{k, pad} end
+box.snapshot()
+
+function aio() return box.info.vinyl().performance.aio end
+function pages_read() return s.index.pk:info().disk.iterator.read.pages end
+-- Without kernel support vinyl falls back on reader threads.
+function aio_reads() return aio().backend ~= 'none' and aio().reads or pages_read() end
+
+#s:select()
+s:get(50)[1]
+#s:select({90}, {iterator = 'ge'})
+#s:select({10}, {iterator = 'le'})
+pages_read() > 1
+aio_reads() == pages_read()
+aio().inflight
+
+-- More fibers than the queue depth.
+ch = require('fiber').channel(10)
+for i = 1, 10 do require('fiber').create(function() ch:put(#s:select()) end) end
+n = 0
+for i = 1, 10 do n = n + ch:get() end
+n
+aio_reads() == pages_read()
+aio().inflight
+
+s:drop()
+
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("cleanup server test")
+
+box.cfg{vinyl_aio_queue_depth = 1}
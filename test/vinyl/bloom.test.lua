@@ -48,3 +48,52 @@ new_reflects() > 980
 new_seeks() < 20
 
 s:drop()
+
+--
+-- Page bloom filters.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_bloom = true})
+s.index.pk.options.page_bloom
+
+for i = 1,1000 do s:replace{i * 2} end
+box.snapshot()
+_ = new_reflects()
+_ = new_seeks()
+
+found = 0
+for i = 1,1000 do found = found + #s:select{i * 2} end
+found
+new_reflects() == 0
+new_seeks() == 1000
+
+for i = 1,1000 do s:select{i * 2 - 1} end
+new_reflects() > 990
+new_seeks() < 10
+
+test_run:cmd('restart server default')
+
+s = box.space.test
+s.index.pk.options.page_bloom
+
+reflects = 0
+function cur_reflects() return box.space.test.index.pk:info().disk.iterator.bloom.hit end
+function new_reflects() local o = reflects reflects = cur_reflects() return reflects - o end
+seeks = 0
+function cur_seeks() return box.space.test.index.pk:info().disk.iterator.lookup end
+function new_seeks() local o = seeks seeks = cur_seeks() return seeks - o end
+
+_ = new_reflects()
+_ = new_seeks()
+
+found = 0
+for i = 1,1000 do found = found + #s:select{i * 2} end
+found
+new_reflects() == 0
+new_seeks() == 1000
+
+for i = 1,1000 do s:select{i * 2 - 1} end
+new_reflects() > 990
+new_seeks() < 10
+
+s:drop()
@@ -0,0 +1,9 @@
+#!/usr/bin/env tarantool
+
+box.cfg{
+    listen = os.getenv("LISTEN"),
+    vinyl_write_threads = 4,
+    vinyl_compaction_threads = 3,
+}
+
+require('console').listen(os.getenv('ADMIN'))
@@ -0,0 +1,40 @@
+test_run = require('test_run').new()
+
+--
+-- Compaction of a big range is split in several parts
+-- executed by different workers concurrently.
+--
+test_run:cmd("create server test with script='vinyl/compact_parallel.lua'")
+test_run:cmd("start server test")
+test_run:cmd('switch test')
+
+fiber = require('fiber')
+box.cfg.vinyl_compaction_threads
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_size = 256, range_size = 2048, run_count_per_level = 1, run_size_ratio = 1000})
+
+function vyinfo() return s.index.pk:info() end
+
+pad = string.rep('x', 64)
+for k = 1, 200 do s:replace{k, 1, pad} end
+box.snapshot()
+for k = 1, 200 do s:replace{k, 2, pad} end
+box.snapshot()
+
+-- Wait for compaction to complete.
+while vyinfo().run_count ~= vyinfo().range_count do fiber.sleep(0.01) end
+
+vyinfo().range_count > 1
+test_run:grep_log('test', 'parts') ~= nil
+
+s:count()
+bad = 0
+for k = 1, 200 do if s:get(k)[2] ~= 2 then bad = bad + 1 end end
+bad
+
+s:drop()
+
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("cleanup server test")
@@ -0,0 +1,46 @@
+fiber = require('fiber')
+
+--
+-- Per-index compaction policy.
+--
+box.cfg.vinyl_compaction
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {compaction = 'foo'})
+_ = s:create_index('pk', {compaction = 'leveled', run_count_per_level = 1})
+s.index.pk.options.compaction
+
+function vyinfo() return s.index.pk:info() end
+function pad(c) local t = {c} for i = 1, 100 do t[i + 1] = string.char(math.random(65, 90)) end return table.concat(t) end
+
+vyinfo().compaction
+
+-- The oldest run is big enough, no compaction.
+for k = 1, 100 do s:replace{k, pad('x')} end
+box.snapshot()
+for k = 1, 5 do s:replace{k, pad('y')} end
+box.snapshot()
+vyinfo().run_count
+vyinfo().write_amplification
+vyinfo().read_amplification
+
+-- The second run is too small compared to the newest one,
+-- merge them.
+for k = 6, 10 do s:replace{k, pad('z')} end
+box.snapshot()
+while vyinfo().run_count > 2 do fiber.sleep(0.01) end
+vyinfo().run_count
+vyinfo().write_amplification > 1
+vyinfo().read_amplification
+
+s:get(1)[2]:sub(1, 1)
+s:get(6)[2]:sub(1, 1)
+s:get(11)[2]:sub(1, 1)
+s:count()
+
+-- The policy can be changed on the fly.
+s.index.pk:alter({compaction = 'tiered'})
+s.index.pk.options.compaction
+vyinfo().compaction
+
+s:drop()
@@ -0,0 +1,44 @@
+test_run = require('test_run').new()
+
+--
+-- index:get_many() looks up several keys at once.
+--
+s = box.schema.space.create('test', {engine = 'vinyl'})
+pk = s:create_index('pk')
+sk = s:create_index('sk', {parts = {2, 'unsigned'}})
+
+for i = 1, 100 do s:replace{i, i * 10} end
+box.snapshot()
+for i = 101, 200 do s:replace{i, i * 10} end
+
+res = s:get_many({5, 150, 1000, 1, {200}})
+res[1], res[2], res[3], res[4], res[5]
+
+res = sk:get_many({500, 5, 2000})
+res[1], res[2], res[3]
+
+-- Results follow the order of keys, not the key order.
+keys = {}
+for i = 200, 1, -1 do table.insert(keys, i) end
+res = s:get_many(keys)
+ok = true
+for i, k in ipairs(keys) do if res[i] == nil or res[i][1] ~= k then ok = false end end
+ok
+
+#s:get_many({})
+
+s:get_many({{'abc'}})
+s:get_many(1)
+sk:get_many({{}})
+
+-- Own changes of a transaction are visible.
+box.begin() s:replace{1, 11} res = s:get_many({1, 2}) box.commit()
+res[1], res[2]
+
+-- Batched lookups are accounted in latency statistics.
+box.cfg{latency_stat = true}
+_ = s:get_many({1, 2, 3})
+s:stat().index.pk.select.count
+box.cfg{latency_stat = false}
+
+s:drop()
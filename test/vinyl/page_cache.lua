@@ -0,0 +1,9 @@
+#!/usr/bin/env tarantool
+
+box.cfg{
+    listen = os.getenv("LISTEN"),
+    vinyl_cache = 0,
+    vinyl_page_cache = 1024 * 1024,
+}
+
+require('console').listen(os.getenv('ADMIN'))
@@ -0,0 +1,52 @@
+test_run = require('test_run').new()
+
+--
+-- Decompressed run pages are cached engine-wide.
+--
+test_run:cmd("create server test with script='vinyl/page_cache.lua'")
+test_run:cmd("start server test")
+test_run:cmd('switch test')
+
+box.cfg.vinyl_page_cache
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_size = 1024})
+
+pad = string.rep('x', 64)
+for k = 1, 100 do s:replace{k, pad} end
+box.snapshot()
+
+function pc() return box.info.vinyl().performance.page_cache end
+function pages_read() return s.index.pk:info().disk.iterator.read.pages end
+
+pc().count
+
+-- The first scan reads pages from disk and caches them.
+#s:select()
+pc().count > 1
+pc().count == pages_read()
+pc().used > 0
+
+-- The second scan takes pages from the cache.
+#s:select()
+pc().count == pages_read()
+pc().hit > 0
+
+-- Pages that don't fit in the cache are evicted.
+count = pc().count
+box.cfg{vinyl_page_cache = 1}
+pc().count
+pc().used
+pc().evict == count
+
+-- Zero disables the cache.
+box.cfg{vinyl_page_cache = 0}
+#s:select()
+pc().count
+pc().limit
+
+s:drop()
+
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("cleanup server test")
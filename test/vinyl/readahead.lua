@@ -0,0 +1,10 @@
+#!/usr/bin/env tarantool
+
+box.cfg{
+    listen = os.getenv("LISTEN"),
+    vinyl_cache = 0,
+    vinyl_readahead = 4,
+    vinyl_readahead_memory = 1024 * 1024,
+}
+
+require('console').listen(os.getenv('ADMIN'))
@@ -0,0 +1,60 @@
+test_run = require('test_run').new()
+
+--
+-- Sequential scans read run pages in advance.
+--
+test_run:cmd("create server test with script='vinyl/readahead.lua'")
+test_run:cmd("start server test")
+test_run:cmd('switch test')
+
+box.cfg.vinyl_readahead
+box.cfg.vinyl_readahead_memory
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {page_size = 1024})
+
+pad = string.rep('x', 64)
+for k = 1, 1000 do s:replace{k, pad} end
+box.snapshot()
+
+function ra() return box.info.vinyl().performance.readahead end
+function pages_read() return s.index.pk:info().disk.iterator.read.pages end
+function page_count() return s.index.pk:info().disk.pages end
+page_count() > 10
+
+-- Forward scan.
+#s:select()
+pages_read() == page_count()
+ra().read > 0
+ra().hit == ra().read
+ra().used
+
+-- Reverse scan.
+read = ra().read
+#s:select({}, {iterator = 'le'})
+pages_read() == 2 * page_count()
+ra().read > read
+ra().hit == ra().read
+ra().used
+
+-- Point lookups don't read ahead.
+read = ra().read
+for k = 1, 1000, 100 do s:get(k) end
+ra().read == read
+
+-- The read-ahead window is clamped by the memory budget.
+box.cfg{vinyl_readahead_memory = 0}
+#s:select()
+ra().read == read
+ra().limit
+
+-- Zero disables read-ahead.
+box.cfg{vinyl_readahead_memory = 1024 * 1024, vinyl_readahead = 0}
+#s:select()
+ra().read == read
+
+s:drop()
+
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("cleanup server test")
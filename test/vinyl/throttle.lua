@@ -0,0 +1,8 @@
+#!/usr/bin/env tarantool
+
+box.cfg{
+    vinyl_memory = 64 * 1024 * 1024,
+    vinyl_throttling = true,
+}
+
+require('console').listen(os.getenv('ADMIN'))
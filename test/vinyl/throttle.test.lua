@@ -0,0 +1,59 @@
+test_run = require('test_run').new()
+
+--
+-- Rate-based write throttling.
+--
+box.cfg.vinyl_throttling
+perf = box.info.vinyl().performance
+type(perf.tx_write_rate)
+perf.tx_rate_limit
+
+box.cfg{vinyl_throttling = true}
+box.cfg.vinyl_throttling
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+for i = 1, 100 do s:insert{i, string.rep('x', 100)} end
+s:count()
+
+-- Memory usage is far below the watermark, no throttling.
+box.info.vinyl().performance.tx_rate_limit
+
+s:drop()
+box.cfg{vinyl_throttling = false}
+box.cfg.vinyl_throttling
+
+--
+-- Writers are throttled once memory usage exceeds the watermark.
+--
+test_run:cmd("create server test with script='vinyl/throttle.lua'")
+test_run:cmd("start server test")
+test_run:cmd('switch test')
+
+fiber = require('fiber')
+
+-- Block dumps so that memory isn't freed.
+box.error.injection.set('ERRINJ_VY_RUN_WRITE', true)
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk')
+pad = string.rep('x', 512 * 1024)
+for i = 1, 96 do s:replace{i, pad} end
+
+-- The rate limit is set as soon as the write rate is accounted.
+while box.info.vinyl().performance.tx_rate_limit == 0 do fiber.sleep(0.01) end
+box.info.vinyl().memory.used < box.cfg.vinyl_memory
+
+-- A transaction several times bigger than the budget refilled
+-- per interval exhausts it, so the next one has to wait.
+box.cfg{vinyl_timeout = 0.01}
+box.begin() for i = 1, 4 do s:replace{i, pad} end box.commit()
+s:replace{1}
+#s:get(1)
+
+box.error.injection.set('ERRINJ_VY_RUN_WRITE', false)
+s:drop()
+
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("cleanup server test")
@@ -0,0 +1,13 @@
+#!/usr/bin/env tarantool
+
+local fio = require('fio')
+if not fio.stat('tier1') then
+    fio.mkdir('tier1')
+end
+
+box.cfg{
+    listen = os.getenv("LISTEN"),
+    vinyl_tiers = {'tier1'},
+}
+
+require('console').listen(os.getenv('ADMIN'))
@@ -0,0 +1,46 @@
+test_run = require('test_run').new()
+
+--
+-- Dumps write runs to vinyl_dir, compaction moves them to
+-- the next storage tier listed in vinyl_tiers.
+--
+test_run:cmd("create server test with script='vinyl/tier.lua'")
+test_run:cmd("start server test")
+test_run:cmd('switch test')
+
+fio = require('fio')
+fiber = require('fiber')
+
+box.cfg.vinyl_tiers
+
+s = box.schema.space.create('test', {engine = 'vinyl'})
+_ = s:create_index('pk', {run_count_per_level = 1})
+
+function runs(dir) return #fio.glob(fio.pathjoin(dir, s.id, 0, '*.run')) end
+
+for k = 1, 10 do s:replace{k} end
+box.snapshot()
+runs('.')
+runs('tier1')
+
+for k = 11, 20 do s:replace{k} end
+box.snapshot()
+while s.index.pk:info().run_count > 1 do fiber.sleep(0.01) end
+runs('tier1')
+
+-- Runs are found in their tiers after restart.
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("start server test")
+test_run:cmd('switch test')
+
+s = box.space.test
+s.index.pk:info().run_count
+s:count()
+s:get{15}
+
+s:drop()
+
+test_run:cmd('switch default')
+test_run:cmd("stop server test")
+test_run:cmd("cleanup server test")
@@ -0,0 +1,51 @@
+#!/usr/bin/env tarantool
+
+test_run = require('test_run').new()
+
+--
+-- Compression of run pages with a zstd dictionary
+-- trained on dump.
+--
+s1 = box.schema.space.create('test1', {engine = 'vinyl'})
+_ = s1:create_index('pk', {page_size = 1024, compression_dict_size = 4096})
+s1.index.pk.options.compression_dict_size
+s2 = box.schema.space.create('test2', {engine = 'vinyl'})
+_ = s2:create_index('pk', {page_size = 1024})
+s2.index.pk.options.compression_dict_size
+
+function doc(i) return {i, {name = 'user' .. i, email = 'user' .. i .. '@example.com', active = i % 2 == 0, tags = {'alpha', 'beta', 'gamma'}}} end
+function fill(s, from, to) for i = from, to do s:replace(doc(i)) end end
+function check(s, from, to) for i = from, to do local t = s:get(i) if t == nil or t[2].email ~= doc(i)[2].email then return i end end return true end
+function compressed(s) return s.index.pk:info().disk.bytes_compressed end
+
+-- The first dump trains a dictionary, but doesn't use it.
+fill(s1, 1, 2000)
+fill(s2, 1, 2000)
+box.snapshot()
+s1.index.pk:info().dict_size > 0
+s2.index.pk:info().dict_size
+c1 = compressed(s1)
+c2 = compressed(s2)
+c1 == c2
+
+-- The next dump uses the dictionary.
+fill(s1, 2001, 4000)
+fill(s2, 2001, 4000)
+box.snapshot()
+compressed(s1) - c1 < compressed(s2) - c2
+check(s1, 1, 4000)
+check(s2, 1, 4000)
+
+-- The dictionary is restored from run files on recovery.
+test_run:cmd('restart server default')
+
+s1 = box.space.test1
+s2 = box.space.test2
+function doc(i) return {i, {name = 'user' .. i, email = 'user' .. i .. '@example.com', active = i % 2 == 0, tags = {'alpha', 'beta', 'gamma'}}} end
+function check(s, from, to) for i = from, to do local t = s:get(i) if t == nil or t[2].email ~= doc(i)[2].email then return i end end return true end
+s1.index.pk:info().dict_size > 0
+check(s1, 1, 4000)
+check(s2, 1, 4000)
+
+s1:drop()
+s2:drop()